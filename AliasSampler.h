@@ -0,0 +1,216 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file AliasSampler.h
+ * @brief Contains the AliasSampler class for constant-time sampling from a fixed discrete distribution.
+ *
+ * Uses Vose's alias method: the table is generated in linear time, after which each draw uses a single random number,
+ * one table lookup and one comparison, regardless of the number of outcomes.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_ALIASSAMPLER_H
+#define NECSIM_ALIASSAMPLER_H
+
+#include <vector>
+#include <cmath>
+#include "custom_exceptions.h"
+
+namespace random_numbers
+{
+    /**
+     * @brief Samples indices from a discrete distribution defined by a set of non-negative weights, using an alias
+     * table.
+     *
+     * The table should be regenerated whenever the weights change.
+     */
+    class AliasSampler
+    {
+    protected:
+        // The probability of keeping each index, rather than choosing its alias.
+        std::vector<double> probability;
+        // The alternative index for each index.
+        std::vector<unsigned long> alias;
+
+    public:
+        /**
+         * @brief Generates an alias table from the weights, writing the result to contiguous arrays.
+         *
+         * Indices with a weight of zero are never chosen. If all weights are zero, every index is equally likely.
+         * @param weights pointer to the first weight
+         * @param size the number of weights
+         * @param probability_out pointer to the first of size probabilities to write to
+         * @param alias_out pointer to the first of size aliases to write to
+         * @param small_work working space for the indices with below-average weights
+         * @param large_work working space for the indices with above-average weights
+         */
+        static void generateTable(const double* weights, const unsigned long &size, double* probability_out,
+                                  unsigned long* alias_out, std::vector<unsigned long> &small_work,
+                                  std::vector<unsigned long> &large_work)
+        {
+            double total = 0.0;
+            for(unsigned long i = 0; i < size; i++)
+            {
+                if(weights[i] < 0.0 || std::isnan(weights[i]))
+                {
+                    throw necsim::FatalException("Weights for alias sampling must be non-negative.");
+                }
+                total += weights[i];
+            }
+            if(total == 0.0)
+            {
+                for(unsigned long i = 0; i < size; i++)
+                {
+                    probability_out[i] = 1.0;
+                    alias_out[i] = i;
+                }
+                return;
+            }
+            small_work.clear();
+            large_work.clear();
+            unsigned long fallback = 0;
+            for(unsigned long i = 0; i < size; i++)
+            {
+                // Scale so that the average weight is 1.
+                probability_out[i] = weights[i] * static_cast<double>(size) / total;
+                alias_out[i] = i;
+                if(probability_out[i] < 1.0)
+                {
+                    small_work.push_back(i);
+                }
+                else
+                {
+                    large_work.push_back(i);
+                }
+                if(weights[i] > 0.0)
+                {
+                    fallback = i;
+                }
+            }
+            while(!small_work.empty() && !large_work.empty())
+            {
+                const unsigned long less = small_work.back();
+                small_work.pop_back();
+                const unsigned long more = large_work.back();
+                alias_out[less] = more;
+                probability_out[more] = (probability_out[more] + probability_out[less]) - 1.0;
+                if(probability_out[more] < 1.0)
+                {
+                    large_work.pop_back();
+                    small_work.push_back(more);
+                }
+            }
+            for(const auto &i : large_work)
+            {
+                probability_out[i] = 1.0;
+            }
+            // Anything left over is only due to rounding error, but indices with zero weight must never be kept.
+            for(const auto &i : small_work)
+            {
+                if(weights[i] > 0.0)
+                {
+                    probability_out[i] = 1.0;
+                }
+                else
+                {
+                    probability_out[i] = 0.0;
+                    alias_out[i] = fallback;
+                }
+            }
+        }
+
+        /**
+         * @brief Picks an index from an alias table.
+         * @param probability_in pointer to the first probability in the table
+         * @param alias_in pointer to the first alias in the table
+         * @param size the number of entries in the table
+         * @param random_number a random number between 0 and 1
+         * @return the chosen index
+         */
+        static unsigned long sampleTable(const double* probability_in, const unsigned long* alias_in,
+                                         const unsigned long &size, const double &random_number)
+        {
+            // The integer part chooses the column of the table and the fractional part decides between the column and
+            // its alias.
+            const double scaled = random_number * static_cast<double>(size);
+            auto index = static_cast<unsigned long>(scaled);
+            if(index >= size)
+            {
+                index = size - 1;
+            }
+            if(scaled - static_cast<double>(index) < probability_in[index])
+            {
+                return index;
+            }
+            return alias_in[index];
+        }
+
+        AliasSampler() : probability(), alias()
+        { }
+
+        /**
+         * @brief Generates the alias table for the weights.
+         * @tparam T the type of the weights
+         * @param weights the weight of each index
+         */
+        template<typename T>
+        void setup(const std::vector<T> &weights)
+        {
+            std::vector<double> weights_double(weights.begin(), weights.end());
+            probability.resize(weights_double.size());
+            alias.resize(weights_double.size());
+            std::vector<unsigned long> small_work;
+            std::vector<unsigned long> large_work;
+            small_work.reserve(weights_double.size());
+            large_work.reserve(weights_double.size());
+            generateTable(weights_double.data(), weights_double.size(), probability.data(), alias.data(), small_work,
+                          large_work);
+        }
+
+        /**
+         * @brief Removes the alias table.
+         */
+        void clear()
+        {
+            probability.clear();
+            alias.clear();
+        }
+
+        /**
+         * @brief Checks if the alias table has been generated.
+         * @return true if there are no indices to sample from
+         */
+        bool empty() const
+        {
+            return probability.empty();
+        }
+
+        /**
+         * @brief Gets the number of indices in the alias table.
+         * @return the number of indices
+         */
+        unsigned long size() const
+        {
+            return probability.size();
+        }
+
+        /**
+         * @brief Picks an index using the random number.
+         * @param random_number a random number between 0 and 1
+         * @return the chosen index
+         */
+        unsigned long sample(const double &random_number) const
+        {
+#ifdef DEBUG
+            if(probability.empty())
+            {
+                throw necsim::FatalException("Alias table has not been generated. Please report this bug.");
+            }
+#endif // DEBUG
+            return sampleTable(probability.data(), alias.data(), probability.size(), random_number);
+        }
+    };
+}
+#endif //NECSIM_ALIASSAMPLER_H
@@ -12,13 +12,18 @@
  * Contact: samuel.thompson14@imperial.ac.uk or thompsonsed@gmail.com
  */
 
+#include <algorithm>
+#include <numeric>
 #include "custom_exceptions.h"
 #include "AnalyticalSpeciesAbundancesHandler.h"
 
 
 namespace necsim
 {
-    AnalyticalSpeciesAbundancesHandler::AnalyticalSpeciesAbundancesHandler() : seen_no_individuals(0), ind_to_species()
+    AnalyticalSpeciesAbundancesHandler::AnalyticalSpeciesAbundancesHandler() : seen_no_individuals(0),
+                                                                               cumulative_individuals(),
+                                                                               seen_species_ids(), species_sampler(),
+                                                                               species_sampler_outdated(true)
     {
 
     }
@@ -89,66 +94,49 @@ namespace necsim
             ss << "Local community size: " << local_community_size << std::endl;
             throw FatalException(ss.str());
         }
+        generateSpeciesSampler();
+    }
 
+    void AnalyticalSpeciesAbundancesHandler::generateSpeciesSampler()
+    {
+        vector<unsigned long> abundances(cumulative_individuals.size());
+        std::adjacent_difference(cumulative_individuals.begin(), cumulative_individuals.end(), abundances.begin());
+        species_sampler.setup(abundances);
+        species_sampler_outdated = false;
     }
 
     unsigned long AnalyticalSpeciesAbundancesHandler::getRandomSpeciesID()
     {
-        // Select a random individual from the seen number of individuals
-        auto individual_id = random->i0(seen_no_individuals - 1);
 #ifdef DEBUG
-        if(individual_id > seen_no_individuals)
-        {
-            std::stringstream ss;
-            ss << "Random individual ID (" << individual_id << ") is greater than the number of seen indiviudals (";
-            ss << seen_no_individuals << ")" << std::endl;
-            throw FatalException(ss.str());
-        }
-        if(ind_to_species.empty())
+        if(seen_species_ids.empty())
         {
             throw FatalException(
                     "No individuals have been seen yet, but an individual ID was generated. Please report this bug.");
         }
 #endif // DEBUG
-        return pickPreviousIndividual(individual_id);
+        // Select the species of a random individual from the seen individuals
+        if(species_sampler_outdated)
+        {
+            generateSpeciesSampler();
+        }
+        return seen_species_ids[species_sampler.sample(random->d01())];
     }
 
     unsigned long AnalyticalSpeciesAbundancesHandler::pickPreviousIndividual(const unsigned long &individual_id)
     {
-        return ind_to_species.upper_bound(individual_id)->second;
+        const auto index = std::upper_bound(cumulative_individuals.begin(), cumulative_individuals.end(),
+                                            individual_id) - cumulative_individuals.begin();
+        return seen_species_ids[index];
     }
 
     void AnalyticalSpeciesAbundancesHandler::addNewSpecies()
     {
         max_species_id++;
         unsigned long new_abundance = getRandomAbundanceOfSpecies();
-        unsigned long cumulative_abundance;
-        if(seen_no_individuals == 0)
-        {
-            cumulative_abundance = new_abundance;
-        }
-        else
-        {
-            cumulative_abundance = new_abundance + ind_to_species.rbegin()->first;
-        }
-        ind_to_species[cumulative_abundance] = max_species_id;
         seen_no_individuals += new_abundance;
-#ifdef DEBUG
-        if(ind_to_species.rbegin()->first != seen_no_individuals)
-        {
-            std::stringstream ss;
-            ss << "ind_to_species end does not equal seen no inds: " << ind_to_species.rbegin()->first << "!=";
-            ss << seen_no_individuals << std::endl;
-            throw FatalException(ss.str());
-        }
-        if(ind_to_species.rbegin()->second != max_species_id)
-        {
-            std::stringstream ss;
-            ss << "Last species id has not been set correctly: " << ind_to_species.rbegin()->second << "!=";
-            ss << max_species_id << std::endl;
-            throw FatalException(ss.str());
-        }
-#endif //DEBUG
+        cumulative_individuals.push_back(seen_no_individuals);
+        seen_species_ids.push_back(max_species_id);
+        species_sampler_outdated = true;
     }
 
     unsigned long AnalyticalSpeciesAbundancesHandler::getRandomAbundanceOfSpecies()
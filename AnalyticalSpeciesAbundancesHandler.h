@@ -18,6 +18,7 @@
 #include "SpeciesAbundancesHandler.h"
 #include "neutral_analytical.h"
 #include "RNGController.h"
+#include "AliasSampler.h"
 
 namespace na = neutral_analytical;
 using std::shared_ptr;
@@ -28,8 +29,14 @@ namespace necsim
     {
     protected:
         unsigned long seen_no_individuals;
-        // Store all previous species ids in a map of cumulative numbers of individuals for searching for ids
-        std::map<unsigned long, unsigned long> ind_to_species;
+        // The cumulative number of individuals up to and including each previously seen species, for searching for ids
+        vector<unsigned long> cumulative_individuals;
+        // The species id of each previously seen species
+        vector<unsigned long> seen_species_ids;
+        // Alias table for choosing a previously seen species, weighted by the number of individuals
+        AliasSampler species_sampler;
+        // True if species have been added since the alias table was generated
+        bool species_sampler_outdated;
     public:
 
         /**
@@ -63,6 +70,11 @@ namespace necsim
          */
         unsigned long getRandomSpeciesID() override;
 
+        /**
+         * @brief Generates the alias table for choosing a previously seen species in constant time.
+         */
+        void generateSpeciesSampler();
+
         /**
          * @brief Picks out a random individual from previously-seen individuals.
          * @param individual_id the individual id number to pick
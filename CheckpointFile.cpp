@@ -0,0 +1,517 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file CheckpointFile.cpp
+ * @brief Contains the binary checkpoint format used for pausing and resuming simulations.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <algorithm>
+#include <sstream>
+
+#ifndef WIN_INSTALL
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif // WIN_INSTALL
+
+#include "cpp17_includes.h"
+#include "CheckpointFile.h"
+
+namespace necsim
+{
+    // Size of the write buffer - sections are written to file in blocks of this size.
+    const uint64_t checkpoint_buffer_size = 1u << 24u;
+    const uint64_t checkpoint_fnv_prime = 1099511628211ULL;
+
+    uint64_t checkpointChecksum(const void* data, uint64_t size, uint64_t seed)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = seed;
+        uint64_t i = 0;
+        for(; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(uint64_t));
+            hash = (hash ^ word) * checkpoint_fnv_prime;
+        }
+        for(; i < size; i++)
+        {
+            hash = (hash ^ bytes[i]) * checkpoint_fnv_prime;
+        }
+        return hash;
+    }
+
+    PackedTreeNode packTreeNode(ConstTreeNodeReference node)
+    {
+        PackedTreeNode packed{};
+        packed.parent = node.getParent();
+        packed.species_id = node.getSpeciesID();
+        packed.xpos = node.getXpos();
+        packed.ypos = node.getYpos();
+        packed.xwrap = node.getXwrap();
+        packed.ywrap = node.getYwrap();
+        packed.generations_existed = node.getGenerationRate();
+        packed.speciation_probability = node.getSpecRate();
+        packed.generation_added = node.getGeneration();
+        packed.tip = static_cast<uint8_t>(node.isTip());
+        packed.speciated = static_cast<uint8_t>(node.hasSpeciated());
+        packed.does_exist = static_cast<uint8_t>(node.exists());
+        return packed;
+    }
+
+    void unpackTreeNode(const PackedTreeNode &packed, TreeNodeReference node)
+    {
+        node.setup(packed.tip != 0,
+                   static_cast<long>(packed.xpos),
+                   static_cast<long>(packed.ypos),
+                   static_cast<long>(packed.xwrap),
+                   static_cast<long>(packed.ywrap),
+                   packed.generation_added);
+        node.setParent(packed.parent);
+        node.burnSpecies(packed.species_id);
+        node.setSpeciation(packed.speciated != 0);
+        node.setExistence(packed.does_exist != 0);
+        node.setSpec(packed.speciation_probability);
+        node.setGenerationRate(packed.generations_existed);
+    }
+
+    PackedDataPoint packDataPoint(const DataPoint &datapoint)
+    {
+        PackedDataPoint packed{};
+        packed.x = datapoint.x;
+        packed.y = datapoint.y;
+        packed.xwrap = datapoint.xwrap;
+        packed.ywrap = datapoint.ywrap;
+        packed.reference = datapoint.getReference();
+        packed.list_position = datapoint.getListpos();
+        packed.min_max = datapoint.getMinmax();
+        return packed;
+    }
+
+    void unpackDataPoint(const PackedDataPoint &packed, DataPoint &datapoint)
+    {
+        datapoint.setup(static_cast<unsigned long>(packed.x),
+                        static_cast<unsigned long>(packed.y),
+                        static_cast<long>(packed.xwrap),
+                        static_cast<long>(packed.ywrap),
+                        packed.reference,
+                        packed.list_position,
+                        packed.min_max);
+    }
+
+    CheckpointWriter::CheckpointWriter() : out(), file_name(), temporary_file_name(), sections(), buffer(), position(0),
+                                           in_section(false)
+    {
+
+    }
+
+    CheckpointWriter::~CheckpointWriter()
+    {
+        if(out.is_open())
+        {
+            // The checkpoint was never completed, so remove the partial file.
+            out.close();
+            std::remove(temporary_file_name.c_str());
+        }
+    }
+
+    void CheckpointWriter::open(const string &file_name_in)
+    {
+        file_name = file_name_in;
+        temporary_file_name = file_name + ".tmp";
+        out.open(temporary_file_name, std::ios::binary | std::ios::trunc);
+        if(!out.good())
+        {
+            std::stringstream ss;
+            ss << "Could not open checkpoint file for writing at " << temporary_file_name << "." << std::endl;
+            throw FatalException(ss.str());
+        }
+        sections.clear();
+        buffer.clear();
+        buffer.reserve(checkpoint_buffer_size);
+        // Write a blank header, which is replaced when the file is closed.
+        CheckpointHeader header{};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(CheckpointHeader));
+        position = sizeof(CheckpointHeader);
+    }
+
+    void CheckpointWriter::flushBuffer()
+    {
+        if(buffer.empty())
+        {
+            return;
+        }
+        // Only flush whole words (except at the end of a section) so that the checksum can be continued across
+        // blocks and still match a checksum of the whole section.
+        uint64_t to_write = buffer.size();
+        if(in_section)
+        {
+            to_write -= to_write % sizeof(uint64_t);
+        }
+        auto &section = sections.back();
+        section.checksum = checkpointChecksum(buffer.data(), to_write, section.checksum);
+        out.write(buffer.data(), static_cast<std::streamsize>(to_write));
+        if(!out.good())
+        {
+            throw FatalException("Failed to write to checkpoint file " + temporary_file_name + ".");
+        }
+        section.size += to_write;
+        position += to_write;
+        buffer.erase(buffer.begin(), buffer.begin() + to_write);
+    }
+
+    void CheckpointWriter::beginSection(const CheckpointSection &id)
+    {
+        if(in_section)
+        {
+            throw FatalException("Cannot begin a checkpoint section before ending the previous section.");
+        }
+        CheckpointSectionEntry entry{};
+        entry.id = static_cast<uint32_t>(id);
+        entry.offset = position;
+        entry.size = 0;
+        entry.checksum = 14695981039346656037ULL;
+        sections.push_back(entry);
+        in_section = true;
+    }
+
+    void CheckpointWriter::write(const void* data, uint64_t size)
+    {
+#ifdef DEBUG
+        if(!in_section)
+        {
+            throw FatalException("Cannot write to checkpoint outside of a section. Please report this bug.");
+        }
+#endif // DEBUG
+        const auto* bytes = static_cast<const char*>(data);
+        while(size > 0)
+        {
+            uint64_t n = std::min(size, checkpoint_buffer_size - static_cast<uint64_t>(buffer.size()));
+            buffer.insert(buffer.end(), bytes, bytes + n);
+            bytes += n;
+            size -= n;
+            if(buffer.size() >= checkpoint_buffer_size)
+            {
+                flushBuffer();
+            }
+        }
+    }
+
+    void CheckpointSink::writeString(const string &value)
+    {
+        writeValue<uint64_t>(value.size());
+        write(value.data(), value.size());
+    }
+
+    void CheckpointSink::writeSection(const CheckpointSection &id,
+                                      const std::function<void(CheckpointSink &)> &write_contents)
+    {
+        beginSection(id);
+        write_contents(*this);
+        endSection();
+    }
+
+    void CheckpointWriter::endSection()
+    {
+        in_section = false;
+        flushBuffer();
+    }
+
+    void CheckpointWriter::close()
+    {
+        if(in_section)
+        {
+            endSection();
+        }
+        CheckpointHeader header{};
+        memcpy(header.magic, checkpoint_magic, sizeof(checkpoint_magic));
+        header.version = checkpoint_version;
+        header.long_double_size = sizeof(long double);
+        header.section_count = sections.size();
+        header.table_offset = position;
+        header.table_checksum = checkpointChecksum(sections.data(), sections.size() * sizeof(CheckpointSectionEntry));
+        out.write(reinterpret_cast<const char*>(sections.data()),
+                  static_cast<std::streamsize>(sections.size() * sizeof(CheckpointSectionEntry)));
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(CheckpointHeader));
+        out.flush();
+        if(!out.good())
+        {
+            throw FatalException("Failed to complete checkpoint file " + temporary_file_name + ".");
+        }
+        out.close();
+        try
+        {
+            fs::rename(temporary_file_name, file_name);
+        }
+        catch(std::exception &e)
+        {
+            std::stringstream ss;
+            ss << "Could not move checkpoint file to " << file_name << ": " << e.what() << std::endl;
+            throw FatalException(ss.str());
+        }
+    }
+
+    const string &CheckpointWriter::getFileName() const
+    {
+        return file_name;
+    }
+
+    CheckpointBuffer::CheckpointBuffer() : sections(), in_section(false)
+    {
+    }
+
+    void CheckpointBuffer::beginSection(const CheckpointSection &id)
+    {
+        if(in_section)
+        {
+            throw FatalException("Cannot begin a checkpoint section before ending the previous section.");
+        }
+        sections.push_back(BufferedSection{id, vector<char>(), nullptr});
+        in_section = true;
+    }
+
+    void CheckpointBuffer::write(const void* data, uint64_t size)
+    {
+#ifdef DEBUG
+        if(!in_section)
+        {
+            throw FatalException("Cannot write to checkpoint outside of a section. Please report this bug.");
+        }
+#endif // DEBUG
+        const auto* bytes = static_cast<const char*>(data);
+        auto &section = sections.back().contents;
+        section.insert(section.end(), bytes, bytes + size);
+    }
+
+    void CheckpointBuffer::endSection()
+    {
+        in_section = false;
+    }
+
+    void CheckpointBuffer::writeSection(const CheckpointSection &id,
+                                        const std::function<void(CheckpointSink &)> &write_contents)
+    {
+        if(in_section)
+        {
+            throw FatalException("Cannot begin a checkpoint section before ending the previous section.");
+        }
+        sections.push_back(BufferedSection{id, vector<char>(), write_contents});
+    }
+
+    void CheckpointBuffer::writeTo(CheckpointWriter &out) const
+    {
+        for(const auto &section : sections)
+        {
+            if(section.write_contents)
+            {
+                out.writeSection(section.id, section.write_contents);
+            }
+            else
+            {
+                out.beginSection(section.id);
+                out.write(section.contents.data(), section.contents.size());
+                out.endSection();
+            }
+        }
+    }
+
+    CheckpointSectionReader::CheckpointSectionReader(const char* data_in, uint64_t size_in) : data(data_in),
+                                                                                               size(size_in),
+                                                                                               position(0)
+    {
+
+    }
+
+    void CheckpointSectionReader::read(void* destination, uint64_t n)
+    {
+        memcpy(destination, view(n), n);
+    }
+
+    const char* CheckpointSectionReader::view(uint64_t n)
+    {
+        if(n > size - position)
+        {
+            throw FatalException("Attempted to read past the end of a checkpoint section.");
+        }
+        const char* out = data + position;
+        position += n;
+        return out;
+    }
+
+    string CheckpointSectionReader::readString()
+    {
+        auto length = readValue<uint64_t>();
+        const char* start = view(length);
+        return string(start, length);
+    }
+
+    uint64_t CheckpointSectionReader::remaining() const
+    {
+        return size - position;
+    }
+
+    CheckpointReader::CheckpointReader() : file_name(), mapped(nullptr), mapped_size(0), sections()
+    {
+
+    }
+
+    CheckpointReader::~CheckpointReader()
+    {
+        unmap();
+    }
+
+    void CheckpointReader::unmap()
+    {
+#ifdef WIN_INSTALL
+        file_contents.clear();
+        file_contents.shrink_to_fit();
+#else
+        if(mapped != nullptr)
+        {
+            munmap(const_cast<char*>(mapped), mapped_size);
+        }
+#endif // WIN_INSTALL
+        mapped = nullptr;
+        mapped_size = 0;
+    }
+
+    void CheckpointReader::open(const string &file_name_in)
+    {
+        unmap();
+        file_name = file_name_in;
+#ifdef WIN_INSTALL
+        std::ifstream in(file_name, std::ios::binary | std::ios::ate);
+        if(!in.good())
+        {
+            throw FatalException("Cannot open checkpoint file at " + file_name + ".");
+        }
+        file_contents.resize(static_cast<unsigned long>(in.tellg()));
+        in.seekg(0);
+        in.read(file_contents.data(), file_contents.size());
+        mapped = file_contents.data();
+        mapped_size = file_contents.size();
+#else
+        int fd = ::open(file_name.c_str(), O_RDONLY);
+        if(fd < 0)
+        {
+            throw FatalException("Cannot open checkpoint file at " + file_name + ".");
+        }
+        struct stat file_stats{};
+        if(fstat(fd, &file_stats) != 0 || file_stats.st_size < static_cast<off_t>(sizeof(CheckpointHeader)))
+        {
+            ::close(fd);
+            throw FatalException("Checkpoint file at " + file_name + " is too small to be valid.");
+        }
+        mapped_size = static_cast<uint64_t>(file_stats.st_size);
+        void* map_result = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping remains valid after the file descriptor is closed.
+        ::close(fd);
+        if(map_result == MAP_FAILED)
+        {
+            mapped_size = 0;
+            throw FatalException("Could not memory-map checkpoint file at " + file_name + ".");
+        }
+        madvise(map_result, mapped_size, MADV_SEQUENTIAL);
+        mapped = static_cast<const char*>(map_result);
+#endif // WIN_INSTALL
+        validate();
+    }
+
+    void CheckpointReader::validate()
+    {
+        if(mapped_size < sizeof(CheckpointHeader))
+        {
+            throw FatalException("Checkpoint file at " + file_name + " is too small to be valid.");
+        }
+        CheckpointHeader header{};
+        memcpy(&header, mapped, sizeof(CheckpointHeader));
+        if(memcmp(header.magic, checkpoint_magic, sizeof(checkpoint_magic)) != 0)
+        {
+            throw FatalException("File at " + file_name + " is not a necsim checkpoint file.");
+        }
+        if(header.version != checkpoint_version)
+        {
+            std::stringstream ss;
+            ss << "Checkpoint file version " << header.version << " does not match the supported version ";
+            ss << checkpoint_version << "." << std::endl;
+            throw FatalException(ss.str());
+        }
+        if(header.long_double_size != sizeof(long double))
+        {
+            throw FatalException("Checkpoint file was written on a platform with a different long double size.");
+        }
+        uint64_t table_size = header.section_count * sizeof(CheckpointSectionEntry);
+        if(header.table_offset > mapped_size || table_size > mapped_size - header.table_offset)
+        {
+            throw FatalException("Checkpoint file at " + file_name + " is truncated.");
+        }
+        if(checkpointChecksum(mapped + header.table_offset, table_size) != header.table_checksum)
+        {
+            throw FatalException("Checkpoint section table in " + file_name + " is corrupt.");
+        }
+        sections.resize(header.section_count);
+        memcpy(sections.data(), mapped + header.table_offset, table_size);
+        for(const auto &section : sections)
+        {
+            if(section.offset > header.table_offset || section.size > header.table_offset - section.offset)
+            {
+                throw FatalException("Checkpoint section lies outside of the file " + file_name + ".");
+            }
+            if(checkpointChecksum(mapped + section.offset, section.size) != section.checksum)
+            {
+                std::stringstream ss;
+                ss << "Checksum mismatch for section " << section.id << " in checkpoint file " << file_name << ".";
+                ss << std::endl;
+                throw FatalException(ss.str());
+            }
+        }
+    }
+
+    bool CheckpointReader::hasSection(const CheckpointSection &id) const
+    {
+        for(const auto &section : sections)
+        {
+            if(section.id == static_cast<uint32_t>(id))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    CheckpointSectionReader CheckpointReader::getSection(const CheckpointSection &id) const
+    {
+        for(const auto &section : sections)
+        {
+            if(section.id == static_cast<uint32_t>(id))
+            {
+                return CheckpointSectionReader(mapped + section.offset, section.size);
+            }
+        }
+        std::stringstream ss;
+        ss << "Section " << static_cast<uint32_t>(id) << " not found in checkpoint file " << file_name << "."
+           << std::endl;
+        throw FatalException(ss.str());
+    }
+
+    bool CheckpointReader::isValid(const string &file_name_in)
+    {
+        try
+        {
+            CheckpointReader reader;
+            reader.open(file_name_in);
+            return true;
+        }
+        catch(FatalException &fe)
+        {
+            return false;
+        }
+    }
+}
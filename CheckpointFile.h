@@ -0,0 +1,452 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file CheckpointFile.h
+ * @brief Contains the binary checkpoint format used for pausing and resuming simulations.
+ *
+ * A checkpoint file consists of a fixed-size header, a number of sections written sequentially and a section table
+ * at the end of the file. Each entry in the section table contains the offset, size and checksum of the section, so
+ * that sections can be validated and located directly from a memory-mapped view of the file.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_CHECKPOINTFILE_H
+#define NECSIM_CHECKPOINTFILE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#include "custom_exceptions.h"
+#include "TreeNodeStore.h"
+#include "DataPoint.h"
+
+using std::string;
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief The identifying bytes at the start of every checkpoint file.
+     */
+    const char checkpoint_magic[8] = {'N', 'E', 'C', 'S', 'I', 'M', 'C', 'K'};
+
+    /**
+     * @brief The current version of the checkpoint format. Increment when the layout of any section changes.
+     */
+    const uint32_t checkpoint_version = 1;
+
+    /**
+     * @brief The first entry of a text pause file, which is followed by the version of the text pause format.
+     * Text pauses written before the format was versioned start directly with the main simulation variables, and are
+     * read as version 0.
+     */
+    const char text_pause_marker[] = "necsim_pause";
+
+    /**
+     * @brief The current version of the text pause format. Increment when entries are added to the text pause.
+     */
+    const unsigned int text_pause_version = 1;
+
+    /**
+     * @brief The identifiers for each of the sections that can be stored in the checkpoint.
+     */
+    enum class CheckpointSection : uint32_t
+    {
+        main = 1, map = 2, active = 3, grid = 4, data = 5
+    };
+
+    /**
+     * @brief The header at the start of the checkpoint file.
+     */
+    struct CheckpointHeader
+    {
+        char magic[8];
+        uint32_t version;
+        // Size of long double on the writing platform, as the data section stores long doubles directly.
+        uint32_t long_double_size;
+        uint64_t section_count;
+        uint64_t table_offset;
+        uint64_t table_checksum;
+    };
+
+    /**
+     * @brief An entry in the section table, describing the location of one section in the file.
+     */
+    struct CheckpointSectionEntry
+    {
+        uint32_t id;
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t checksum;
+    };
+
+    /**
+     * @brief Fixed-width representation of a TreeNode within the data section.
+     */
+    struct PackedTreeNode
+    {
+        uint64_t parent;
+        uint64_t species_id;
+        uint64_t xpos;
+        uint64_t ypos;
+        int64_t xwrap;
+        int64_t ywrap;
+        uint64_t generations_existed;
+        long double speciation_probability;
+        long double generation_added;
+        uint8_t tip;
+        uint8_t speciated;
+        uint8_t does_exist;
+    };
+
+    /**
+     * @brief Fixed-width representation of a DataPoint within the active section.
+     */
+    struct PackedDataPoint
+    {
+        int64_t x;
+        int64_t y;
+        int64_t xwrap;
+        int64_t ywrap;
+        uint64_t reference;
+        uint64_t list_position;
+        double min_max;
+    };
+
+    /**
+     * @brief Calculates a 64-bit FNV-1a style checksum, processing eight bytes at a time where possible.
+     * @param data pointer to the start of the data
+     * @param size the number of bytes to process
+     * @param seed the initial hash value, for continuing a checksum over multiple blocks
+     * @return the checksum
+     */
+    uint64_t checkpointChecksum(const void* data, uint64_t size, uint64_t seed = 14695981039346656037ULL);
+
+    /**
+     * @brief Converts a TreeNode to the fixed-width binary representation.
+     * @param node the node to pack
+     * @return the packed node
+     */
+    PackedTreeNode packTreeNode(ConstTreeNodeReference node);
+
+    /**
+     * @brief Sets a TreeNode from the fixed-width binary representation.
+     * @param packed the packed node to read from
+     * @param node the node to set
+     */
+    void unpackTreeNode(const PackedTreeNode &packed, TreeNodeReference node);
+
+    /**
+     * @brief Converts a DataPoint to the fixed-width binary representation.
+     * @param datapoint the DataPoint to pack
+     * @return the packed DataPoint
+     */
+    PackedDataPoint packDataPoint(const DataPoint &datapoint);
+
+    /**
+     * @brief Sets a DataPoint from the fixed-width binary representation.
+     * @param packed the packed DataPoint to read from
+     * @param datapoint the DataPoint to set
+     */
+    void unpackDataPoint(const PackedDataPoint &packed, DataPoint &datapoint);
+
+    /**
+     * @brief A destination for checkpoint sections, either a file on disk or an in-memory buffer.
+     */
+    class CheckpointSink
+    {
+    public:
+        virtual ~CheckpointSink() = default;
+
+        /**
+         * @brief Starts a new section.
+         * @param id the identifier for the section
+         */
+        virtual void beginSection(const CheckpointSection &id) = 0;
+
+        /**
+         * @brief Writes raw bytes to the current section.
+         * @param data pointer to the start of the data
+         * @param size the number of bytes to write
+         */
+        virtual void write(const void* data, uint64_t size) = 0;
+
+        /**
+         * @brief Ends the current section.
+         */
+        virtual void endSection() = 0;
+
+        /**
+         * @brief Writes a single trivially-copyable value to the current section.
+         * @tparam T the type of the value
+         * @param value the value to write
+         */
+        template<class T> void writeValue(const T &value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Checkpoint values must be trivially copyable.");
+            write(&value, sizeof(T));
+        }
+
+        /**
+         * @brief Writes a string to the current section, prefixed by its length.
+         * @param value the string to write
+         */
+        void writeString(const string &value);
+
+        /**
+         * @brief Writes a whole section, whose contents are written to the sink by the provided function.
+         *
+         * Sinks which write later (such as CheckpointBuffer) may call the function after this function has returned,
+         * so the function must capture everything it reads and the caller must keep that state unchanged until the
+         * checkpoint has been written.
+         *
+         * @param id the identifier for the section
+         * @param write_contents writes the contents of the section to the sink it is given
+         */
+        virtual void writeSection(const CheckpointSection &id,
+                                  const std::function<void(CheckpointSink &)> &write_contents);
+    };
+
+    /**
+     * @brief Writes a checkpoint file as a sequence of sections.
+     *
+     * The file is written to a temporary path and only renamed to the final path once all sections and the section
+     * table have been written, so an interrupted write never replaces an existing valid checkpoint.
+     */
+    class CheckpointWriter : public CheckpointSink
+    {
+    private:
+        std::ofstream out;
+        string file_name;
+        string temporary_file_name;
+        vector<CheckpointSectionEntry> sections;
+        vector<char> buffer;
+        uint64_t position;
+        bool in_section;
+
+        /**
+         * @brief Writes the buffered bytes to file and updates the checksum of the current section.
+         */
+        void flushBuffer();
+
+    public:
+        CheckpointWriter();
+
+        ~CheckpointWriter() override;
+
+        /**
+         * @brief Opens the checkpoint file for writing and writes a placeholder header.
+         * @param file_name_in the path to the final checkpoint file
+         */
+        void open(const string &file_name_in);
+
+        /**
+         * @brief Starts a new section.
+         * @param id the identifier for the section
+         */
+        void beginSection(const CheckpointSection &id) override;
+
+        /**
+         * @brief Writes raw bytes to the current section.
+         * @param data pointer to the start of the data
+         * @param size the number of bytes to write
+         */
+        void write(const void* data, uint64_t size) override;
+
+        /**
+         * @brief Ends the current section, recording its size and checksum.
+         */
+        void endSection() override;
+
+        /**
+         * @brief Writes the section table and final header, then moves the file to its final location.
+         */
+        void close();
+
+        /**
+         * @brief Gets the path of the final checkpoint file.
+         * @return the file name
+         */
+        const string &getFileName() const;
+    };
+
+    /**
+     * @brief Holds the sections of a checkpoint in memory, so that the simulation state can be captured quickly and
+     * written to disk later (for example, on a background thread).
+     *
+     * Sections added using writeSection() are not copied, and are only generated when the buffer is written.
+     */
+    class CheckpointBuffer : public CheckpointSink
+    {
+    private:
+        /**
+         * @brief A section which is either copied into memory or generated when written.
+         */
+        struct BufferedSection
+        {
+            CheckpointSection id;
+            vector<char> contents;
+            std::function<void(CheckpointSink &)> write_contents;
+        };
+
+        vector<BufferedSection> sections;
+        bool in_section;
+
+    public:
+        CheckpointBuffer();
+
+        /**
+         * @brief Starts a new section.
+         * @param id the identifier for the section
+         */
+        void beginSection(const CheckpointSection &id) override;
+
+        /**
+         * @brief Copies raw bytes into the current section.
+         * @param data pointer to the start of the data
+         * @param size the number of bytes to write
+         */
+        void write(const void* data, uint64_t size) override;
+
+        /**
+         * @brief Ends the current section.
+         */
+        void endSection() override;
+
+        /**
+         * @brief Stores the function for writing the section, which is called when the buffer is written.
+         * @param id the identifier for the section
+         * @param write_contents writes the contents of the section to the sink it is given
+         */
+        void writeSection(const CheckpointSection &id,
+                          const std::function<void(CheckpointSink &)> &write_contents) override;
+
+        /**
+         * @brief Writes all buffered sections to the checkpoint writer, generating any deferred sections.
+         * @param out the checkpoint writer, which should already be open
+         */
+        void writeTo(CheckpointWriter &out) const;
+    };
+
+    /**
+     * @brief Provides access to a single section of a checkpoint file, reading sequentially from the start.
+     */
+    class CheckpointSectionReader
+    {
+    private:
+        const char* data;
+        uint64_t size;
+        uint64_t position;
+
+    public:
+        CheckpointSectionReader(const char* data_in, uint64_t size_in);
+
+        /**
+         * @brief Reads raw bytes from the section.
+         * @param destination the location to copy to
+         * @param n the number of bytes to read
+         */
+        void read(void* destination, uint64_t n);
+
+        /**
+         * @brief Gets a pointer to the current position and advances past n bytes, without copying.
+         * @param n the number of bytes to skip over
+         * @return pointer to the data at the previous position
+         */
+        const char* view(uint64_t n);
+
+        /**
+         * @brief Reads a single trivially-copyable value from the section.
+         * @tparam T the type of the value
+         * @return the value read
+         */
+        template<class T> T readValue()
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Checkpoint values must be trivially copyable.");
+            T value;
+            read(&value, sizeof(T));
+            return value;
+        }
+
+        /**
+         * @brief Reads a string, prefixed by its length, from the section.
+         * @return the string read
+         */
+        string readString();
+
+        /**
+         * @brief Gets the number of bytes remaining in the section.
+         * @return the remaining bytes
+         */
+        uint64_t remaining() const;
+    };
+
+    /**
+     * @brief Opens a checkpoint file using a read-only memory map and validates the header and all section checksums.
+     */
+    class CheckpointReader
+    {
+    private:
+        string file_name;
+        const char* mapped;
+        uint64_t mapped_size;
+#ifdef WIN_INSTALL
+        vector<char> file_contents;
+#endif // WIN_INSTALL
+        vector<CheckpointSectionEntry> sections;
+
+        /**
+         * @brief Validates the header, section table and the checksum of each section.
+         */
+        void validate();
+
+        /**
+         * @brief Releases the memory map.
+         */
+        void unmap();
+
+    public:
+        CheckpointReader();
+
+        ~CheckpointReader();
+
+        CheckpointReader(const CheckpointReader &) = delete;
+
+        CheckpointReader &operator=(const CheckpointReader &) = delete;
+
+        /**
+         * @brief Maps the checkpoint file into memory and validates its contents.
+         * @param file_name_in the path to the checkpoint file
+         */
+        void open(const string &file_name_in);
+
+        /**
+         * @brief Checks if the checkpoint contains the given section.
+         * @param id the section identifier
+         * @return true if the section exists
+         */
+        bool hasSection(const CheckpointSection &id) const;
+
+        /**
+         * @brief Gets a reader for the given section.
+         * @param id the section identifier
+         * @return the section reader
+         */
+        CheckpointSectionReader getSection(const CheckpointSection &id) const;
+
+        /**
+         * @brief Checks if the file at the provided path is a complete and valid checkpoint file.
+         * @param file_name_in the path to check
+         * @return true if the checkpoint can be read
+         */
+        static bool isValid(const string &file_name_in);
+    };
+}
+#endif //NECSIM_CHECKPOINTFILE_H
@@ -0,0 +1,600 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file ColumnarTable.cpp
+ * @brief Contains a simple columnar binary format for large, append-only output tables.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#ifdef with_zlib
+
+#include <zlib.h>
+
+#endif // with_zlib
+
+#include "cpp17_includes.h"
+#include "ColumnarTable.h"
+#include "CheckpointFile.h"
+#include "Logging.h"
+
+namespace necsim
+{
+    namespace
+    {
+        template<class T> void appendValue(vector<char> &bytes, const T &value)
+        {
+            const auto* start = reinterpret_cast<const char*>(&value);
+            bytes.insert(bytes.end(), start, start + sizeof(T));
+        }
+
+        template<class T> T readValue(const char* data, uint64_t size, uint64_t &position)
+        {
+            if(size < sizeof(T) || position > size - sizeof(T))
+            {
+                throw FatalException("Unexpected end of data in columnar table.");
+            }
+            T value;
+            memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+            return value;
+        }
+
+        template<class T> T readStream(std::istream &in, const string &file_name)
+        {
+            T value;
+            in.read(reinterpret_cast<char*>(&value), sizeof(T));
+            if(!in.good())
+            {
+                throw FatalException("Columnar table file at " + file_name + " is truncated.");
+            }
+            return value;
+        }
+
+        void writeStream(std::ostream &out, const void* data, uint64_t size, const string &file_name)
+        {
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            if(!out.good())
+            {
+                throw FatalException("Could not write to columnar table file at " + file_name + ".");
+            }
+        }
+    }
+
+    ColumnarCodec getDefaultColumnarCodec()
+    {
+#ifdef with_zlib
+        return ColumnarCodec::delta_varint_zlib;
+#else
+        return ColumnarCodec::delta_varint;
+#endif // with_zlib
+    }
+
+    vector<char> encodeColumn(const vector<int64_t> &values, const ColumnarCodec &codec)
+    {
+        vector<char> bytes;
+        if(codec == ColumnarCodec::raw)
+        {
+            bytes.resize(values.size() * sizeof(int64_t));
+            memcpy(bytes.data(), values.data(), bytes.size());
+            return bytes;
+        }
+        bytes.reserve(values.size() * 2);
+        int64_t previous = 0;
+        for(const auto &value : values)
+        {
+            const auto delta = static_cast<uint64_t>(value) - static_cast<uint64_t>(previous);
+            // Zigzag encoding maps small negative differences to small positive numbers.
+            uint64_t encoded = (delta << 1u) ^ (static_cast<int64_t>(delta) < 0 ? ~uint64_t(0) : uint64_t(0));
+            while(encoded >= 0x80u)
+            {
+                bytes.push_back(static_cast<char>((encoded & 0x7Fu) | 0x80u));
+                encoded >>= 7u;
+            }
+            bytes.push_back(static_cast<char>(encoded));
+            previous = value;
+        }
+        if(codec == ColumnarCodec::delta_varint_zlib)
+        {
+#ifdef with_zlib
+            uLongf compressed_size = compressBound(static_cast<uLong>(bytes.size()));
+            vector<char> compressed(sizeof(uint64_t) + compressed_size);
+            const uint64_t uncompressed_size = bytes.size();
+            memcpy(compressed.data(), &uncompressed_size, sizeof(uint64_t));
+            if(compress2(reinterpret_cast<Bytef*>(compressed.data() + sizeof(uint64_t)),
+                         &compressed_size,
+                         reinterpret_cast<const Bytef*>(bytes.data()),
+                         static_cast<uLong>(bytes.size()),
+                         Z_BEST_SPEED) != Z_OK)
+            {
+                throw FatalException("Could not compress column for columnar table.");
+            }
+            compressed.resize(sizeof(uint64_t) + compressed_size);
+            return compressed;
+#else
+            throw FatalException("Columnar table compression requires compilation with zlib (with_zlib).");
+#endif // with_zlib
+        }
+        return bytes;
+    }
+
+    vector<int64_t> decodeColumn(const char* data, uint64_t size, uint64_t row_count, const ColumnarCodec &codec)
+    {
+        vector<int64_t> values;
+        if(codec == ColumnarCodec::raw)
+        {
+            if(size != row_count * sizeof(int64_t))
+            {
+                throw FatalException("Raw column in columnar table does not match the number of rows.");
+            }
+            values.resize(row_count);
+            memcpy(values.data(), data, size);
+            return values;
+        }
+#ifdef with_zlib
+        vector<char> uncompressed;
+        if(codec == ColumnarCodec::delta_varint_zlib)
+        {
+            uint64_t position = 0;
+            const auto uncompressed_size = readValue<uint64_t>(data, size, position);
+            uncompressed.resize(uncompressed_size);
+            auto destination_size = static_cast<uLongf>(uncompressed_size);
+            if(uncompress(reinterpret_cast<Bytef*>(uncompressed.data()),
+                          &destination_size,
+                          reinterpret_cast<const Bytef*>(data + position),
+                          static_cast<uLong>(size - position)) != Z_OK || destination_size != uncompressed_size)
+            {
+                throw FatalException("Could not decompress column from columnar table.");
+            }
+            data = uncompressed.data();
+            size = uncompressed.size();
+        }
+#else
+        if(codec == ColumnarCodec::delta_varint_zlib)
+        {
+            throw FatalException("Columnar table is compressed with zlib, but necsim was compiled without zlib.");
+        }
+#endif // with_zlib
+        values.reserve(row_count);
+        uint64_t position = 0;
+        int64_t previous = 0;
+        for(uint64_t i = 0; i < row_count; i++)
+        {
+            uint64_t encoded = 0;
+            unsigned int shift = 0;
+            while(true)
+            {
+                if(position >= size || shift > 63)
+                {
+                    throw FatalException("Encoded column in columnar table is corrupt.");
+                }
+                const auto byte = static_cast<unsigned char>(data[position++]);
+                encoded |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+                if((byte & 0x80u) == 0)
+                {
+                    break;
+                }
+                shift += 7;
+            }
+            const uint64_t delta = (encoded >> 1u) ^ (~(encoded & 1u) + 1u);
+            previous = static_cast<int64_t>(static_cast<uint64_t>(previous) + delta);
+            values.push_back(previous);
+        }
+        return values;
+    }
+
+    ColumnarTableReader::ColumnarTableReader() : file_name(), in(), codec(ColumnarCodec::raw), columns(), blocks(),
+                                                 data_offset(0), end_offset(0)
+    {
+
+    }
+
+    void ColumnarTableReader::open(const string &file_name_in)
+    {
+        file_name = file_name_in;
+        in.open(file_name, std::ios::binary);
+        if(!in.good())
+        {
+            throw FatalException("Could not open columnar table file at " + file_name + ".");
+        }
+        char magic[8];
+        in.read(magic, sizeof(magic));
+        if(!in.good() || memcmp(magic, columnar_magic, sizeof(columnar_magic)) != 0)
+        {
+            throw FatalException("File at " + file_name + " is not a necsim columnar table file.");
+        }
+        const auto version = readStream<uint32_t>(in, file_name);
+        if(version != columnar_version)
+        {
+            std::stringstream ss;
+            ss << "Columnar table file version " << version << " does not match the supported version ";
+            ss << columnar_version << "." << std::endl;
+            throw FatalException(ss.str());
+        }
+        codec = static_cast<ColumnarCodec>(readStream<uint32_t>(in, file_name));
+        const auto column_count = readStream<uint64_t>(in, file_name);
+        columns.clear();
+        for(uint64_t i = 0; i < column_count; i++)
+        {
+            const auto name_length = readStream<uint32_t>(in, file_name);
+            const auto column_width = readStream<uint32_t>(in, file_name);
+            if(column_width != sizeof(int64_t))
+            {
+                throw FatalException("Unsupported column width in columnar table file at " + file_name + ".");
+            }
+            string name(name_length, '\0');
+            in.read(&name[0], name_length);
+            columns.push_back(name);
+        }
+        data_offset = static_cast<uint64_t>(in.tellg());
+        in.seekg(0, std::ios::end);
+        const auto file_size = static_cast<uint64_t>(in.tellg());
+        if(file_size < data_offset + sizeof(ColumnarTrailer)
+           || !readIndex(file_size - sizeof(ColumnarTrailer)))
+        {
+            findIndex(file_size);
+        }
+    }
+
+    bool ColumnarTableReader::readIndex(const uint64_t &trailer_offset)
+    {
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(trailer_offset));
+        ColumnarTrailer trailer{};
+        in.read(reinterpret_cast<char*>(&trailer), sizeof(ColumnarTrailer));
+        if(!in.good() || memcmp(trailer.magic, columnar_magic, sizeof(columnar_magic)) != 0)
+        {
+            return false;
+        }
+        // The index is written directly before its trailer.
+        if(trailer.block_count > (trailer_offset - data_offset) / sizeof(ColumnarBlockEntry)
+           || trailer.index_offset != trailer_offset - trailer.block_count * sizeof(ColumnarBlockEntry))
+        {
+            return false;
+        }
+        vector<ColumnarBlockEntry> index(trailer.block_count);
+        in.seekg(static_cast<std::streamoff>(trailer.index_offset));
+        in.read(reinterpret_cast<char*>(index.data()),
+                static_cast<std::streamsize>(index.size() * sizeof(ColumnarBlockEntry)));
+        if(!in.good()
+           || checkpointChecksum(index.data(), index.size() * sizeof(ColumnarBlockEntry)) != trailer.index_checksum)
+        {
+            return false;
+        }
+        for(const auto &block : index)
+        {
+            if(block.offset < data_offset || block.offset > trailer.index_offset
+               || block.size > trailer.index_offset - block.offset)
+            {
+                return false;
+            }
+        }
+        blocks.swap(index);
+        end_offset = trailer_offset + sizeof(ColumnarTrailer);
+        return true;
+    }
+
+    void ColumnarTableReader::findIndex(const uint64_t &file_size)
+    {
+        // The trailer ends with the magic bytes, so search backwards through the file for them, one chunk at a time.
+        const uint64_t chunk_size = 1u << 20u;
+        vector<char> chunk;
+        uint64_t end = file_size;
+        while(end >= data_offset + sizeof(ColumnarTrailer))
+        {
+            const uint64_t start = end - std::min(end - data_offset, chunk_size);
+            chunk.resize(end - start);
+            in.clear();
+            in.seekg(static_cast<std::streamoff>(start));
+            in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            if(!in.good())
+            {
+                break;
+            }
+            for(uint64_t i = chunk.size(); i >= sizeof(columnar_magic); i--)
+            {
+                const uint64_t trailer_end = start + i;
+                if(memcmp(chunk.data() + i - sizeof(columnar_magic), columnar_magic, sizeof(columnar_magic)) == 0
+                   && trailer_end >= data_offset + sizeof(ColumnarTrailer)
+                   && readIndex(trailer_end - sizeof(ColumnarTrailer)))
+                {
+                    std::stringstream ss;
+                    ss << "Columnar table file at " << file_name << " ends with an incomplete write of "
+                       << file_size - end_offset << " bytes, which has been ignored." << std::endl;
+                    writeWarning(ss.str());
+                    return;
+                }
+            }
+            if(start == data_offset)
+            {
+                break;
+            }
+            // Overlap the chunks so that magic bytes which span two chunks are still found.
+            end = start + sizeof(columnar_magic) - 1;
+        }
+        throw FatalException("Columnar table file at " + file_name + " does not contain a complete block index.");
+    }
+
+    const vector<string> &ColumnarTableReader::getColumns() const
+    {
+        return columns;
+    }
+
+    ColumnarCodec ColumnarTableReader::getCodec() const
+    {
+        return codec;
+    }
+
+    const vector<ColumnarBlockEntry> &ColumnarTableReader::getBlocks() const
+    {
+        return blocks;
+    }
+
+    uint64_t ColumnarTableReader::getEndOffset() const
+    {
+        return end_offset;
+    }
+
+    uint64_t ColumnarTableReader::getRowCount() const
+    {
+        uint64_t total = 0;
+        for(const auto &block : blocks)
+        {
+            total += block.row_count;
+        }
+        return total;
+    }
+
+    bool ColumnarTableReader::hasCommunityReference(const uint64_t &community_reference) const
+    {
+        return std::any_of(blocks.begin(), blocks.end(), [&community_reference](const ColumnarBlockEntry &block)
+        {
+            return block.community_reference == community_reference;
+        });
+    }
+
+    vector<int64_t> ColumnarTableReader::readColumn(const string &column, const uint64_t &community_reference)
+    {
+        const unsigned long column_index = getColumnIndex(column);
+        vector<int64_t> values;
+        for(const auto &block : blocks)
+        {
+            if(block.community_reference == community_reference)
+            {
+                readBlockColumn(block, column_index, values);
+            }
+        }
+        return values;
+    }
+
+    vector<int64_t> ColumnarTableReader::readColumn(const string &column)
+    {
+        const unsigned long column_index = getColumnIndex(column);
+        vector<int64_t> values;
+        values.reserve(getRowCount());
+        for(const auto &block : blocks)
+        {
+            readBlockColumn(block, column_index, values);
+        }
+        return values;
+    }
+
+    unsigned long ColumnarTableReader::getColumnIndex(const string &column) const
+    {
+        auto found = std::find(columns.begin(), columns.end(), column);
+        if(found == columns.end())
+        {
+            throw FatalException("Column " + column + " does not exist in columnar table file at " + file_name + ".");
+        }
+        return static_cast<unsigned long>(found - columns.begin());
+    }
+
+    void ColumnarTableReader::readBlockColumn(const ColumnarBlockEntry &block, const unsigned long &column_index,
+                                              vector<int64_t> &values)
+    {
+        vector<char> data(block.size);
+        in.seekg(static_cast<std::streamoff>(block.offset));
+        in.read(data.data(), static_cast<std::streamsize>(block.size));
+        if(!in.good() || checkpointChecksum(data.data(), data.size()) != block.checksum)
+        {
+            throw FatalException("Block in columnar table file at " + file_name + " is corrupt.");
+        }
+        // Each block consists of the size of each column, followed by the encoded columns.
+        uint64_t position = 0;
+        uint64_t column_offset = columns.size() * sizeof(uint64_t);
+        uint64_t column_size = 0;
+        for(unsigned long i = 0; i <= column_index; i++)
+        {
+            column_offset += column_size;
+            column_size = readValue<uint64_t>(data.data(), data.size(), position);
+        }
+        if(column_offset > data.size() || column_size > data.size() - column_offset)
+        {
+            throw FatalException("Column lies outside of the block in columnar table file at " + file_name + ".");
+        }
+        auto decoded = decodeColumn(data.data() + column_offset, column_size, block.row_count, codec);
+        values.insert(values.end(), decoded.begin(), decoded.end());
+    }
+
+    ColumnarTableWriter::ColumnarTableWriter() : file_name(), out(), codec(getDefaultColumnarCodec()), columns(),
+                                                 blocks(), end_of_file(0), index_outdated(false), row_count(0),
+                                                 buffer(),
+                                                 buffered_reference(0), has_buffered_reference(false)
+    {
+
+    }
+
+    ColumnarTableWriter::~ColumnarTableWriter()
+    {
+        if(out.is_open())
+        {
+            out.close();
+        }
+    }
+
+    void ColumnarTableWriter::open(const string &file_name_in, const vector<string> &columns_in)
+    {
+        file_name = file_name_in;
+        columns = columns_in;
+        blocks.clear();
+        buffer.assign(columns.size(), vector<int64_t>());
+        has_buffered_reference = false;
+        if(fs::exists(file_name))
+        {
+            ColumnarTableReader reader;
+            reader.open(file_name);
+            if(reader.getColumns() != columns)
+            {
+                throw FatalException("Columns do not match the existing columnar table file at " + file_name + ".");
+            }
+            codec = reader.getCodec();
+            blocks = reader.getBlocks();
+            row_count = reader.getRowCount();
+            end_of_file = reader.getEndOffset();
+            index_outdated = false;
+            if(fs::file_size(file_name) > end_of_file)
+            {
+                fs::resize_file(file_name, end_of_file);
+            }
+            out.open(file_name, std::ios::binary | std::ios::in | std::ios::out);
+            if(!out.good())
+            {
+                throw FatalException("Could not open columnar table file for writing at " + file_name + ".");
+            }
+            return;
+        }
+        codec = getDefaultColumnarCodec();
+        row_count = 0;
+        out.open(file_name, std::ios::binary | std::ios::out | std::ios::trunc);
+        if(!out.good())
+        {
+            throw FatalException("Could not open columnar table file for writing at " + file_name + ".");
+        }
+        vector<char> header;
+        header.insert(header.end(), columnar_magic, columnar_magic + sizeof(columnar_magic));
+        appendValue(header, columnar_version);
+        appendValue(header, static_cast<uint32_t>(codec));
+        appendValue(header, static_cast<uint64_t>(columns.size()));
+        for(const auto &column : columns)
+        {
+            appendValue(header, static_cast<uint32_t>(column.size()));
+            appendValue(header, static_cast<uint32_t>(sizeof(int64_t)));
+            header.insert(header.end(), column.begin(), column.end());
+        }
+        writeStream(out, header.data(), header.size(), file_name);
+        end_of_file = header.size();
+        writeIndex();
+    }
+
+    uint64_t ColumnarTableWriter::getRowCount() const
+    {
+        return row_count;
+    }
+
+    bool ColumnarTableWriter::hasCommunityReference(const uint64_t &community_reference) const
+    {
+        if(has_buffered_reference && buffered_reference == community_reference)
+        {
+            return true;
+        }
+        return std::any_of(blocks.begin(), blocks.end(), [&community_reference](const ColumnarBlockEntry &block)
+        {
+            return block.community_reference == community_reference;
+        });
+    }
+
+    void ColumnarTableWriter::addRow(const uint64_t &community_reference, const vector<int64_t> &values)
+    {
+        if(values.size() != columns.size())
+        {
+            throw FatalException("Incorrect number of values for row in columnar table file at " + file_name + ".");
+        }
+        if(has_buffered_reference
+           && (buffered_reference != community_reference || buffer.front().size() >= columnar_block_rows))
+        {
+            writeBlock();
+        }
+        buffered_reference = community_reference;
+        has_buffered_reference = true;
+        for(unsigned long i = 0; i < values.size(); i++)
+        {
+            buffer[i].push_back(values[i]);
+        }
+        row_count++;
+    }
+
+    void ColumnarTableWriter::flush()
+    {
+        if(has_buffered_reference)
+        {
+            writeBlock();
+        }
+        if(index_outdated)
+        {
+            writeIndex();
+        }
+        out.flush();
+    }
+
+    void ColumnarTableWriter::close()
+    {
+        if(out.is_open())
+        {
+            flush();
+            out.close();
+        }
+    }
+
+    void ColumnarTableWriter::writeBlock()
+    {
+        vector<vector<char>> encoded;
+        encoded.reserve(columns.size());
+        vector<char> data;
+        for(const auto &column : buffer)
+        {
+            encoded.push_back(encodeColumn(column, codec));
+            appendValue(data, static_cast<uint64_t>(encoded.back().size()));
+        }
+        for(const auto &column : encoded)
+        {
+            data.insert(data.end(), column.begin(), column.end());
+        }
+        ColumnarBlockEntry entry{};
+        entry.community_reference = buffered_reference;
+        entry.row_count = buffer.front().size();
+        entry.offset = end_of_file;
+        entry.size = data.size();
+        entry.checksum = checkpointChecksum(data.data(), data.size());
+        out.seekp(static_cast<std::streamoff>(end_of_file));
+        writeStream(out, data.data(), data.size(), file_name);
+        end_of_file += data.size();
+        blocks.push_back(entry);
+        index_outdated = true;
+        for(auto &column : buffer)
+        {
+            column.clear();
+        }
+        has_buffered_reference = false;
+    }
+
+    void ColumnarTableWriter::writeIndex()
+    {
+        // The index is written at the end of the file, after the previous index, so the file only ever grows and the
+        // previous index can still be found if the new trailer is incomplete.
+        ColumnarTrailer trailer{};
+        trailer.index_offset = end_of_file;
+        trailer.block_count = blocks.size();
+        trailer.index_checksum = checkpointChecksum(blocks.data(), blocks.size() * sizeof(ColumnarBlockEntry));
+        memcpy(trailer.magic, columnar_magic, sizeof(columnar_magic));
+        out.seekp(static_cast<std::streamoff>(end_of_file));
+        writeStream(out, blocks.data(), blocks.size() * sizeof(ColumnarBlockEntry), file_name);
+        writeStream(out, &trailer, sizeof(ColumnarTrailer), file_name);
+        end_of_file += blocks.size() * sizeof(ColumnarBlockEntry) + sizeof(ColumnarTrailer);
+        index_outdated = false;
+    }
+}
@@ -0,0 +1,306 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file ColumnarTable.h
+ * @brief Contains a simple columnar binary format for large, append-only output tables.
+ *
+ * A columnar table file consists of a header describing the columns, a number of blocks of rows, and an index at the
+ * end of the file. Every column is a fixed-width signed 64-bit integer. Each block belongs to a single community
+ * reference and stores each column separately, so that a single column can be read without decoding the others. The
+ * index contains the community reference, row count, offset, size and checksum of every block, so the rows for a
+ * community reference can be located without reading the rest of the file.
+ *
+ * Appending to the file writes the new blocks after the existing index, followed by a new index, so the existing
+ * contents are never overwritten. If the file does not end with a complete index (for example, because the program
+ * stopped during an append) the last complete index in the file is used instead.
+ *
+ * Columns are delta and variable-length encoded, and are additionally compressed with zlib if compiled with with_zlib.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_COLUMNARTABLE_H
+#define NECSIM_COLUMNARTABLE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "custom_exceptions.h"
+
+using std::string;
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief The identifying bytes at the start and end of every columnar table file.
+     */
+    const char columnar_magic[8] = {'N', 'E', 'C', 'S', 'I', 'M', 'C', 'T'};
+
+    /**
+     * @brief The current version of the columnar table format.
+     */
+    const uint32_t columnar_version = 1;
+
+    /**
+     * @brief The number of rows to store in each block, after which a new block is started.
+     */
+    const uint64_t columnar_block_rows = 1u << 16u;
+
+    /**
+     * @brief The encodings that can be used for each column within a block.
+     */
+    enum class ColumnarCodec : uint32_t
+    {
+        // Raw little-endian 64-bit integers.
+        raw = 0,
+        // Differences between consecutive values, zigzag and variable-length encoded.
+        delta_varint = 1,
+        // As for delta_varint, then compressed using zlib.
+        delta_varint_zlib = 2
+    };
+
+    /**
+     * @brief An entry in the block index, describing the location of one block in the file.
+     */
+    struct ColumnarBlockEntry
+    {
+        uint64_t community_reference;
+        uint64_t row_count;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t checksum;
+    };
+
+    /**
+     * @brief The fixed-size trailer at the end of the file.
+     */
+    struct ColumnarTrailer
+    {
+        uint64_t index_offset;
+        uint64_t block_count;
+        uint64_t index_checksum;
+        char magic[8];
+    };
+
+    /**
+     * @brief Gets the default codec, which uses zlib compression if available.
+     * @return the codec to use for new files
+     */
+    ColumnarCodec getDefaultColumnarCodec();
+
+    /**
+     * @brief Encodes the column using the given codec.
+     * @param values the values of the column
+     * @param codec the codec to use
+     * @return the encoded bytes
+     */
+    vector<char> encodeColumn(const vector<int64_t> &values, const ColumnarCodec &codec);
+
+    /**
+     * @brief Decodes a column which has been encoded with encodeColumn().
+     * @param data pointer to the start of the encoded bytes
+     * @param size the number of encoded bytes
+     * @param row_count the number of values in the column
+     * @param codec the codec that was used for encoding
+     * @return the decoded values
+     */
+    vector<int64_t> decodeColumn(const char* data, uint64_t size, uint64_t row_count, const ColumnarCodec &codec);
+
+    /**
+     * @brief Reads the header and index of a columnar table file.
+     */
+    class ColumnarTableReader
+    {
+    private:
+        string file_name;
+        std::ifstream in;
+        ColumnarCodec codec;
+        vector<string> columns;
+        vector<ColumnarBlockEntry> blocks;
+        uint64_t data_offset;
+        // The end of the trailer of the index which has been read.
+        uint64_t end_offset;
+
+        /**
+         * @brief Reads the trailer at the position and the block index it refers to, checking that both are complete.
+         * @param trailer_offset the position of the trailer in the file
+         * @return true if a complete index was read
+         */
+        bool readIndex(const uint64_t &trailer_offset);
+
+        /**
+         * @brief Finds the last complete index in the file, searching backwards from the end for the trailer.
+         * @param file_size the size of the file
+         */
+        void findIndex(const uint64_t &file_size);
+
+        /**
+         * @brief Gets the index of the named column.
+         * @param column the column name
+         * @return the index of the column
+         */
+        unsigned long getColumnIndex(const string &column) const;
+
+        /**
+         * @brief Reads a single column from the block, checking the block checksum.
+         * @param block the block to read from
+         * @param column_index the index of the column to read
+         * @param values the vector to append the decoded values to
+         */
+        void readBlockColumn(const ColumnarBlockEntry &block, const unsigned long &column_index,
+                             vector<int64_t> &values);
+
+    public:
+        ColumnarTableReader();
+
+        /**
+         * @brief Opens the file and reads the header and block index.
+         * @param file_name_in the path to the columnar table file
+         */
+        void open(const string &file_name_in);
+
+        /**
+         * @brief Gets the names of the columns in the table.
+         * @return the column names
+         */
+        const vector<string> &getColumns() const;
+
+        /**
+         * @brief Gets the codec used for the columns in the table.
+         * @return the codec
+         */
+        ColumnarCodec getCodec() const;
+
+        /**
+         * @brief Gets the index of every block in the file.
+         * @return the block index
+         */
+        const vector<ColumnarBlockEntry> &getBlocks() const;
+
+        /**
+         * @brief Gets the end of the last complete index, after which any new blocks should be written.
+         * @return the end of the index trailer
+         */
+        uint64_t getEndOffset() const;
+
+        /**
+         * @brief Gets the total number of rows in the file.
+         * @return the number of rows
+         */
+        uint64_t getRowCount() const;
+
+        /**
+         * @brief Checks if any rows have been written for the community reference.
+         * @param community_reference the community reference to check for
+         * @return true if the file contains rows for the community reference
+         */
+        bool hasCommunityReference(const uint64_t &community_reference) const;
+
+        /**
+         * @brief Reads all values of a column for one community reference.
+         * @param column the name of the column to read
+         * @param community_reference the community reference to read the rows for
+         * @return the values of the column, in the order they were written
+         */
+        vector<int64_t> readColumn(const string &column, const uint64_t &community_reference);
+
+        /**
+         * @brief Reads all values of a column.
+         * @param column the name of the column to read
+         * @return the values of the column, in the order they were written
+         */
+        vector<int64_t> readColumn(const string &column);
+    };
+
+    /**
+     * @brief Writes rows to a columnar table file, appending to the file if it already exists.
+     *
+     * Rows are buffered in memory and written as a block once the block is full, the community reference changes or
+     * flush() is called. The blocks are written after the existing index, and a new index is only written by flush(),
+     * so the file can be read up to the previous index until the new index is complete.
+     */
+    class ColumnarTableWriter
+    {
+    private:
+        string file_name;
+        std::fstream out;
+        ColumnarCodec codec;
+        vector<string> columns;
+        vector<ColumnarBlockEntry> blocks;
+        // The position the next block will be written to, which is the end of the file.
+        uint64_t end_of_file;
+        // True if blocks have been written since the index was last written.
+        bool index_outdated;
+        uint64_t row_count;
+        // The buffered rows for the current community reference, stored by column.
+        vector<vector<int64_t>> buffer;
+        uint64_t buffered_reference;
+        bool has_buffered_reference;
+
+        /**
+         * @brief Writes the buffered rows as a single block at the end of the file.
+         */
+        void writeBlock();
+
+        /**
+         * @brief Writes the block index and trailer at the end of the file.
+         */
+        void writeIndex();
+
+    public:
+        ColumnarTableWriter();
+
+        /**
+         * @brief Closes the file, discarding any buffered rows which have not been written as a block.
+         */
+        ~ColumnarTableWriter();
+
+        ColumnarTableWriter(const ColumnarTableWriter &) = delete;
+
+        ColumnarTableWriter &operator=(const ColumnarTableWriter &) = delete;
+
+        /**
+         * @brief Opens the file for writing, creating it if it does not exist.
+         *
+         * If the file already exists, it must have the same columns, and new rows are appended after the existing
+         * blocks. Anything after the last complete index, left by an incomplete append, is removed.
+         * @param file_name_in the path to the columnar table file
+         * @param columns_in the names of the columns
+         */
+        void open(const string &file_name_in, const vector<string> &columns_in);
+
+        /**
+         * @brief Gets the total number of rows in the file, including buffered rows.
+         * @return the number of rows
+         */
+        uint64_t getRowCount() const;
+
+        /**
+         * @brief Checks if any rows have been written or buffered for the community reference.
+         * @param community_reference the community reference to check for
+         * @return true if the file contains rows for the community reference
+         */
+        bool hasCommunityReference(const uint64_t &community_reference) const;
+
+        /**
+         * @brief Adds a row to the buffer.
+         * @param community_reference the community reference the row belongs to
+         * @param values the value of each column
+         */
+        void addRow(const uint64_t &community_reference, const vector<int64_t> &values);
+
+        /**
+         * @brief Writes all buffered rows to the file, followed by the updated index.
+         */
+        void flush();
+
+        /**
+         * @brief Flushes any buffered rows and closes the file.
+         */
+        void close();
+    };
+}
+#endif //NECSIM_COLUMNARTABLE_H
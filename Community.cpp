@@ -13,6 +13,8 @@
 #include <set>
 #include <unordered_map>
 #include <numeric>
+#include <map>
+#include <future>
 #include "cpp17_includes.h"
 #include "Community.h"
 #include "RNGController.h"
@@ -43,7 +45,7 @@ namespace necsim
         return getVal(xval, yval, xwrap, ywrap);
     }
 
-    bool Samplematrix::getMaskVal(unsigned long x1, unsigned long y1, long x_wrap, long y_wrap)
+    bool Samplematrix::getMaskVal(unsigned long x1, unsigned long y1, long x_wrap, long y_wrap) const
     {
         if(bIsFragment)
         {
@@ -70,7 +72,7 @@ namespace necsim
         bIsFragment = false;
     }
 
-    void Community::setList(shared_ptr<vector<TreeNode>> l)
+    void Community::setList(shared_ptr<TreeNodeStore> l)
     {
         nodes = std::move(l);
     }
@@ -204,61 +206,33 @@ namespace necsim
 #endif // DEBUG
         for(unsigned long i = 1; i < nodes->size(); i++)
         {
-            TreeNode* this_node = &(*nodes)[i];
+            auto this_node = (*nodes)[i];
 #ifdef DEBUG
             if((*nodes)[i].getParent() >= nodes->size())
             {
                 writeLog(50, "i: " + std::to_string(i));
-                this_node->logLineageInformation(50);
+                this_node.logLineageInformation(50);
                 writeLog(50, "size: " + std::to_string(nodes->size()));
                 throw FatalException("The parent is outside the size of the the data object. "
                                      "Bug in expansion of data structures or object set up likely.");
             }
 #endif //DEBUG
-            this_node->setExistence(this_node->isTip() && samplemask.getMaskVal(this_node->getXpos(),
-                                                                                this_node->getYpos(),
-                                                                                this_node->getXwrap(),
-                                                                                this_node->getYwrap()) && doubleCompare(
-                    this_node->getGeneration(),
-                    current_community_parameters->time,
-                    0.0001));
+            this_node.setExistence(isExistingTip(this_node, current_community_parameters->time));
             // Calculate if speciation occured at any point in the lineage's branch
-            if(protracted)
+            if(checkNodeSpeciation(this_node, current_community_parameters->speciation_rate))
             {
-                long double lineage_age = this_node->getGeneration() + this_node->getGenerationRate();
-                if(lineage_age >= applied_protracted_parameters.min_speciation_gen)
-                {
-                    if(checkSpeciation(this_node->getSpecRate(),
-                                       current_community_parameters->speciation_rate,
-                                       this_node->getGenerationRate()))
-                    {
-                        this_node->speciate();
-                    }
-                    if(lineage_age >= applied_protracted_parameters.max_speciation_gen)
-                    {
-                        this_node->speciate();
-                    }
-                }
+                this_node.speciate();
             }
-            else
+            if(!protracted && !this_node.hasSpeciated() && this_node.getParent() == 0 && this_node.exists())
             {
-                if(checkSpeciation(this_node->getSpecRate(),
-                                   current_community_parameters->speciation_rate,
-                                   this_node->getGenerationRate()))
-                {
-                    this_node->speciate();
-                }
-                if(!this_node->hasSpeciated() && this_node->getParent() == 0 && this_node->exists())
-                {
-                    std::stringstream ss;
-                    ss << "\n\tLineage at " << i << " has not speciated and parent is 0. Integer overflow possible. "
-                                                    "Correcting by setting gens_alive to min value necessary for speciation."
-                       << std::endl;
-                    writeError(ss.str());
-                    double necessary_gen_rate = ceil(log(1 - this_node->getSpecRate()) / log(1 - min_spec_rate));
-                    this_node->setGenerationRate((unsigned long) necessary_gen_rate);
-                    this_node->speciate();
-                }
+                std::stringstream ss;
+                ss << "\n\tLineage at " << i << " has not speciated and parent is 0. Integer overflow possible. "
+                                                "Correcting by setting gens_alive to min value necessary for speciation."
+                   << std::endl;
+                writeError(ss.str());
+                double necessary_gen_rate = ceil(log(1 - this_node.getSpecRate()) / log(1 - min_spec_rate));
+                this_node.setGenerationRate((unsigned long) necessary_gen_rate);
+                this_node.speciate();
             }
         }
 
@@ -268,38 +242,20 @@ namespace necsim
         writeInfo(ss2.str());
         writeLog(10, "Calculating lineage existence.");
 #endif // DEBUG
-        // now continue looping to calculate species identities for lineages given the new speciation probabilities.
-        bool bSorter = true;
-        while(bSorter)
+        // Parents are always added to the tree after their children, so existence can be calculated in a single sweep
+        // of the tree. If the tree is not ordered (which should not happen), fall back to the iterative method.
+        const bool is_ordered = isTopologicallyOrdered();
+        if(is_ordered)
         {
-            bSorter = false;
-            for(unsigned long i = 1; i < nodes->size(); i++)
-            {
-                TreeNode* this_node = &(*nodes)[i];
-                // check if any parents exist
-                if(!(*nodes)[this_node->getParent()].exists() && this_node->exists() && !this_node->hasSpeciated())
-                {
-                    bSorter = true;
-                    if(this_node->getParent() == 0)
-                    {
-                        std::stringstream ss;
-                        ss << std::setprecision(64);
-                        ss << "Parent of lineage at " << i << " is 0, but node exists and has not speciated."
-                           << " Possible corrupt database, otherwise, please report this bug." << std::endl;
-                        ss << "Lineage parameters: " << std::endl;
-                        ss << "Speciation: " << this_node->hasSpeciated() << std::endl;
-                        ss << "Tip: " << this_node->isTip() << std::endl;
-                        ss << "Random number: " << this_node->getSpecRate() << std::endl;
-                        ss << "Gens alive: " << this_node->getGenerationRate() << std::endl;
-                        ss << "Gen added: " << this_node->getGeneration() << std::endl;
-                        ss << "Speciation check: " << checkSpeciation(this_node->getSpecRate(),
-                                                                      current_community_parameters->speciation_rate,
-                                                                      this_node->getGenerationRate()) << std::endl;
-                        throw FatalException(ss.str());
-                    }
-                    (*nodes)[this_node->getParent()].setExistence(true);
-                }
-            }
+            calculateExistence();
+#ifdef DEBUG
+            checkExistence();
+#endif // DEBUG
+        }
+        else
+        {
+            writeWarning("Coalescence tree is not topologically ordered, using iterative calculation.\n");
+            calculateExistenceIteratively();
         }
 #ifdef DEBUG
         writeLog(10, "Speciating lineages.");
@@ -307,13 +263,12 @@ namespace necsim
         species_count = 0;
         std::set<unsigned long> species_list;
         // Now loop again, creating a new species for each species that actually exists.
-        auto start = nodes->begin();
-        start++;
-        for(auto item = start; item != nodes->end(); item++)
+        for(unsigned long i = 1; i < nodes->size(); i++)
         {
-            if(item->exists() && item->hasSpeciated())
+            auto this_node = (*nodes)[i];
+            if(this_node.exists() && this_node.hasSpeciated())
             {
-                addSpecies(species_count, &(*item), species_list);
+                addSpecies(species_count, this_node, species_list);
             }
         }
 
@@ -338,21 +293,21 @@ namespace necsim
             //		old_ids_to_new_ids.reserve(species_count);
             for(unsigned long i = 1; i < nodes->size(); i++)
             {
-                TreeNode* this_node = &(*nodes)[i];
-                if(this_node->hasSpeciated() && this_node->exists())
+                auto this_node = (*nodes)[i];
+                if(this_node.hasSpeciated() && this_node.exists())
                 {
-                    auto map_id = old_ids_to_new_ids.find(this_node->getSpeciesID());
+                    auto map_id = old_ids_to_new_ids.find(this_node.getSpeciesID());
                     if(map_id == old_ids_to_new_ids.end())
                     {
                         tmp_species_count++;
-                        old_ids_to_new_ids[this_node->getSpeciesID()] = tmp_species_count;
-                        this_node->resetSpecies();
-                        this_node->burnSpecies(tmp_species_count);
+                        old_ids_to_new_ids[this_node.getSpeciesID()] = tmp_species_count;
+                        this_node.resetSpecies();
+                        this_node.burnSpecies(tmp_species_count);
                     }
                     else
                     {
-                        this_node->resetSpecies();
-                        this_node->burnSpecies(map_id->second);
+                        this_node.resetSpecies();
+                        this_node.burnSpecies(map_id->second);
                     }
                 }
             }
@@ -374,21 +329,394 @@ namespace necsim
             species_count = 0;
             for(unsigned long i = 0; i < nodes->size(); i++)
             {
-                TreeNode* this_node = &(*nodes)[i];
+                auto this_node = (*nodes)[i];
                 // count all speciation events, not just the ones that exist!
-                if(this_node->hasSpeciated() && this_node->exists() && this_node->getSpeciesID() != 0)
+                if(this_node.hasSpeciated() && this_node.exists() && this_node.getSpeciesID() != 0)
                 {
                     species_count++;
                 }
             }
             writeInfo("\n\tAssigning species IDs...\n");
         }
-        // now loop to correctly assign each species id
-        bool loopon = true;
-        bool error_printed = false;
 #ifdef DEBUG
         writeLog(10, "Generating species IDs.");
 #endif // DEBUG
+        if(is_ordered)
+        {
+            assignSpeciesIDs();
+#ifdef DEBUG
+            checkSpeciesIDs();
+#endif // DEBUG
+        }
+        else
+        {
+            assignSpeciesIDsIteratively();
+        }
+        // count the number of species that have been created
+#ifdef DEBUG
+        writeLog(10, "Completed tree creation.");
+#endif // DEBUG
+        species_index = species_count;
+        //		os << "species_index: " << species_index << std::endl;
+        return species_count;
+    }
+
+    bool Community::isExistingTip(ConstTreeNodeReference this_node, const long double &time) const
+    {
+        return this_node.isTip() && samplemask.getMaskVal(this_node.getXpos(),
+                                                          this_node.getYpos(),
+                                                          this_node.getXwrap(),
+                                                          this_node.getYwrap())
+               && doubleCompare(this_node.getGeneration(), time, 0.0001);
+    }
+
+    bool Community::checkNodeSpeciation(ConstTreeNodeReference this_node, const long double &speciation_rate) const
+    {
+        if(protracted)
+        {
+            long double lineage_age = this_node.getGeneration() + this_node.getGenerationRate();
+            if(lineage_age < applied_protracted_parameters.min_speciation_gen)
+            {
+                return false;
+            }
+            if(lineage_age >= applied_protracted_parameters.max_speciation_gen)
+            {
+                return true;
+            }
+        }
+        return checkSpeciation(this_node.getSpecRate(), speciation_rate, this_node.getGenerationRate());
+    }
+
+    bool Community::canCalculateMultipleRates() const
+    {
+        // The other outputs require the species ID of every lineage, so must be calculated one rate at a time.
+        return spec_sim_parameters->all_speciation_rates.size() > 1 && !spec_sim_parameters->use_spatial
+               && !spec_sim_parameters->record_ages && !spec_sim_parameters->use_fragments;
+    }
+
+    vector<shared_ptr<vector<unsigned long>>>
+    Community::calculateMultipleRateAbundances(const vector<long double> &speciation_rates, const long double &time)
+    {
+        vector<shared_ptr<vector<unsigned long>>> all_abundances;
+        const unsigned long n_rates = speciation_rates.size();
+        if(n_rates == 0 || !has_imported_samplemask || !isTopologicallyOrdered())
+        {
+            return all_abundances;
+        }
+        // For each lineage, find the index of the lowest speciation rate at which it speciates. Speciation is monotonic
+        // in the speciation rate, so a binary search over the rates can be used.
+        vector<unsigned long> min_rate_index(nodes->size(), n_rates);
+        // The number of individuals at the tips of each lineage.
+        vector<unsigned long> abundance(nodes->size(), 0);
+        for(unsigned long i = 1; i < nodes->size(); i++)
+        {
+            const auto this_node = (*nodes)[i];
+            unsigned long lower = 0;
+            unsigned long upper = n_rates;
+            while(lower < upper)
+            {
+                const unsigned long mid = lower + (upper - lower) / 2;
+                if(checkNodeSpeciation(this_node, speciation_rates[mid]))
+                {
+                    upper = mid;
+                }
+                else
+                {
+                    lower = mid + 1;
+                }
+            }
+            min_rate_index[i] = lower;
+            // Lineages without parents which do not speciate require correction, which is only performed by
+            // calculateCoalescenceTree().
+            if(this_node.getParent() == 0 && lower != 0)
+            {
+                return all_abundances;
+            }
+            abundance[i] = isExistingTip(this_node, time) ? 1 : 0;
+        }
+        // Starting from the highest speciation rate, lineages are merged with their parents as the rate is lowered
+        // past the lowest rate at which they speciate. Each set of merged lineages is a species, identified by the
+        // lineage at the top of the set.
+        vector<unsigned long> set_parent(nodes->size());
+        vector<unsigned long> set_top(nodes->size());
+        std::iota(set_parent.begin(), set_parent.end(), 0);
+        std::iota(set_top.begin(), set_top.end(), 0);
+        auto find_set = [&set_parent](unsigned long i)
+        {
+            while(set_parent[i] != i)
+            {
+                set_parent[i] = set_parent[set_parent[i]];
+                i = set_parent[i];
+            }
+            return i;
+        };
+        // The lineages which become part of their parent's species at each rate index, with the final entry for
+        // lineages which never speciate.
+        vector<vector<unsigned long>> merges(n_rates + 1);
+        for(unsigned long i = 1; i < nodes->size(); i++)
+        {
+            merges[min_rate_index[i]].push_back(i);
+        }
+        // The tops of the sets which contain at least one individual, in the same order as species IDs are assigned
+        // by calculateCoalescenceTree().
+        std::set<unsigned long> species_tops;
+        auto merge_with_parent = [&](const unsigned long &i)
+        {
+            const unsigned long child_set = find_set(i);
+            const unsigned long parent_set = find_set((*nodes)[i].getParent());
+            if(abundance[child_set] > 0)
+            {
+                species_tops.erase(set_top[child_set]);
+                if(abundance[parent_set] == 0)
+                {
+                    species_tops.insert(set_top[parent_set]);
+                }
+            }
+            set_parent[child_set] = parent_set;
+            abundance[parent_set] += abundance[child_set];
+        };
+        for(const auto &i : merges[n_rates])
+        {
+            merge_with_parent(i);
+        }
+        for(unsigned long i = 1; i < nodes->size(); i++)
+        {
+            if(set_parent[i] == i && abundance[i] > 0)
+            {
+                species_tops.insert(set_top[i]);
+            }
+        }
+        all_abundances.resize(n_rates);
+        for(unsigned long k = n_rates; k > 0; k--)
+        {
+            auto species_abundances_k = make_shared<vector<unsigned long>>();
+            species_abundances_k->reserve(species_tops.size() + 1);
+            species_abundances_k->push_back(0);
+            for(const auto &top : species_tops)
+            {
+                species_abundances_k->push_back(abundance[find_set(top)]);
+            }
+            all_abundances[k - 1] = species_abundances_k;
+            for(const auto &i : merges[k - 1])
+            {
+                merge_with_parent(i);
+            }
+        }
+        return all_abundances;
+    }
+
+    bool Community::canCalculateInParallel() const
+    {
+        return spec_sim_parameters->num_threads > 1 && has_imported_samplemask && isTopologicallyOrdered();
+    }
+
+    shared_ptr<vector<unsigned long>> Community::calculateLabels(const long double &speciation_rate,
+                                                                 const long double &time,
+                                                                 TreeNodeStore::Labels &labels) const
+    {
+        labels = nodes->getResetLabels();
+        // Children always come before their parents, so the existence of each node is final by the time it is reached.
+        for(unsigned long i = 1; i < nodes->size(); i++)
+        {
+            const auto this_node = (*nodes)[i];
+            const bool existing_tip = isExistingTip(this_node, time);
+            if(existing_tip)
+            {
+                labels.setExistence(i);
+            }
+            if(checkNodeSpeciation(this_node, speciation_rate))
+            {
+                labels.speciate(i);
+            }
+            else if(labels.exists(i))
+            {
+                // Lineages without parents are either corrected or reported by calculateCoalescenceTree().
+                if(this_node.getParent() == 0)
+                {
+                    return nullptr;
+                }
+                labels.setExistence(this_node.getParent());
+            }
+        }
+        unsigned long species_count = 0;
+        for(unsigned long i = 1; i < nodes->size(); i++)
+        {
+            if(labels.exists(i) && labels.hasSpeciated(i))
+            {
+                species_count++;
+                labels.setSpeciesID(i, species_count);
+            }
+        }
+        // Parents always come after their children, so working backwards means that the species ID of the parent is
+        // always known.
+        for(unsigned long i = nodes->size(); i-- > 1;)
+        {
+            if(labels.getSpeciesID(i) == 0 && labels.exists(i))
+            {
+                labels.setSpeciesID(i, labels.getSpeciesID((*nodes)[i].getParent()));
+                if(labels.getSpeciesID(i) == 0)
+                {
+                    return nullptr;
+                }
+            }
+        }
+        auto abundances = make_shared<vector<unsigned long>>(species_count + 1, 0);
+        for(unsigned long i = 1; i < nodes->size(); i++)
+        {
+            if(labels.isTip(i) && labels.exists(i) && doubleCompare((*nodes)[i].getGeneration(), time, 0.0001))
+            {
+                (*abundances)[labels.getSpeciesID(i)]++;
+            }
+        }
+        return abundances;
+    }
+
+    void Community::calculateLabelsInParallel(const vector<std::pair<double, double>> &calculations,
+                                              vector<shared_ptr<TreeNodeStore::Labels>> &labels,
+                                              vector<shared_ptr<vector<unsigned long>>> &abundances) const
+    {
+        labels.assign(calculations.size(), nullptr);
+        abundances.assign(calculations.size(), nullptr);
+        vector<std::future<void>> workers;
+        for(unsigned long i = 0; i < calculations.size(); i++)
+        {
+            labels[i] = make_shared<TreeNodeStore::Labels>();
+            workers.emplace_back(std::async(std::launch::async, [this, &calculations, &labels, &abundances, i]
+            {
+                abundances[i] = calculateLabels(calculations[i].first, calculations[i].second, *labels[i]);
+            }));
+        }
+        for(auto &worker : workers)
+        {
+            worker.get();
+        }
+        for(unsigned long i = 0; i < calculations.size(); i++)
+        {
+            if(!abundances[i])
+            {
+                labels[i].reset();
+            }
+        }
+    }
+
+    bool Community::isTopologicallyOrdered() const
+    {
+        for(unsigned long i = 1; i < nodes->size(); i++)
+        {
+            const unsigned long parent = (*nodes)[i].getParent();
+            if(parent != 0 && parent <= i)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    string Community::getLineageDescription(const unsigned long &index) const
+    {
+        const auto this_node = (*nodes)[index];
+        std::stringstream ss;
+        ss << std::setprecision(64);
+        ss << "Lineage parameters: " << std::endl;
+        ss << "Speciation: " << this_node.hasSpeciated() << std::endl;
+        ss << "Tip: " << this_node.isTip() << std::endl;
+        ss << "Random number: " << this_node.getSpecRate() << std::endl;
+        ss << "Gens alive: " << this_node.getGenerationRate() << std::endl;
+        ss << "Gen added: " << this_node.getGeneration() << std::endl;
+        ss << "Speciation check: " << checkSpeciation(this_node.getSpecRate(),
+                                                      current_community_parameters->speciation_rate,
+                                                      this_node.getGenerationRate()) << std::endl;
+        return ss.str();
+    }
+
+    void Community::calculateExistence()
+    {
+        // Children always come before their parents, so the existence of each node is final by the time it is reached.
+        for(unsigned long i = 1; i < nodes->size(); i++)
+        {
+            auto this_node = (*nodes)[i];
+            if(this_node.exists() && !this_node.hasSpeciated())
+            {
+                if(this_node.getParent() == 0)
+                {
+                    std::stringstream ss;
+                    ss << "Parent of lineage at " << i << " is 0, but node exists and has not speciated."
+                       << " Possible corrupt database, otherwise, please report this bug." << std::endl;
+                    ss << getLineageDescription(i);
+                    throw FatalException(ss.str());
+                }
+                (*nodes)[this_node.getParent()].setExistence(true);
+            }
+        }
+    }
+
+    void Community::calculateExistenceIteratively()
+    {
+        bool bSorter = true;
+        while(bSorter)
+        {
+            bSorter = false;
+            for(unsigned long i = 1; i < nodes->size(); i++)
+            {
+                auto this_node = (*nodes)[i];
+                // check if any parents exist
+                if(!(*nodes)[this_node.getParent()].exists() && this_node.exists() && !this_node.hasSpeciated())
+                {
+                    bSorter = true;
+                    if(this_node.getParent() == 0)
+                    {
+                        std::stringstream ss;
+                        ss << "Parent of lineage at " << i << " is 0, but node exists and has not speciated."
+                           << " Possible corrupt database, otherwise, please report this bug." << std::endl;
+                        ss << getLineageDescription(i);
+                        throw FatalException(ss.str());
+                    }
+                    (*nodes)[this_node.getParent()].setExistence(true);
+                }
+            }
+        }
+    }
+
+    void Community::assignSpeciesIDs()
+    {
+        // Parents always come after their children, so working backwards means that the species ID of the parent is
+        // always known.
+        for(unsigned long i = nodes->size(); i-- > 1;)
+        {
+            auto this_node = (*nodes)[i];
+            if(this_node.getSpeciesID() == 0 && this_node.exists())
+            {
+                unsigned long parent = this_node.getParent();
+                if(parent == 0)
+                {
+                    std::stringstream ss;
+                    ss << "Parent of lineage at " << i << " is 0, but no species ID assigned and node exists."
+                       << " Possible corrupt database, otherwise, please report this bug." << std::endl;
+                    ss << getLineageDescription(i);
+                    throw FatalException(ss.str());
+                }
+                this_node.burnSpecies((*nodes)[parent].getSpeciesID());
+                if(this_node.getSpeciesID() == 0)
+                {
+                    std::stringstream ss;
+                    ss << "Potential parent ID error in " << i << " - incomplete simulation likely." << std::endl;
+                    writeCritical(ss.str());
+#ifdef DEBUG
+                    writeLog(50, "Lineage information:");
+                    this_node.logLineageInformation(50);
+                    writeLog(50, "Parent information:");
+                    (*nodes)[parent].logLineageInformation(50);
+#endif // DEBUG
+                    throw FatalException("Parent ID error when calculating coalescence tree.");
+                }
+            }
+        }
+    }
+
+    void Community::assignSpeciesIDsIteratively()
+    {
+        bool loopon = true;
+        bool error_printed = false;
         while(loopon)
         {
             loopon = false;
@@ -396,33 +724,24 @@ namespace necsim
             // speciation events.
             for(unsigned long i = (nodes->size()) - 1; i > 0; i--)
             {
-                TreeNode* this_node = &(*nodes)[i];
+                auto this_node = (*nodes)[i];
                 //				os << i << std::endl;
-                if(this_node->getSpeciesID() == 0 && this_node->exists())
+                if(this_node.getSpeciesID() == 0 && this_node.exists())
                 {
                     loopon = true;
-                    unsigned long parent = this_node->getParent();
+                    unsigned long parent = this_node.getParent();
                     if(parent == 0)
                     {
                         std::stringstream ss;
-                        ss << std::setprecision(64);
                         ss << "Parent of lineage at " << i << " is 0, but no species ID assigned and node exists."
                            << " Possible corrupt database, otherwise, please report this bug." << std::endl;
-                        ss << "Lineage parameters: " << std::endl;
-                        ss << "Speciation: " << this_node->hasSpeciated() << std::endl;
-                        ss << "Tip: " << this_node->isTip() << std::endl;
-                        ss << "Random number: " << this_node->getSpecRate() << std::endl;
-                        ss << "Gens alive: " << this_node->getGenerationRate() << std::endl;
-                        ss << "Gen added: " << this_node->getGeneration() << std::endl;
-                        ss << "Speciation check: " << checkSpeciation(this_node->getSpecRate(),
-                                                                      current_community_parameters->speciation_rate,
-                                                                      this_node->getGenerationRate()) << std::endl;
+                        ss << getLineageDescription(i);
                         throw FatalException(ss.str());
                     }
-                    this_node->burnSpecies((*nodes)[parent].getSpeciesID());
+                    this_node.burnSpecies((*nodes)[parent].getSpeciesID());
 #ifdef DEBUG
-                    if((*nodes)[this_node->getParent()].getSpeciesID() == 0
-                       && doubleCompare(this_node->getGeneration(), current_community_parameters->time, 0.001))
+                    if((*nodes)[this_node.getParent()].getSpeciesID() == 0
+                       && doubleCompare(this_node.getGeneration(), current_community_parameters->time, 0.001))
                     {
 
                         if(!error_printed)
@@ -432,9 +751,9 @@ namespace necsim
                                << std::endl;
                             writeCritical(ss.str());
                             writeLog(50, "Lineage information:");
-                            this_node->logLineageInformation(50);
+                            this_node.logLineageInformation(50);
                             writeLog(50, "Parent information:");
-                            (*nodes)[this_node->getParent()].logLineageInformation(50);
+                            (*nodes)[this_node.getParent()].logLineageInformation(50);
                             error_printed = true;
                             break;
                         }
@@ -448,19 +767,56 @@ namespace necsim
                 throw FatalException("Parent ID error when calculating coalescence tree.");
             }
         }
-        // count the number of species that have been created
+    }
+
 #ifdef DEBUG
-        writeLog(10, "Completed tree creation.");
-#endif // DEBUG
-        species_index = species_count;
-        //		os << "species_index: " << species_index << std::endl;
-        return species_count;
+
+    void Community::checkExistence()
+    {
+        vector<bool> existence(nodes->size());
+        for(unsigned long i = 0; i < nodes->size(); i++)
+        {
+            existence[i] = (*nodes)[i].exists();
+        }
+        calculateExistenceIteratively();
+        for(unsigned long i = 0; i < nodes->size(); i++)
+        {
+            if(existence[i] != (*nodes)[i].exists())
+            {
+                std::stringstream ss;
+                ss << "Existence of lineage " << i << " differs between the single-pass and iterative calculations. "
+                   << "Please report this bug." << std::endl;
+                throw FatalException(ss.str());
+            }
+        }
     }
 
-    void Community::addSpecies(unsigned long &species_count, TreeNode* tree_node, std::set<unsigned long> &species_list)
+    void Community::checkSpeciesIDs()
+    {
+        vector<unsigned long> species_ids(nodes->size());
+        for(unsigned long i = 0; i < nodes->size(); i++)
+        {
+            species_ids[i] = (*nodes)[i].getSpeciesID();
+        }
+        assignSpeciesIDsIteratively();
+        for(unsigned long i = 0; i < nodes->size(); i++)
+        {
+            if(species_ids[i] != (*nodes)[i].getSpeciesID())
+            {
+                std::stringstream ss;
+                ss << "Species ID of lineage " << i << " differs between the single-pass and iterative calculations. "
+                   << "Please report this bug." << std::endl;
+                throw FatalException(ss.str());
+            }
+        }
+    }
+
+#endif // DEBUG
+
+    void Community::addSpecies(unsigned long &species_count, TreeNodeReference tree_node, std::set<unsigned long> &species_list)
     {
         species_count++;
-        tree_node->burnSpecies(species_count);
+        tree_node.burnSpecies(species_count);
     }
 
     void Community::calcSpeciesAbundance()
@@ -470,62 +826,62 @@ namespace necsim
         species_abundances->resize(species_index + 1, 0);
         for(unsigned long i = 1; i < nodes->size(); i++)
         {
-            TreeNode* this_node = &(*nodes)[i];
-            if(this_node->isTip()
-               && doubleCompare(this_node->getGeneration(), current_community_parameters->time, 0.0001)
-               && this_node->exists())
+            auto this_node = (*nodes)[i];
+            if(this_node.isTip()
+               && doubleCompare(this_node.getGeneration(), current_community_parameters->time, 0.0001)
+               && this_node.exists())
             {
 #ifdef DEBUG
-                if(this_node->getSpeciesID() >= species_abundances->size())
+                if(this_node.getSpeciesID() >= species_abundances->size())
                 {
                     throw std::out_of_range("Node index out of range of abundances size. Please report this bug.");
                 }
 #endif // DEBUG
                 // The line that counts the number of individuals
-                species_abundances->operator[](this_node->getSpeciesID())++;
+                species_abundances->operator[](this_node.getSpeciesID())++;
 #ifdef DEBUG
-                if(!samplemask.getMaskVal(this_node->getXpos(),
-                                          this_node->getYpos(),
-                                          this_node->getXwrap(),
-                                          this_node->getYwrap())
-                   && doubleCompare(this_node->getGeneration(), current_community_parameters->time, 0.0001))
+                if(!samplemask.getMaskVal(this_node.getXpos(),
+                                          this_node.getYpos(),
+                                          this_node.getXwrap(),
+                                          this_node.getYwrap())
+                   && doubleCompare(this_node.getGeneration(), current_community_parameters->time, 0.0001))
                 {
                     std::stringstream ss;
                     ss << "x,y " << (*nodes)[i].getXpos() << ", " << (*nodes)[i].getYpos() << std::endl;
                     ss << "tip: " << (*nodes)[i].isTip() << " Existance: " << (*nodes)[i].exists() << " samplemask: "
-                       << samplemask.getMaskVal(this_node->getXpos(),
-                                                this_node->getYpos(),
-                                                this_node->getXwrap(),
-                                                this_node->getYwrap()) << std::endl;
+                       << samplemask.getMaskVal(this_node.getXpos(),
+                                                this_node.getYpos(),
+                                                this_node.getXwrap(),
+                                                this_node.getYwrap()) << std::endl;
                     ss << "ERROR_SQL_005: Tip doesn't exist. Something went wrong either in the import or "
                           "main simulation running." << std::endl;
                     writeWarning(ss.str());
 
                 }
-                if(this_node->getSpeciesID() == 0 && samplemask.getMaskVal(this_node->getXpos(),
-                                                                           this_node->getYpos(),
-                                                                           this_node->getXwrap(),
-                                                                           this_node->getYwrap())
-                   && doubleCompare(this_node->getGeneration(), current_community_parameters->time, 0.0001))
+                if(this_node.getSpeciesID() == 0 && samplemask.getMaskVal(this_node.getXpos(),
+                                                                          this_node.getYpos(),
+                                                                          this_node.getXwrap(),
+                                                                          this_node.getYwrap())
+                   && doubleCompare(this_node.getGeneration(), current_community_parameters->time, 0.0001))
                 {
                     std::stringstream ss;
-                    ss << "x,y " << this_node->getXpos() << ", " << this_node->getYpos() << std::endl;
-                    ss << "generation (point,required): " << this_node->getGeneration() << ", "
+                    ss << "x,y " << this_node.getXpos() << ", " << this_node.getYpos() << std::endl;
+                    ss << "generation (point,required): " << this_node.getGeneration() << ", "
                        << current_community_parameters->time << std::endl;
-                    TreeNode* p_node = &(*nodes)[this_node->getParent()];
-                    ss << "samplemasktest: " << samplemask.getTestVal(this_node->getXpos(),
-                                                                      this_node->getYpos(),
-                                                                      this_node->getXwrap(),
-                                                                      this_node->getYwrap()) << std::endl;
-                    ss << "samplemask: " << samplemask.getVal(this_node->getXpos(),
-                                                              this_node->getYpos(),
-                                                              this_node->getXwrap(),
-                                                              this_node->getYwrap()) << std::endl;
-                    ss << "parent (tip, exists, generations): " << p_node->isTip() << ", " << p_node->exists() << ", "
-                       << p_node->getGeneration() << std::endl;
-                    ss << "species id zero - i: " << i << " parent: " << p_node->getParent()
-                       << " speciation_probability: " << p_node->getSpecRate() << "has speciated: "
-                       << p_node->hasSpeciated() << std::endl;
+                    auto p_node = (*nodes)[this_node.getParent()];
+                    ss << "samplemasktest: " << samplemask.getTestVal(this_node.getXpos(),
+                                                                      this_node.getYpos(),
+                                                                      this_node.getXwrap(),
+                                                                      this_node.getYwrap()) << std::endl;
+                    ss << "samplemask: " << samplemask.getVal(this_node.getXpos(),
+                                                              this_node.getYpos(),
+                                                              this_node.getXwrap(),
+                                                              this_node.getYwrap()) << std::endl;
+                    ss << "parent (tip, exists, generations): " << p_node.isTip() << ", " << p_node.exists() << ", "
+                       << p_node.getGeneration() << std::endl;
+                    ss << "species id zero - i: " << i << " parent: " << p_node.getParent()
+                       << " speciation_probability: " << p_node.getSpecRate() << "has speciated: "
+                       << p_node.hasSpeciated() << std::endl;
                     writeCritical(ss.str());
                     throw std::runtime_error("Fatal, exiting program.");
                 }
@@ -536,10 +892,7 @@ namespace necsim
 
     void Community::resetTree()
     {
-        for(auto &item: *nodes)
-        {
-            item.qReset();
-        }
+        nodes->qReset();
     }
 
     void Community::openSQLConnection(string input_file)
@@ -567,6 +920,7 @@ namespace necsim
             in_mem = false;
             database->close();
             database->open(input_file);
+            database->setPragmas(spec_sim_parameters->sqlite_pragmas);
         }
         sql_connection_open = true;
     }
@@ -598,6 +952,7 @@ namespace necsim
             if(database->hasOpened())
             {
                 database->open();
+                database->setPragmas(spec_sim_parameters->sqlite_pragmas);
             }
             else
             {
@@ -844,8 +1199,45 @@ namespace necsim
                 throw FatalException(ss.str());
             }
         }
-        unsigned long nspec = calculateCoalescenceTree();
-        calcSpeciesAbundance();
+        unsigned long nspec;
+        if(precalculated_abundances)
+        {
+            species_abundances = precalculated_abundances;
+            precalculated_abundances.reset();
+            const bool has_labels = precalculated_labels != nullptr;
+            if(has_labels)
+            {
+                nodes->swapLabels(*precalculated_labels);
+                precalculated_labels.reset();
+            }
+            nspec = species_abundances->size() - 1;
+            species_index = nspec;
+#ifdef DEBUG
+            auto precalculated_node_labels = nodes->getLabels();
+            auto batch_abundances = species_abundances;
+            if(calculateCoalescenceTree() != nspec)
+            {
+                throw FatalException("Species count differs between sequential and precalculated communities. "
+                                     "Please report this bug.");
+            }
+            calcSpeciesAbundance();
+            if(*batch_abundances != *species_abundances)
+            {
+                throw FatalException("Species abundances differ between sequential and precalculated communities. "
+                                     "Please report this bug.");
+            }
+            if(has_labels && precalculated_node_labels != nodes->getLabels())
+            {
+                throw FatalException("Species IDs differ between sequential and precalculated communities. "
+                                     "Please report this bug.");
+            }
+#endif // DEBUG
+        }
+        else
+        {
+            nspec = calculateCoalescenceTree();
+            calcSpeciesAbundance();
+        }
         std::stringstream ss;
         ss << "\tNumber of species: " << nspec << std::endl;
         writeInfo(ss.str());
@@ -868,34 +1260,18 @@ namespace necsim
                 return;
             }
             //#endif // DEBUG
-            string table_command = "INSERT INTO SPECIES_ABUNDANCES (ID, species_id, "
-                                   "no_individuals, community_reference) VALUES (?,?,?,?);";
-            auto stmt = database->prepare(table_command);
-            // Start the transaction
-            database->beginTransaction();
+            SQLTransaction transaction(*database);
+            SQLBulkInsert insert(*database,
+                                 "SPECIES_ABUNDANCES",
+                                 {"ID", "species_id", "no_individuals", "community_reference"});
             for(unsigned long i = 0; i < species_abundances->size(); i++)
             {
-                // lexical cast fixes a precision problem that allows for printing of very small doubles.
-                sqlite3_bind_int64(stmt->stmt, 1, max_species_id++);
-                sqlite3_bind_int64(stmt->stmt, 2, i);
-                sqlite3_bind_int64(stmt->stmt, 3, species_abundances->operator[](i));
-                sqlite3_bind_int64(stmt->stmt, 4, current_community_parameters->reference);
-                int step = stmt->step();
-                if(step != SQLITE_DONE)
-                {
-                    std::stringstream os;
-                    os << "Could not insert into database. Check destination file has not "
-                          "been moved or deleted and that an entry doesn't already exist with the same ID."
-                       << std::endl;
-                    os << database->getErrorMsg(step);
-                    stmt->clearAndReset();
-                    throw FatalException(os.str());
-                }
-                stmt->clearAndReset();
+                insert.add(max_species_id++).add(i).add(species_abundances->operator[](i));
+                insert.add(current_community_parameters->reference);
+                insert.endRow();
             }
-            // execute the command and close the connection to the database
-            database->endTransaction();
-            database->finalise();
+            insert.flush();
+            transaction.commit();
         }
         else
         {
@@ -944,42 +1320,23 @@ namespace necsim
                                "no_individuals INT NOT NULL, community_reference int NOT NULL);";
         database->execute(table_command);
         getMaxFragmentAbundancesID();
-        table_command = "INSERT INTO FRAGMENT_ABUNDANCES (ID, fragment, area, size, species_id, "
-                        "no_individuals, community_reference) VALUES (?,?,?,?,?,?,?);";
-        auto stmt = database->prepare(table_command);
-        // Start the transaction
-        database->beginTransaction();
+        SQLTransaction transaction(*database);
+        SQLBulkInsert insert(*database,
+                             "FRAGMENT_ABUNDANCES",
+                             {"ID", "fragment", "area", "size", "species_id", "no_individuals",
+                              "community_reference"});
         for(unsigned long i = 0; i < species_abundances->size(); i++)
         {
             auto tmp_row = &species_abundances->operator[](i);
             if(*tmp_row != 0)
             {
-                // fixed precision problem - lexical cast allows for printing of very small doubles.
-                sqlite3_bind_int64(stmt->stmt, 1, max_fragment_id++);
-                sqlite3_bind_text(stmt->stmt, 2, f.name.c_str(), -1, SQLITE_STATIC);
-                sqlite3_bind_double(stmt->stmt, 3, f.area);
-                sqlite3_bind_int64(stmt->stmt, 4, f.num);
-                sqlite3_bind_int64(stmt->stmt, 5, i);
-                sqlite3_bind_int64(stmt->stmt, 6, *tmp_row);
-                sqlite3_bind_int64(stmt->stmt, 7, current_community_parameters->reference);
-                int step = stmt->step();
-                if(step != SQLITE_DONE)
-                {
-                    std::stringstream ss;
-                    ss << "Could not insert into database. Check destination file has not "
-                          "been moved or deleted and that an entry doesn't already exist with the same ID."
-                       << std::endl;
-                    ss << database->getErrorMsg(step) << std::endl;
-                    stmt->clearAndReset();
-                    throw FatalException(ss.str());
-                }
-                stmt->clearAndReset();
+                insert.add(max_fragment_id++).add(f.name).add(f.area).add(f.num).add(i).add(*tmp_row);
+                insert.add(current_community_parameters->reference);
+                insert.endRow();
             }
         }
-        // execute the command and close the connection to the database
-        database->endTransaction();
-        // Need to finalise the statement
-        database->finalise();
+        insert.flush();
+        transaction.commit();
     }
 
     void Community::exportDatabase()
@@ -1053,6 +1410,11 @@ namespace necsim
     void Community::recordSpatial()
     {
         writeInfo("\tRecording species locations...\n");
+        if(spec_sim_parameters->use_columnar_spatial)
+        {
+            recordSpatialColumnar();
+            return;
+        }
         //	os << "Recording spatial data for speciation rate " << current_community_parameters->speciation_rate << "..." << std::flush;
         string table_command = "CREATE TABLE IF NOT EXISTS SPECIES_LOCATIONS (ID int PRIMARY KEY NOT NULL, species_id INT "
                                "NOT NULL, x INT NOT NULL, y INT NOT NULL, community_reference INT NOT NULL);";
@@ -1066,45 +1428,81 @@ namespace necsim
                 return;
             }
         }
-        table_command = "INSERT INTO SPECIES_LOCATIONS (ID,species_id, x, y, community_reference) VALUES (?,?,?,?,?);";
+        SQLTransaction transaction(*database);
+        SQLBulkInsert insert(*database, "SPECIES_LOCATIONS", {"ID", "species_id", "x", "y", "community_reference"});
+        forEachSpeciesLocation([this, &insert](const unsigned long &species_id, const long &x, const long &y)
+                               {
+                                   insert.add(max_locations_id++).add(species_id).add(x).add(y);
+                                   insert.add(current_community_parameters->reference);
+                                   insert.endRow();
+                               });
+        insert.flush();
+        transaction.commit();
+    }
 
-        auto stmt = database->prepare(table_command);
-        database->beginTransaction();
+    string Community::getColumnarTableFileName(const string &table) const
+    {
+        fs::path file_path(spec_sim_parameters->filename);
+        file_path.replace_extension("");
+        return file_path.string() + "_" + table + ".ncol";
+    }
+
+    void Community::recordSpatialColumnar()
+    {
+        const string file_name = getColumnarTableFileName("SPECIES_LOCATIONS");
+        ColumnarTableWriter writer;
+        writer.open(file_name, {"ID", "species_id", "x", "y"});
+        if(writer.hasCommunityReference(current_community_parameters->reference))
+        {
+            std::stringstream ss;
+            ss << "\tSpecies locations for community reference " << current_community_parameters->reference
+               << " already exist in " << file_name << "." << std::endl;
+            writeInfo(ss.str());
+            return;
+        }
+        // IDs continue from the existing rows, starting from 1 as for the SPECIES_LOCATIONS table
+        auto id = static_cast<int64_t>(writer.getRowCount() + 1);
+        const uint64_t reference = current_community_parameters->reference;
+        vector<int64_t> row(4);
+        forEachSpeciesLocation([&](const unsigned long &species_id, const long &x, const long &y)
+                               {
+                                   row[0] = id++;
+                                   row[1] = static_cast<int64_t>(species_id);
+                                   row[2] = x;
+                                   row[3] = y;
+                                   writer.addRow(reference, row);
+                               });
+        writer.close();
+    }
+
+    void Community::forEachSpeciesLocation(const std::function<void(const unsigned long &,
+                                                                    const long &,
+                                                                    const long &)> &record) const
+    {
         // Make sure only the tips which we want to check are recorded
         for(unsigned long i = 1; i < nodes->size(); i++)
         {
-            TreeNode* this_node = &(*nodes)[i];
-            //			os << nodes[i].exists() << std::endl;
-            if(this_node->isTip() && this_node->exists()
-               && doubleCompare(static_cast<double>(this_node->getGeneration()),
+            auto this_node = (*nodes)[i];
+            if(this_node.isTip() && this_node.exists()
+               && doubleCompare(static_cast<double>(this_node.getGeneration()),
                                 static_cast<double>(current_community_parameters->time),
                                 0.0001))
             {
-                if(samplemask.getMaskVal(this_node->getXpos(),
-                                         this_node->getYpos(),
-                                         this_node->getXwrap(),
-                                         this_node->getYwrap()))
+                if(samplemask.getMaskVal(this_node.getXpos(),
+                                         this_node.getYpos(),
+                                         this_node.getXwrap(),
+                                         this_node.getYwrap()))
                 {
-                    long x = this_node->getXpos();
-                    long y = this_node->getYpos();
-                    long xwrap = this_node->getXwrap();
-                    long ywrap = this_node->getYwrap();
+                    long x = this_node.getXpos();
+                    long y = this_node.getYpos();
+                    long xwrap = this_node.getXwrap();
+                    long ywrap = this_node.getYwrap();
                     long xval = x + (xwrap * grid_x_size) + samplemask_x_offset;
                     long yval = y + (ywrap * grid_y_size) + samplemask_y_offset;
-                    sqlite3_bind_int64(stmt->stmt, 1, max_locations_id++);
-                    sqlite3_bind_int64(stmt->stmt, 2, this_node->getSpeciesID());
-                    sqlite3_bind_int64(stmt->stmt, 3, xval);
-                    sqlite3_bind_int64(stmt->stmt, 4, yval);
-                    sqlite3_bind_int64(stmt->stmt, 5, current_community_parameters->reference);
-                    database->step();
-                    stmt->clearAndReset();
+                    record(this_node.getSpeciesID(), xval, yval);
                 }
             }
         }
-        // execute the command and close the connection to the database
-        database->endTransaction();
-        // Need to finalise the statement
-        database->finalise();
     }
 
     void Community::recordSpeciesAges()
@@ -1122,32 +1520,26 @@ namespace necsim
                 return;
             }
         }
-        table_command = "INSERT INTO SPECIES_AGES (ID, species_id, age_generations, community_reference) "
-                        "VALUES (?,?,?,?);";
-
-        auto stmt = database->prepare(table_command);
-        database->beginTransaction();
+        SQLTransaction transaction(*database);
+        SQLBulkInsert insert(*database,
+                             "SPECIES_AGES",
+                             {"ID", "species_id", "age_generations", "community_reference"});
         // Make sure only the tips which we want to check are recorded
         for(unsigned long i = 1; i < nodes->size(); i++)
         {
-            TreeNode* this_node = &(*nodes)[i];
+            auto this_node = (*nodes)[i];
             //			os << nodes[i].exists() << std::endl;
-            if(this_node->hasSpeciated() && this_node->exists() && this_node->getSpeciesID() != 0)
+            if(this_node.hasSpeciated() && this_node.exists() && this_node.getSpeciesID() != 0)
             {
-                long double species_age = this_node->getGeneration() + this_node->getGenerationRate()
+                long double species_age = this_node.getGeneration() + this_node.getGenerationRate()
                                           - current_community_parameters->time;
-                sqlite3_bind_int64(stmt->stmt, 1, max_ages_id++);
-                sqlite3_bind_int64(stmt->stmt, 2, this_node->getSpeciesID());
-                sqlite3_bind_double(stmt->stmt, 3, static_cast<double>(species_age));
-                sqlite3_bind_int64(stmt->stmt, 4, current_community_parameters->reference);
-                database->step();
-                stmt->clearAndReset();
+                insert.add(max_ages_id++).add(this_node.getSpeciesID()).add(static_cast<double>(species_age));
+                insert.add(current_community_parameters->reference);
+                insert.endRow();
             }
         }
-        // execute the command and close the connection to the database
-        database->endTransaction();
-        // Need to finalise the statement
-        database->finalise();
+        insert.flush();
+        transaction.commit();
     }
 
     void Community::calcFragments(string fragment_file)
@@ -1431,20 +1823,20 @@ namespace necsim
             unsigned long iSpecCount = 0;
             for(unsigned long j = 0; j < nodes->size(); j++)
             {
-                TreeNode* this_node = &(*nodes)[j];
-                if(this_node->isTip() && samplemask.getMaskVal(this_node->getXpos(),
-                                                               this_node->getYpos(),
-                                                               this_node->getXwrap(),
-                                                               this_node->getYwrap())
-                   && doubleCompare(this_node->getGeneration(), current_community_parameters->time, 0.0001))
+                auto this_node = (*nodes)[j];
+                if(this_node.isTip() && samplemask.getMaskVal(this_node.getXpos(),
+                                                              this_node.getYpos(),
+                                                              this_node.getXwrap(),
+                                                              this_node.getYwrap())
+                   && doubleCompare(this_node.getGeneration(), current_community_parameters->time, 0.0001))
                 {
                     // if they exist exactly in the generation of interest.
-                    this_node->setExistence(true);
+                    this_node.setExistence(true);
                     iSpecCount++;
                 }
-                else if(this_node->isTip())
+                else if(this_node.isTip())
                 {
-                    this_node->setExistence(false);
+                    this_node.setExistence(false);
                 }
             }
             fragments[i].num = iSpecCount;
@@ -2085,35 +2477,41 @@ namespace necsim
         for(const auto &protracted_params : spec_sim_parameters->protracted_parameters)
         {
             setProtractedParameters(protracted_params);
+            // Calculate the species abundances for all speciation rates at each time together, if possible.
+            std::map<long double, vector<shared_ptr<vector<unsigned long>>>> time_abundances;
+            vector<long double> speciation_rates;
+            if(canCalculateMultipleRates())
+            {
+                for(const auto &sr : spec_sim_parameters->all_speciation_rates)
+                {
+                    if(sr >= min_spec_rate)
+                    {
+                        speciation_rates.push_back(sr);
+                    }
+                }
+                if(speciation_rates.size() > 1)
+                {
+                    writeInfo("Calculating species abundances for " + std::to_string(speciation_rates.size())
+                              + " speciation rates...\n");
+                    for(auto time : spec_sim_parameters->all_times)
+                    {
+                        time_abundances[time] = calculateMultipleRateAbundances(speciation_rates, time);
+                    }
+                }
+            }
+            // Find the communities which have not already been calculated.
+            vector<std::pair<double, double>> calculations;
             for(const auto &sr : spec_sim_parameters->all_speciation_rates)
             {
                 for(auto time : spec_sim_parameters->all_times)
                 {
-                    resetTree();
                     if(!checkCalculationsPerformed(sr,
                                                    time,
                                                    spec_sim_parameters->use_fragments,
                                                    *current_metacommunity_parameters,
                                                    applied_protracted_parameters))
                     {
-                        addCalculationPerformed(sr,
-                                                time,
-                                                spec_sim_parameters->use_fragments,
-                                                *current_metacommunity_parameters,
-                                                applied_protracted_parameters);
-                        createDatabase();
-                        if(spec_sim_parameters->use_spatial)
-                        {
-                            recordSpatial();
-                        }
-                        if(spec_sim_parameters->record_ages)
-                        {
-                            recordSpeciesAges();
-                        }
-                        if(spec_sim_parameters->use_fragments)
-                        {
-                            applyFragments();
-                        }
+                        calculations.emplace_back(sr, time);
                     }
                     else
                     {
@@ -2125,6 +2523,82 @@ namespace necsim
                     }
                 }
             }
+            // Communities are calculated in batches of one per thread, then written out in order so that the output
+            // is identical to calculating each community in turn.
+            const unsigned long num_threads = canCalculateInParallel() ? spec_sim_parameters->num_threads : 1;
+            if(num_threads > 1)
+            {
+                writeInfo("Calculating communities using " + std::to_string(num_threads) + " threads.\n");
+            }
+            for(unsigned long batch_start = 0; batch_start < calculations.size(); batch_start += num_threads)
+            {
+                const unsigned long batch_end = std::min(batch_start + num_threads,
+                                                         static_cast<unsigned long>(calculations.size()));
+                vector<shared_ptr<vector<unsigned long>>> batch_abundances(batch_end - batch_start);
+                vector<shared_ptr<TreeNodeStore::Labels>> batch_labels(batch_end - batch_start);
+                vector<std::pair<double, double>> parallel_calculations;
+                vector<unsigned long> parallel_indices;
+                for(unsigned long i = batch_start; i < batch_end; i++)
+                {
+                    const double &sr = calculations[i].first;
+                    const double &time = calculations[i].second;
+                    auto time_it = time_abundances.find(time);
+                    if(time_it != time_abundances.end() && !time_it->second.empty())
+                    {
+                        auto rate_it = std::find(speciation_rates.begin(), speciation_rates.end(), sr);
+                        if(rate_it != speciation_rates.end())
+                        {
+                            batch_abundances[i - batch_start] = time_it->second[rate_it - speciation_rates.begin()];
+                            continue;
+                        }
+                    }
+                    if(num_threads > 1 && sr >= min_spec_rate)
+                    {
+                        parallel_calculations.emplace_back(sr, time);
+                        parallel_indices.push_back(i - batch_start);
+                    }
+                }
+                if(parallel_calculations.size() > 1)
+                {
+                    vector<shared_ptr<TreeNodeStore::Labels>> parallel_labels;
+                    vector<shared_ptr<vector<unsigned long>>> parallel_abundances;
+                    calculateLabelsInParallel(parallel_calculations, parallel_labels, parallel_abundances);
+                    for(unsigned long j = 0; j < parallel_indices.size(); j++)
+                    {
+                        batch_labels[parallel_indices[j]] = parallel_labels[j];
+                        batch_abundances[parallel_indices[j]] = parallel_abundances[j];
+                    }
+                }
+                for(unsigned long i = batch_start; i < batch_end; i++)
+                {
+                    const double &sr = calculations[i].first;
+                    const double &time = calculations[i].second;
+                    resetTree();
+                    addCalculationPerformed(sr,
+                                            time,
+                                            spec_sim_parameters->use_fragments,
+                                            *current_metacommunity_parameters,
+                                            applied_protracted_parameters);
+                    precalculated_abundances = batch_abundances[i - batch_start];
+                    precalculated_labels = batch_labels[i - batch_start];
+                    // All tables for this community reference are written in a single transaction
+                    SQLTransaction transaction(*database);
+                    createDatabase();
+                    if(spec_sim_parameters->use_spatial)
+                    {
+                        recordSpatial();
+                    }
+                    if(spec_sim_parameters->record_ages)
+                    {
+                        recordSpeciesAges();
+                    }
+                    if(spec_sim_parameters->use_fragments)
+                    {
+                        applyFragments();
+                    }
+                    transaction.commit();
+                }
+            }
         }
     }
 
@@ -2160,28 +2634,28 @@ namespace necsim
 
     void Community::applyNoOutput(shared_ptr<SpecSimParameters> sp)
     {
-        shared_ptr<vector<TreeNode>> tree_data = make_shared<vector<TreeNode>>();
+        shared_ptr<TreeNodeStore> tree_data = make_shared<TreeNodeStore>();
         applyNoOutput(sp, tree_data);
     }
 
-    void Community::applyNoOutput(shared_ptr<SpecSimParameters> sp, shared_ptr<vector<TreeNode>> tree_data)
+    void Community::applyNoOutput(shared_ptr<SpecSimParameters> sp, shared_ptr<TreeNodeStore> tree_data)
     {
         doApplication(std::move(sp), std::move(tree_data));
     }
 
     void Community::doApplication(shared_ptr<SpecSimParameters> sp)
     {
-        shared_ptr<vector<TreeNode>> data = make_shared<vector<TreeNode>>();
+        shared_ptr<TreeNodeStore> data = make_shared<TreeNodeStore>();
         doApplication(std::move(sp), data);
     }
 
-    void Community::doApplication(shared_ptr<SpecSimParameters> sp, shared_ptr<vector<TreeNode>> data)
+    void Community::doApplication(shared_ptr<SpecSimParameters> sp, shared_ptr<TreeNodeStore> data)
     {
         setupApplication(sp, data);
         calculateTree();
     }
 
-    void Community::doApplicationInternal(shared_ptr<SpecSimParameters> sp, shared_ptr<vector<TreeNode>> data)
+    void Community::doApplicationInternal(shared_ptr<SpecSimParameters> sp, shared_ptr<TreeNodeStore> data)
     {
         setInternalDatabase();
         doApplication(std::move(sp), std::move(data));
@@ -2197,11 +2671,11 @@ namespace necsim
         (*nodes)[0] = TreeNode();
         for(unsigned long i = 1; i < nodes->size(); i++)
         {
-            TreeNode* this_node = &(*nodes)[i];
-            if(this_node->getParent() == 0
-               && !checkSpeciation(this_node->getSpecRate(), min_spec_rate, this_node->getGenerationRate()))
+            auto this_node = (*nodes)[i];
+            if(this_node.getParent() == 0
+               && !checkSpeciation(this_node.getSpecRate(), min_spec_rate, this_node.getGenerationRate()))
             {
-                this_node->setSpec(0.0);
+                this_node.setSpec(0.0);
             }
         }
         deleteSpeciesList();
@@ -2225,9 +2699,9 @@ namespace necsim
 //
 //        for(unsigned long i = 1; i < nodes->size(); i++)
 //        {
-//            TreeNode* this_node = &(*nodes)[i];
-//            if(this_node->getParent() == 0
-//               && !checkSpeciation(this_node->getSpecRate(), min_spec_rate, this_node->getGenerationRate()))
+//            auto this_node = (*nodes)[i];
+//            if(this_node.getParent() == 0
+//               && !checkSpeciation(this_node.getSpecRate(), min_spec_rate, this_node.getGenerationRate()))
 //            {
 //                activeNodes.push_back(this_node);
 //            }
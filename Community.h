@@ -19,6 +19,7 @@
 #include <set>
 #include <utility>
 #include <memory>
+#include <functional>
 
 #ifdef WIN_INSTALL
 #define NOMINMAX
@@ -26,12 +27,13 @@
 //#define sleep Sleep
 #endif
 
-#include "TreeNode.h"
+#include "TreeNodeStore.h"
 #include "Matrix.h"
 #include "DataMask.h"
 #include "parameters.h"
 #include "SpecSimParameters.h"
 #include "SQLiteHandler.h"
+#include "ColumnarTable.h"
 
 
 using std::string;
@@ -108,7 +110,7 @@ namespace necsim
     //	 * @param ywrap the y wrapping
          * @return the value at x,y.
          */
-        bool getMaskVal(unsigned long x1, unsigned long y1, long x_wrap, long y_wrap);
+        bool getMaskVal(unsigned long x1, unsigned long y1, long x_wrap, long y_wrap) const;
 
         /**
          * @brief Set the fragment for the samplemask to some calculated fragment.
@@ -137,7 +139,7 @@ namespace necsim
         bool database_set{}; // boolean for whether the database has been set already.
         shared_ptr<SQLiteHandler> database{}; // stores the in-memory database connection.
         bool sql_connection_open{}; // true if the data connection has been established.
-        shared_ptr<vector<TreeNode>> nodes{}; // in older versions this was called lineage_indices.
+        shared_ptr<TreeNodeStore> nodes{}; // in older versions this was called lineage_indices.
         shared_ptr<vector<unsigned long>> species_abundances{};
         unsigned long species_index{};
         bool has_imported_samplemask{}; // checks whether the samplemask has already been imported.
@@ -163,13 +165,17 @@ namespace necsim
         unsigned long max_species_id{}, max_fragment_id{}, max_locations_id{}, max_ages_id{};
         // Does not need to be stored during simulation pause
         shared_ptr<SpecSimParameters> spec_sim_parameters{};
+        // Species abundances and node labels for the current community, if already calculated (for multiple speciation
+        // rates at once, or on a worker thread). The labels are not required if only species abundances are recorded.
+        shared_ptr<vector<unsigned long>> precalculated_abundances{};
+        shared_ptr<TreeNodeStore::Labels> precalculated_labels{};
     public:
 
         /**
          * @brief Contructor for the community linking to Treenode list.
          * @param r Row of TreeNode objects to link to.
          */
-        explicit Community(shared_ptr<vector<TreeNode>> r) : in_mem(false), database_set(false),
+        explicit Community(shared_ptr<TreeNodeStore> r) : in_mem(false), database_set(false),
                                                              database(make_shared<SQLiteHandler>()),
                                                              sql_connection_open(false), nodes(std::move(r)),
                                                              species_abundances(make_shared<vector<unsigned long>>()),
@@ -184,7 +190,8 @@ namespace necsim
                                                              protracted(false), minimum_protracted_parameters(),
                                                              applied_protracted_parameters(), max_species_id(0),
                                                              max_fragment_id(0), max_locations_id(0), max_ages_id(0),
-                                                             spec_sim_parameters(make_shared<SpecSimParameters>())
+                                                             spec_sim_parameters(make_shared<SpecSimParameters>()),
+                                                             precalculated_abundances(), precalculated_labels()
         {
 
         }
@@ -192,7 +199,7 @@ namespace necsim
         /**
          * @brief Default constructor
          */
-        Community() : Community(make_shared<vector<TreeNode>>())
+        Community() : Community(make_shared<TreeNodeStore>())
         {
         }
 
@@ -248,6 +255,8 @@ namespace necsim
                 std::swap(max_fragment_id, other.max_fragment_id);
                 std::swap(max_locations_id, other.max_locations_id);
                 std::swap(spec_sim_parameters, other.spec_sim_parameters);
+                std::swap(precalculated_abundances, other.precalculated_abundances);
+                std::swap(precalculated_labels, other.precalculated_labels);
             }
         }
 
@@ -255,7 +264,7 @@ namespace necsim
          * @brief Set the nodes object to the input Row of Treenode objects.
          * @param l the Row of Treenode objects to link to.
          */
-        void setList(shared_ptr<vector<TreeNode>> l);
+        void setList(shared_ptr<TreeNodeStore> l);
 
         /**
          * @brief Sets up the community from a set of simulation parameters and the sqlite3 database connection.
@@ -312,6 +321,141 @@ namespace necsim
          */
         unsigned long calculateCoalescenceTree();
 
+        /**
+         * @brief Checks if the lineage is a tip which exists within the sample mask at the given time.
+         * @param this_node the lineage to check
+         * @param time the time of the community
+         * @return true if the lineage is an existing tip
+         */
+        bool isExistingTip(ConstTreeNodeReference this_node, const long double &time) const;
+
+        /**
+         * @brief Checks if the lineage speciates at the given speciation rate, including the protracted speciation
+         * parameters.
+         * @param this_node the lineage to check
+         * @param speciation_rate the speciation rate to apply
+         * @return true if the lineage speciates
+         */
+        bool checkNodeSpeciation(ConstTreeNodeReference this_node, const long double &speciation_rate) const;
+
+        /**
+         * @brief Checks if the species abundances for the speciation rates can be calculated together, using
+         * calculateMultipleRateAbundances().
+         *
+         * This is only possible if species abundances are the only output required.
+         * @return true if multiple speciation rates can be calculated together
+         */
+        virtual bool canCalculateMultipleRates() const;
+
+        /**
+         * @brief Calculates the species abundances for many speciation rates in a small number of passes over the
+         * coalescence tree.
+         *
+         * The lowest speciation rate at which each lineage speciates is found first. Then, working down from the
+         * highest speciation rate, each lineage is merged into the species of its parent once the rate drops below
+         * that value.
+         * The species abundances match those from calculateCoalescenceTree() and calcSpeciesAbundance() for each rate.
+         * @param speciation_rates the speciation rates to apply, in ascending order
+         * @param time the time of the community
+         * @return the species abundances for each speciation rate, or an empty vector if the rates cannot be calculated
+         * together for this coalescence tree
+         */
+        vector<shared_ptr<vector<unsigned long>>>
+        calculateMultipleRateAbundances(const vector<long double> &speciation_rates, const long double &time);
+
+        /**
+         * @brief Checks if communities can be calculated on multiple threads, using calculateLabels().
+         * @return true if more than one thread has been requested and the coalescence tree is topologically ordered
+         */
+        virtual bool canCalculateInParallel() const;
+
+        /**
+         * @brief Calculates the existence, speciation and species ID of every lineage, and the species abundances, for
+         * a single speciation rate and time, without modifying the coalescence tree.
+         *
+         * This is equivalent to calculateCoalescenceTree() followed by calcSpeciesAbundance() and can be called on
+         * many threads at once. The coalescence tree must be topologically ordered.
+         * @param speciation_rate the speciation rate to apply
+         * @param time the time of the community
+         * @param labels the labels to store the existence, speciation and species IDs in
+         * @return the species abundances, or a null pointer if the coalescence tree requires correction and must be
+         * calculated by calculateCoalescenceTree() instead
+         */
+        shared_ptr<vector<unsigned long>> calculateLabels(const long double &speciation_rate, const long double &time,
+                                                          TreeNodeStore::Labels &labels) const;
+
+        /**
+         * @brief Calculates the labels and species abundances for each of the communities using a separate thread for
+         * each community.
+         * @param calculations the speciation rate and time of each community
+         * @param labels the labels for each community, set to a null pointer if they could not be calculated
+         * @param abundances the species abundances for each community, set to a null pointer if they could not be
+         * calculated
+         */
+        void calculateLabelsInParallel(const vector<std::pair<double, double>> &calculations,
+                                       vector<shared_ptr<TreeNodeStore::Labels>> &labels,
+                                       vector<shared_ptr<vector<unsigned long>>> &abundances) const;
+
+        /**
+         * @brief Checks that every parent on the coalescence tree has a higher index than its children.
+         *
+         * This is always the case for trees generated by simulations, as parents are added to the tree as lineages
+         * coalesce.
+         * @return true if the tree is topologically ordered
+         */
+        bool isTopologicallyOrdered() const;
+
+        /**
+         * @brief Gets a description of the lineage, for reporting errors.
+         * @param index the index of the lineage in nodes
+         * @return the description of the lineage
+         */
+        string getLineageDescription(const unsigned long &index) const;
+
+        /**
+         * @brief Propagates existence from each existing, non-speciated lineage to its parent in a single sweep.
+         *
+         * Requires the coalescence tree to be topologically ordered.
+         */
+        void calculateExistence();
+
+        /**
+         * @brief Propagates existence from each existing, non-speciated lineage to its parent, repeatedly looping over
+         * the tree until no changes occur.
+         *
+         * Works for any ordering of the coalescence tree.
+         */
+        void calculateExistenceIteratively();
+
+        /**
+         * @brief Assigns each existing lineage the species ID of its parent in a single backwards sweep.
+         *
+         * Requires the coalescence tree to be topologically ordered.
+         */
+        void assignSpeciesIDs();
+
+        /**
+         * @brief Assigns each existing lineage the species ID of its parent, repeatedly looping over the tree until no
+         * changes occur.
+         *
+         * Works for any ordering of the coalescence tree.
+         */
+        void assignSpeciesIDsIteratively();
+
+#ifdef DEBUG
+
+        /**
+         * @brief Checks that the iterative existence calculation agrees with the single-pass calculation.
+         */
+        void checkExistence();
+
+        /**
+         * @brief Checks that the iterative species ID assignment agrees with the single-pass assignment.
+         */
+        void checkSpeciesIDs();
+
+#endif // DEBUG
+
         /**
          * @brief Speciates TreeNode and updates the species count.
          *
@@ -319,10 +463,10 @@ namespace necsim
          *
          * @note species_list is not updated in unless the function is overridden for metacommunity application.
          * @param species_count the total number of species currently in the community
-         * @param treenode pointer to the TreeNode object for this lineage
+         * @param treenode reference to the node for this lineage
          * @param species_list the set of all species ids.
          */
-        virtual void addSpecies(unsigned long &species_count, TreeNode* treenode, std::set<unsigned long> &species_list);
+        virtual void addSpecies(unsigned long &species_count, TreeNodeReference treenode, std::set<unsigned long> &species_list);
 
         /**
          * @brief Calculates the species abundance of the dataset.
@@ -587,6 +731,31 @@ namespace necsim
          */
         void recordSpatial();
 
+        /**
+         * @brief Gets the path to the columnar table file for the given table, which is stored alongside the output
+         * database.
+         * @param table the name of the table
+         * @return the path to the columnar table file
+         */
+        string getColumnarTableFileName(const string &table) const;
+
+        /**
+         * @brief Records the full spatial data to a columnar table file, instead of the SPECIES_LOCATIONS table.
+         *
+         * The file has the columns ID, species_id, x and y, with the rows indexed by community reference. Rows are
+         * written directly to the file, rather than as part of the database transaction.
+         */
+        void recordSpatialColumnar();
+
+        /**
+         * @brief Calls the function with the species ID and location of every individual in the sample at the current
+         * time.
+         * @param record the function to call with the species ID, x and y location of each individual
+         */
+        void forEachSpeciesLocation(const std::function<void(const unsigned long &,
+                                                             const long &,
+                                                             const long &)> &record) const;
+
 
         /**
          * @brief Records the age of each species, based on the speciation event in the coalescence tree and the sample
@@ -694,14 +863,14 @@ namespace necsim
          * @param sp speciation parameters to apply, including speciation rate, times and spatial sampling procedure
          * @param tree_data the coalescence tree containing simulation data
          */
-        virtual void applyNoOutput(shared_ptr<SpecSimParameters> sp, shared_ptr<vector<TreeNode>> tree_data);
+        virtual void applyNoOutput(shared_ptr<SpecSimParameters> sp, shared_ptr<TreeNodeStore> tree_data);
 
         /**
          * @brief Sets up the community application by reading parameters and data.
          * @param sp the speciation parameters to use for generating the community
          * @param data the list of all nodes on the coalescence tree
          */
-        void setupApplication(shared_ptr<SpecSimParameters> sp, shared_ptr<vector<TreeNode>> data)
+        void setupApplication(shared_ptr<SpecSimParameters> sp, shared_ptr<TreeNodeStore> data)
         {
             spec_sim_parameters = sp;
             writeSpeciationRates();
@@ -741,7 +910,7 @@ namespace necsim
          * @param sp speciation parameters to apply, including speciation rate, times and spatial sampling procedure
          * @param data the Row of TreeNodes that contains the coalescence tree.
          */
-        void doApplication(shared_ptr<SpecSimParameters> sp, shared_ptr<vector<TreeNode>> data);
+        void doApplication(shared_ptr<SpecSimParameters> sp, shared_ptr<TreeNodeStore> data);
 
         /**
          * @brief Creates the coalescence tree for the given speciation parameters, using internal file referencing
@@ -749,7 +918,7 @@ namespace necsim
          * @param sp speciation parameters to apply, including speciation rate, times and spatial sampling procedure
          * @param data the Row of TreeNodes that contains the coalescence tree.
          */
-        void doApplicationInternal(shared_ptr<SpecSimParameters> sp, shared_ptr<vector<TreeNode>> data);
+        void doApplicationInternal(shared_ptr<SpecSimParameters> sp, shared_ptr<TreeNodeStore> data);
 
         /**
          * @brief Speciates the remaining lineages in an incomplete simulation to force it to appear complete.
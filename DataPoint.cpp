@@ -21,10 +21,8 @@ namespace necsim
         this->y = y;
         xwrap = xwrap_in;
         ywrap = ywrap_in;
-        next_lineage = 0;
         reference = reference_in;
         list_position = list_position_in;
-        nwrap = 0;
         min_max = min_max_in;
     }
 
@@ -39,11 +37,9 @@ namespace necsim
         y = datin.getYpos();
         xwrap = datin.getXwrap();
         ywrap = datin.getYwrap();
-        next_lineage = datin.getNext();
         //		last = datin.get_last(); // removed as of version 3.1
         reference = datin.getReference();
         list_position = datin.getListpos();
-        nwrap = datin.getNwrap();
         min_max = datin.getMinmax();
     }
 
@@ -52,21 +48,11 @@ namespace necsim
         reference = z;
     }
 
-    void DataPoint::setNext(unsigned long x)
-    {
-        next_lineage = x;
-    }
-
     void DataPoint::setListPosition(unsigned long l)
     {
         list_position = l;
     }
 
-    void DataPoint::setNwrap(unsigned long n)
-    {
-        nwrap = n;
-    }
-
     void DataPoint::setMinmax(double d)
     {
         min_max = d;
@@ -97,43 +83,21 @@ namespace necsim
         return reference;
     }
 
-    unsigned long DataPoint::getNext() const
-    {
-        return next_lineage;
-    }
-
     unsigned long DataPoint::getListpos() const
     {
         return list_position;
     }
 
-    unsigned long DataPoint::getNwrap() const
-    {
-        return nwrap;
-    }
-
     double DataPoint::getMinmax() const
     {
         return min_max;
     }
 
-    void DataPoint::decreaseNwrap()
-    {
-        if(nwrap == 0)
-        {
-            throw std::out_of_range("ERROR_DATA_001: Trying to decrease  nwrap less than 0.");
-        }
-        else
-        {
-            nwrap--;
-        }
-    }
-
-
     std::ostream &operator<<(std::ostream &os, const DataPoint &d)
     {
-        os << d.x << "," << d.y << "," << d.xwrap << "," << d.ywrap << "," << d.next_lineage << "," << d.reference
-           << "," << d.list_position << "," << d.nwrap << ",";
+        // The zeros are in place of the linked list of wrapped lineages used by older versions.
+        os << d.x << "," << d.y << "," << d.xwrap << "," << d.ywrap << "," << 0 << "," << d.reference
+           << "," << d.list_position << "," << 0 << ",";
         os << d.min_max << "\n";
         return os;
     }
@@ -141,8 +105,9 @@ namespace necsim
     std::istream &operator>>(std::istream &is, DataPoint &d)
     {
         char delim;
-        is >> d.x >> delim >> d.y >> delim >> d.xwrap >> delim >> d.ywrap >> delim >> d.next_lineage >> delim
-           >> d.reference >> delim >> d.list_position >> delim >> d.nwrap >> delim;
+        unsigned long unused_next, unused_nwrap;
+        is >> d.x >> delim >> d.y >> delim >> d.xwrap >> delim >> d.ywrap >> delim >> unused_next >> delim
+           >> d.reference >> delim >> d.list_position >> delim >> unused_nwrap >> delim;
         is >> d.min_max;
         return is;
     }
@@ -152,10 +117,8 @@ namespace necsim
     {
         writeLog(50, "x, y, (x wrap, y wrap): " + std::to_string(x) + ", " + std::to_string(y) + ", (" +
                      std::to_string(xwrap) + ", " + std::to_string(ywrap) + ")");
-        writeLog(50, "Lineage next: " + std::to_string(next_lineage));
         writeLog(50, "Reference: " + std::to_string(reference));
         writeLog(50, "List position: " + std::to_string(list_position));
-        writeLog(50, "Number in wrapped lineages: " + std::to_string(nwrap));
         writeLog(50, "Minimum maximum: " + std::to_string(min_max));
     }
 #endif // DEBUG
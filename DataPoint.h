@@ -28,14 +28,10 @@ namespace necsim
     {
 
     private:
-        // the next individual in the loop of those that have the same xypos
-        unsigned long next_lineage;
         // points to the position in the coalescence tree
         unsigned long reference;
-        // points to the position in the SpeciesList file.
+        // points to the position in the SpeciesList file, or in the wrapped lineages at the location if off the grid.
         unsigned long list_position;
-        // the reference number within the linked lineage_indices of wrapped lineages
-        unsigned long nwrap;
         // the max-min number
         double min_max;
     public:
@@ -43,7 +39,7 @@ namespace necsim
         /**
          * @brief Standard constructor
          */
-        DataPoint() : next_lineage(0), reference(0), list_position(0), nwrap(0), min_max(0)
+        DataPoint() : reference(0), list_position(0), min_max(0)
         {
 
         }
@@ -55,7 +51,6 @@ namespace necsim
 
         /**
          * @brief Setup of lineage data with any information that's wanted.
-         * Note that nwrap is set to 0 in this routine.
          * @param x the x position on the grid
          * @param y the y position on the grid
          * @param xwrap_in the number of wraps of the location on the grid in the x direction
@@ -88,24 +83,11 @@ namespace necsim
         void setReference(unsigned long z);
 
         /**
-         * @brief Set the next link in the linked list.
-         * @param x the next Datapoint object.
-         */
-        void setNext(unsigned long x);
-
-        /**
-         * @brief Sets the list position within the SpeciesList object.
+         * @brief Sets the list position within the SpeciesList object, or within the wrapped lineages at the location.
          * @param l the input list position.
          */
         void setListPosition(unsigned long l);
 
-        /**
-         * @brief Sets the number of wraps from the first SpeciesList wrapped lineage.
-         * If and only if this is 0, the lineage is within the main grid (i.e xwrap and ywrap should be 0).
-         * @param n the desired nwrap.
-         */
-        void setNwrap(unsigned long n);
-
         /**
          * @brief Sets the minmax variable.
          * This is the minimum maximum speciation rate required for speciation to have occured on this branch.
@@ -144,35 +126,18 @@ namespace necsim
         unsigned long getReference() const;
 
         /**
-         * @brief Gets the next element linked to this DataPoint
-         * @return the reference of the next individual in the linked list
-         */
-        unsigned long getNext() const;
-
-        /**
-         * @brief Gets the list position with the SpeciesList object at the relevant x,y position.
+         * @brief Gets the list position with the SpeciesList object at the relevant x,y position, or within the wrapped
+         * lineages at the location.
          * @return the listpos.
          */
         unsigned long getListpos() const;
 
-        /**
-         * @brief Get the position in the linked list from the SpeciesList object.
-         * If this is 0, indicates the lineage lies on the original grid, and xwrap and ywrap should be 0.
-         * @return the nwrap.
-         */
-        unsigned long getNwrap() const;
-
         /**
          * @brief Get the maximum minimum speciation rate required for speciation to have occured on this branch.
          * @return the minmax.
          */
         double getMinmax() const;
 
-        /**
-         * @brief Decreases the nwrap by 1 (to a minimum of 0).
-         */
-        void decreaseNwrap();
-
         /**
          * @brief Sets the position in space.
          * @param location the location of the new end point
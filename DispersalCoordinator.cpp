@@ -119,76 +119,72 @@ namespace necsim
             throw FatalException(msg);
         }
         infile.close();
-        dispersal_prob_map.setSize(dispersal_dim, dispersal_dim);
-        dispersal_prob_map.import(dispersal_file);
-        if(landscape->hasHistorical())
-        {
-            setRawDispersalMap();
-        }
+        dispersal_prob_map.import(dispersal_file, dispersal_dim);
         *generation = 0.0;
-        addDensity();
-        addReproduction();
         fixDispersal();
-        dispersal_prob_map.close();
         verifyDispersalMapSetup();
     }
 
-    void DispersalCoordinator::setRawDispersalMap()
-    {
-        raw_dispersal_prob_map = dispersal_prob_map;
-    }
-
-    void DispersalCoordinator::addDensity()
+    void DispersalCoordinator::addDensity(vector<double> &density)
     {
+        density.assign(dispersal_prob_map.getCols(), 0.0);
         for(unsigned long i = 0; i < ydim; i++)
         {
             for(unsigned long j = 0; j < xdim; j++)
             {
                 unsigned long index = j + i * xdim;
-                for(unsigned long k = 0; k < dispersal_prob_map.getRows(); k++)
+                if(index < density.size())
                 {
-                    auto density = landscape->getValFine(j, i, *generation);
-                    if(dispersal_prob_map.get(k, index) > 0.0 && density == 0)
-                    {
-                        Step origin_step;
-                        calculateCellCoordinates(origin_step, k);
-                        std::stringstream ss;
-                        Step destination_step;
-                        calculateCellCoordinates(destination_step, j + (i * xdim));
-                        ss << "Dispersal from " << origin_step.x << ", " << origin_step.y << " (";
-                        ss << origin_step.xwrap << ", " << origin_step.ywrap << ") to ";
-                        ss << destination_step.x << ", " << destination_step.y << " (" << destination_step.xwrap;
-                        ss << ", " << destination_step.ywrap << ")" << std::endl;
-                        ss << "Source row: " << k << " destination row: " << index << std::endl;
-                        ss << "Dispersal map value: " << dispersal_prob_map.get(k, index) << std::endl;
-                        ss << "Origin density: "
-                           << landscape->getVal(origin_step.x, origin_step.y, origin_step.xwrap, origin_step.ywrap, 0.0)
-                           << std::endl;
-                        ss << "Destination density: " << landscape->getValFine(j, i, *generation) << std::endl;
-                        writeError(ss.str());
-                        throw FatalException("Dispersal map is non zero where density is 0.");
-                    }
-                    dispersal_prob_map.get(k, index) *= density;
+                    density[index] = landscape->getValFine(j, i, *generation);
+                }
+            }
+        }
+        for(unsigned long k = 0; k < dispersal_prob_map.getRows(); k++)
+        {
+            for(unsigned long entry = dispersal_prob_map.rowBegin(k); entry < dispersal_prob_map.rowEnd(k); entry++)
+            {
+                const unsigned long index = dispersal_prob_map.getColumn(entry);
+                if(dispersal_prob_map.getRawValue(entry) > 0.0 && density[index] == 0
+                   && dispersal_prob_map.isIncluded(k, entry))
+                {
+                    Step origin_step;
+                    calculateCellCoordinates(origin_step, k);
+                    std::stringstream ss;
+                    Step destination_step;
+                    calculateCellCoordinates(destination_step, index);
+                    ss << "Dispersal from " << origin_step.x << ", " << origin_step.y << " (";
+                    ss << origin_step.xwrap << ", " << origin_step.ywrap << ") to ";
+                    ss << destination_step.x << ", " << destination_step.y << " (" << destination_step.xwrap;
+                    ss << ", " << destination_step.ywrap << ")" << std::endl;
+                    ss << "Source row: " << k << " destination row: " << index << std::endl;
+                    ss << "Dispersal map value: " << dispersal_prob_map.getRawValue(entry) << std::endl;
+                    ss << "Origin density: "
+                       << landscape->getVal(origin_step.x, origin_step.y, origin_step.xwrap, origin_step.ywrap, 0.0)
+                       << std::endl;
+                    ss << "Destination density: " << density[index] << std::endl;
+                    writeError(ss.str());
+                    throw FatalException("Dispersal map is non zero where density is 0.");
                 }
             }
         }
     }
 
-    void DispersalCoordinator::addReproduction()
+    void DispersalCoordinator::addReproduction(vector<double> &reproduction)
     {
+        reproduction.clear();
         if(reproduction_map != nullptr)
         {
             if(!reproduction_map->isNull())
             {
+                reproduction.assign(dispersal_prob_map.getCols(), 0.0);
                 for(unsigned long i = 0; i < ydim; i++)
                 {
                     for(unsigned long j = 0; j < xdim; j++)
                     {
                         unsigned long index = j + i * xdim;
-                        for(unsigned long k = 0; k < dispersal_prob_map.getRows(); k++)
+                        if(index < reproduction.size())
                         {
-
-                            dispersal_prob_map.get(k, index) *= reproduction_map->get(i, j);
+                            reproduction[index] = reproduction_map->get(i, j);
                         }
                     }
                 }
@@ -198,55 +194,29 @@ namespace necsim
 
     void DispersalCoordinator::fixDispersal()
     {
-        for(unsigned long row = 0; row < dispersal_prob_map.getRows(); row++)
-        {
-            fixDispersalRow(row);
-        }
-    }
-
-    void DispersalCoordinator::fixDispersalRow(unsigned long row)
-    {
-        // check if the row needs to be fixed
-        if(checkDispersalRow(row))
-        {
-            double total_value = 0.0;
-            for(unsigned long i = 0; i < dispersal_prob_map.getCols(); i++)
-            {
-                total_value += dispersal_prob_map.get(row, i);
-            }
-            if(total_value == 0.0)
-            {
-                return;
-            }
-            dispersal_prob_map.get(row, 0) = dispersal_prob_map.get(row, 0) / total_value;
-            for(unsigned long i = 1; i < dispersal_prob_map.getCols(); i++)
-            {
-                dispersal_prob_map.get(row, i) =
-                        dispersal_prob_map.get(row, i - 1) + (dispersal_prob_map.get(row, i) / total_value);
-            }
+        vector<double> density;
+        vector<double> reproduction;
+        addDensity(density);
+        addReproduction(reproduction);
+        dispersal_prob_map.calculateCumulative(density, reproduction);
 #ifdef DEBUG
-            if(checkDispersalRow(row))
-            {
-                throw FatalException("Dispersal probability map not correctly fixed to sum to 1.0.");
-            }
-#endif // DEBUG
-        }
-    }
-
-    bool DispersalCoordinator::checkDispersalRow(unsigned long row)
-    {
-        if(abs(dispersal_prob_map.get(row, dispersal_prob_map.getCols() - 1) - 1.0) > 0.00000001)
-        {
-            return true;
-        }
-        for(unsigned long i = 0; i < dispersal_prob_map.getCols() - 1; i++)
+        for(unsigned long row = 0; row < dispersal_prob_map.getRows(); row++)
         {
-            if(dispersal_prob_map.get(row, i) > dispersal_prob_map.get(row, i + 1))
+            const unsigned long end = dispersal_prob_map.rowEnd(row);
+            if(end > dispersal_prob_map.rowBegin(row))
             {
-                return true;
+                double total = 0.0;
+                for(unsigned long entry = dispersal_prob_map.rowBegin(row); entry < end; entry++)
+                {
+                    total += dispersal_prob_map.getProbability(entry);
+                }
+                if(total != 0.0 && std::abs(total - 1.0) > 0.00000001)
+                {
+                    throw FatalException("Dispersal probability map not correctly fixed to sum to 1.0.");
+                }
             }
         }
-        return false;
+#endif // DEBUG
     }
 
     void DispersalCoordinator::verifyDispersalMapSetup()
@@ -269,8 +239,10 @@ namespace necsim
                 bool origin_value =
                         landscape->getVal(origin_step.x, origin_step.y, origin_step.xwrap, origin_step.ywrap, 0.0) > 0;
                 double dispersal_total = 0.0;
-                for(unsigned long x = 0; x < dispersal_prob_map.getCols(); x++)
+                // Only the non-zero values need to be checked
+                for(unsigned long entry = dispersal_prob_map.rowBegin(y); entry < dispersal_prob_map.rowEnd(y); entry++)
                 {
+                    const unsigned long x = dispersal_prob_map.getColumn(entry);
                     Step destination_step;
                     calculateCellCoordinates(destination_step, x);
 #ifdef DEBUG
@@ -281,15 +253,7 @@ namespace necsim
                                                                destination_step.xwrap,
                                                                destination_step.ywrap,
                                                                0.0) > 0;
-                    double dispersal_prob;
-                    if(x == 0)
-                    {
-                        dispersal_prob = dispersal_prob_map.get(y, 0);
-                    }
-                    else
-                    {
-                        dispersal_prob = dispersal_prob_map.get(y, x) - dispersal_prob_map.get(y, x - 1);
-                    }
+                    double dispersal_prob = dispersal_prob_map.getProbability(entry);
                     dispersal_total += dispersal_prob;
                     if(dispersal_prob > 0.0)
                     {
@@ -338,9 +302,6 @@ namespace necsim
     {
         if(dispersal_prob_map.getRows() > 0)
         {
-            dispersal_prob_map = raw_dispersal_prob_map;
-            addDensity();
-            addReproduction();
             fixDispersal();
         }
     }
@@ -371,7 +332,7 @@ namespace necsim
         Cell cell;
         try
         {
-            if(dispersal_prob_map.get(0, 0) > 0.0)
+            if(dispersal_prob_map.getProbability(0, 0) > 0.0)
             {
                 cell.x = 0;
                 cell.y = 0;
@@ -381,8 +342,7 @@ namespace necsim
             {
                 Step tmp_step;
                 calculateCellCoordinates(tmp_step, i);
-                if(dispersal_prob_map.get(i, i - 1) > dispersal_prob_map.get(i, i)
-                   && dispersal_prob_map.get(i, i) > 0.0)
+                if(dispersal_prob_map.getProbability(i, i) > 0.0)
                 {
                     cell.x = tmp_step.x;
                     cell.y = tmp_step.y;
@@ -409,11 +369,7 @@ namespace necsim
             unsigned long index = calculateCellIndex(cell);
             ss << "Cell at " << cell.x << ", " << cell.y << " has incorrect self-dispersal assignment: " << fe.what()
                << std::endl;
-            ss << "Dispersal value: " << dispersal_prob_map.get(index, index) << std::endl;
-            if(index > 0)
-            {
-                ss << "Prior value: " << dispersal_prob_map.get(index, index - 1) << std::endl;
-            }
+            ss << "Dispersal probability: " << dispersal_prob_map.getProbability(index, index) << std::endl;
             throw FatalException(ss.str());
         }
 
@@ -444,25 +400,7 @@ namespace necsim
         // Now find the cell with that value
         // Now we get the cell reference
         unsigned long row_ref = calculateCellReference(this_step);
-        auto begin = dispersal_prob_map.begin() + dispersal_prob_map.index(row_ref, 0);
-        auto end = dispersal_prob_map.begin() + dispersal_prob_map.index(row_ref, dispersal_prob_map.getCols());
-        unsigned long out_col = std::lower_bound(begin, end, random_no) - begin;
-
-//        // Interval bisection on the cells to get the dispersal value
-//        unsigned long min_col = 0;
-//        unsigned long max_col = dispersal_prob_map.getCols() - 1;
-//        while(max_col - min_col > 1)
-//        {
-//            auto to_check = static_cast<unsigned long>(floor(double(max_col - min_col) / 2.0) + min_col);
-//            if(dispersal_prob_map.get(row_ref, to_check) < random_no)
-//            {
-//                min_col = to_check;
-//            }
-//            else
-//            {
-//                max_col = to_check;
-//            }
-//        }
+        unsigned long out_col = dispersal_prob_map.sample(row_ref, random_no);
         // Now get the coordinates of our cell reference
         calculateCellCoordinates(this_step, out_col);
 #ifdef DEBUG
@@ -815,55 +753,44 @@ namespace necsim
             return 1.0;
         }
         unsigned long cell_index = calculateCellIndex(cell);
-        if(cell_index >= raw_dispersal_prob_map.getCols())
+        if(cell_index >= dispersal_prob_map.getCols() || cell_index >= dispersal_prob_map.getRows())
         {
             std::stringstream ss;
             ss << "Index of " << cell_index << " for cell " << cell.x << ", " << cell.y
-               << " is out of range of dispersal map with bounds " << raw_dispersal_prob_map.getCols() << ", "
-               << raw_dispersal_prob_map.getRows() << std::endl;
+               << " is out of range of dispersal map with bounds " << dispersal_prob_map.getCols() << ", "
+               << dispersal_prob_map.getRows() << std::endl;
             throw FatalException(ss.str());
         }
-        return raw_dispersal_prob_map.getCopy(cell_index, cell_index);
+        return dispersal_prob_map.getRawValue(cell_index, cell_index);
     }
 
     double DispersalCoordinator::sumDispersalValues(const Cell &cell) const
     {
         if(!full_dispersal_map)
         {
-            return raw_dispersal_prob_map.getCols();
+            return dispersal_prob_map.getCols();
         }
         unsigned long cell_index = calculateCellIndex(cell);
-        double sum_total = 0.0;
-        for(unsigned long x = 0; x < raw_dispersal_prob_map.getCols(); x++)
-        {
-            sum_total += raw_dispersal_prob_map.get(cell_index, x);
-        }
-        return sum_total;
+        return dispersal_prob_map.sumRawRow(cell_index);
 
     }
 
     void DispersalCoordinator::reimportRawDispersalMap()
     {
-        if(raw_dispersal_prob_map.getCols() == 0 || raw_dispersal_prob_map.getRows() == 0)
+        // The raw values are kept alongside the cumulative probabilities, so the map only needs importing if it has
+        // been cleared.
+        if((dispersal_prob_map.getCols() == 0 || dispersal_prob_map.getRows() == 0)
+           && !dispersal_prob_map.getFileName().empty())
         {
-            raw_dispersal_prob_map.import(dispersal_prob_map.getFileName());
+            dispersal_prob_map.import(dispersal_prob_map.getFileName(), xdim * ydim);
         }
     }
 
     void DispersalCoordinator::removeSelfDispersal()
     {
         reimportRawDispersalMap();
-        Map<double> backup_dispersal_prob_map;
-        backup_dispersal_prob_map = raw_dispersal_prob_map;
-        for(unsigned long y = 0; y < raw_dispersal_prob_map.getRows(); y++)
-        {
-            raw_dispersal_prob_map.get(y, y) = 0.0;
-        }
-        dispersal_prob_map = raw_dispersal_prob_map;
-        addDensity();
-        addReproduction();
+        dispersal_prob_map.setExcludeSelfDispersal(true);
         fixDispersal();
-        raw_dispersal_prob_map = backup_dispersal_prob_map;
 #ifdef DEBUG
         validateNoSelfDispersalInDispersalMap();
 #endif //DEBUG
@@ -23,6 +23,7 @@
 
 #include "RNGController.h"
 #include "Map.h"
+#include "SparseDispersalMap.h"
 #include "Step.h"
 #include "Landscape.h"
 #include "ActivityMap.h"
@@ -43,11 +44,10 @@ namespace necsim
     protected:
 
         // Our map of dispersal probabilities (if required)
-        // This will contain cummulative probabilities across rows
+        // This will contain cummulative probabilities across rows for the non-zero values only, alongside the raw
+        // values from the dispersal map file.
         // So dispersal is from the y cell to each of the x cells.
-        Map<double> dispersal_prob_map;
-        // This object is only used if there are multiple density maps over time.
-        Map<double> raw_dispersal_prob_map;
+        SparseDispersalMap dispersal_prob_map;
         // Our random number generator for dispersal distances
         // This is a pointer so that the random number generator is the same
         // across the program.
@@ -83,7 +83,7 @@ namespace necsim
         bool full_dispersal_map;
 
     public:
-        DispersalCoordinator() : dispersal_prob_map(), raw_dispersal_prob_map(), NR(nullptr),
+        DispersalCoordinator() : dispersal_prob_map(), NR(nullptr),
                                  landscape(make_shared<Landscape>()), reproduction_map(make_shared<ActivityMap>()),
                                  generation(nullptr), doDispersal(nullptr), checkEndPointFptr(nullptr), xdim(0),
                                  ydim(0), full_dispersal_map(false)
@@ -101,7 +101,6 @@ namespace necsim
         DispersalCoordinator(const DispersalCoordinator &other) : DispersalCoordinator()
         {
             dispersal_prob_map = other.dispersal_prob_map;
-            raw_dispersal_prob_map = other.raw_dispersal_prob_map;
             NR = other.NR;
             landscape = other.landscape;
             reproduction_map = other.reproduction_map;
@@ -124,7 +123,6 @@ namespace necsim
             if(this != &other)
             {
                 std::swap(dispersal_prob_map, other.dispersal_prob_map);
-                std::swap(raw_dispersal_prob_map, other.raw_dispersal_prob_map);
                 std::swap(NR, other.NR);
                 std::swap(landscape, other.landscape);
                 std::swap(reproduction_map, other.reproduction_map);
@@ -207,41 +205,25 @@ namespace necsim
         void importDispersal(const unsigned long &dispersal_dim, const string &dispersal_file);
 
         /**
-         * @brief Saves the raw dispersal data to another memory object to save reading from disk multiple times later on.
-         * This is slightly more RAM intensive which may cause issues for certain simulations.
+         * @brief Gets the density of every cell in the dispersal map at the current generation, checking that there is
+         * no dispersal to cells with zero density.
+         * @param density the vector to store the density of each cell in
          */
-        void setRawDispersalMap();
+        void addDensity(vector<double> &density);
 
         /**
-         * @brief Adds the density values to the dispersal map.
-         * @param generation the current generation counter
+         * @brief Gets the reproduction rate of every cell in the dispersal map.
+         * @param reproduction the vector to store the reproduction rates in, which is left empty if there is no
+         * reproduction map
          */
-        void addDensity();
+        void addReproduction(vector<double> &reproduction);
 
         /**
-         * @brief Adds the reproduction rates to the dispersal map.
-         */
-        void addReproduction();
-
-        /**
-         * @brief Fixes the dispersal map by generating cumulative probability distributions across each row.
+         * @brief Fixes the dispersal map by generating cumulative probability distributions across each row, using the
+         * current density and reproduction rates.
          */
         void fixDispersal();
 
-        /**
-         * @brief Sums probabilities across the given row and divides by the total probability, so that the cumulative
-         * probabilities sum to one.
-         * @param row the row index to check over
-         */
-        void fixDispersalRow(unsigned long row);
-
-        /**
-         * @brief Checks if the provided row index requires re-scaling to a cumulative probability in the dispersal map.
-         * @param row the row index to check
-         * @return true if re-scaling of the row is required
-         */
-        bool checkDispersalRow(unsigned long row);
-
         /**
          * @brief Ensures that the dispersal map makes sense given the density.
          */
@@ -466,7 +448,7 @@ namespace necsim
         double sumDispersalValues(const Cell &cell) const;
 
         /**
-         * @brief If required, reimports the raw dispersal map from disk.
+         * @brief If required, reimports the dispersal map from disk.
          */
         void reimportRawDispersalMap();
 
@@ -0,0 +1,162 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file DistanceTransform.cpp
+ * @brief Contains the DistanceTransform class for finding the nearest habitat cell to every cell of a map.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include "DistanceTransform.h"
+#include "custom_exceptions.h"
+
+namespace necsim
+{
+    const uint32_t DistanceTransform::NONE;
+
+    DistanceTransform::DistanceTransform() : rows(0), cols(0), nearest()
+    {
+
+    }
+
+    bool DistanceTransform::canGenerate(const unsigned long &rows_in, const unsigned long &cols_in)
+    {
+        return cols_in == 0 || rows_in < NONE / cols_in;
+    }
+
+    void DistanceTransform::generate(const unsigned long &rows_in,
+                                     const unsigned long &cols_in,
+                                     const vector<bool> &habitat)
+    {
+        if(!canGenerate(rows_in, cols_in) || habitat.size() != rows_in * cols_in)
+        {
+            std::stringstream ss;
+            ss << "Cannot generate distance transform for " << habitat.size() << " cells on a map of " << rows_in
+               << " by " << cols_in << " cells. Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+        rows = rows_in;
+        cols = cols_in;
+        nearest.assign(rows * cols, NONE);
+        // Find the nearest habitat row in each column, sweeping down and then up the map one row at a time.
+        vector<uint32_t> previous(cols, NONE);
+        for(unsigned long y = 0; y < rows; y++)
+        {
+            for(unsigned long x = 0; x < cols; x++)
+            {
+                if(habitat[y * cols + x])
+                {
+                    previous[x] = static_cast<uint32_t>(y);
+                }
+                nearest[y * cols + x] = previous[x];
+            }
+        }
+        vector<uint32_t> &next = previous;
+        std::fill(next.begin(), next.end(), NONE);
+        for(unsigned long y = rows; y > 0; y--)
+        {
+            const unsigned long row = y - 1;
+            for(unsigned long x = 0; x < cols; x++)
+            {
+                if(habitat[row * cols + x])
+                {
+                    next[x] = static_cast<uint32_t>(row);
+                }
+                uint32_t &above = nearest[row * cols + x];
+                if(next[x] != NONE && (above == NONE || next[x] - row < row - above))
+                {
+                    above = next[x];
+                }
+            }
+        }
+        // Along each row, find the lower envelope of the parabolas centred on each column's nearest habitat cell.
+        vector<uint32_t> column_rows(cols);
+        vector<unsigned long> sites(cols);
+        vector<double> boundaries(cols + 1);
+        vector<double> heights(cols);
+        const double infinity = std::numeric_limits<double>::infinity();
+        for(unsigned long y = 0; y < rows; y++)
+        {
+            std::copy(nearest.begin() + y * cols, nearest.begin() + (y + 1) * cols, column_rows.begin());
+            long k = -1;
+            for(unsigned long q = 0; q < cols; q++)
+            {
+                if(column_rows[q] == NONE)
+                {
+                    continue;
+                }
+                const double dy = static_cast<double>(y) - static_cast<double>(column_rows[q]);
+                heights[q] = dy * dy + static_cast<double>(q) * static_cast<double>(q);
+                if(k < 0)
+                {
+                    k = 0;
+                    sites[0] = q;
+                    boundaries[0] = -infinity;
+                    boundaries[1] = infinity;
+                    continue;
+                }
+                double intersection;
+                while(true)
+                {
+                    const unsigned long site = sites[k];
+                    intersection = (heights[q] - heights[site]) / (2.0 * (static_cast<double>(q) - site));
+                    if(intersection > boundaries[k])
+                    {
+                        break;
+                    }
+                    k--;
+                }
+                k++;
+                sites[k] = q;
+                boundaries[k] = intersection;
+                boundaries[k + 1] = infinity;
+            }
+            if(k < 0)
+            {
+                continue;
+            }
+            k = 0;
+            for(unsigned long x = 0; x < cols; x++)
+            {
+                while(boundaries[k + 1] < static_cast<double>(x))
+                {
+                    k++;
+                }
+                const unsigned long site = sites[k];
+                nearest[y * cols + x] = static_cast<uint32_t>(column_rows[site] * cols + site);
+            }
+        }
+    }
+
+    void DistanceTransform::clear()
+    {
+        rows = 0;
+        cols = 0;
+        nearest.clear();
+        nearest.shrink_to_fit();
+    }
+
+    bool DistanceTransform::empty() const
+    {
+        return nearest.empty();
+    }
+
+    bool DistanceTransform::getNearest(const unsigned long &y,
+                                       const unsigned long &x,
+                                       unsigned long &nearest_y,
+                                       unsigned long &nearest_x) const
+    {
+        const uint32_t index = nearest[y * cols + x];
+        if(index == NONE)
+        {
+            return false;
+        }
+        nearest_y = index / cols;
+        nearest_x = index % cols;
+        return true;
+    }
+}
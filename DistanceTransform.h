@@ -0,0 +1,81 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file DistanceTransform.h
+ * @brief Contains the DistanceTransform class for finding the nearest habitat cell to every cell of a map.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_DISTANCETRANSFORM_H
+#define NECSIM_DISTANCETRANSFORM_H
+
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief Stores the nearest habitat cell to each cell of a map, by the Euclidean distance between cell centres.
+     *
+     * The transform is exact, and is generated in linear time using the separable lower envelope method of Felzenszwalb
+     * and Huttenlocher (2012): the nearest habitat cell in each column is found first, then the nearest of those along
+     * each row. Each lookup afterwards takes constant time.
+     */
+    class DistanceTransform
+    {
+    protected:
+        // Marks a cell with no habitat cell in range.
+        static const uint32_t NONE = UINT32_MAX;
+        // The dimensions of the map, in cells.
+        unsigned long rows, cols;
+        // The index of the nearest habitat cell to each cell, in row-major order, or NONE if there is no habitat.
+        vector<uint32_t> nearest;
+
+    public:
+        DistanceTransform();
+
+        /**
+         * @brief Checks if the transform can be generated for a map of the given size.
+         * @param rows_in the number of rows in the map
+         * @param cols_in the number of columns in the map
+         * @return true if every cell of the map can be indexed
+         */
+        static bool canGenerate(const unsigned long &rows_in, const unsigned long &cols_in);
+
+        /**
+         * @brief Generates the transform for the map.
+         * @param rows_in the number of rows in the map
+         * @param cols_in the number of columns in the map
+         * @param habitat true for each habitat cell, in row-major order
+         */
+        void generate(const unsigned long &rows_in, const unsigned long &cols_in, const vector<bool> &habitat);
+
+        /**
+         * @brief Removes the transform.
+         */
+        void clear();
+
+        /**
+         * @brief Checks if the transform has been generated.
+         * @return true if there is no transform
+         */
+        bool empty() const;
+
+        /**
+         * @brief Gets the nearest habitat cell to the cell.
+         * @param y the row of the cell
+         * @param x the column of the cell
+         * @param nearest_y the row of the nearest habitat cell
+         * @param nearest_x the column of the nearest habitat cell
+         * @return true if there is any habitat cell on the map
+         */
+        bool getNearest(const unsigned long &y,
+                        const unsigned long &x,
+                        unsigned long &nearest_y,
+                        unsigned long &nearest_x) const;
+    };
+}
+#endif //NECSIM_DISTANCETRANSFORM_H
@@ -0,0 +1,149 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file FenwickTree.cpp
+ * @brief Contains the FenwickTree class for weighted selection from a set of values which change over time.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <sstream>
+#include "FenwickTree.h"
+#include "custom_exceptions.h"
+
+namespace necsim
+{
+    FenwickTree::FenwickTree() : tree(1, 0.0), weights(), highest_bit(0), updates_since_generation(0)
+    {
+
+    }
+
+    void FenwickTree::generate()
+    {
+        tree.assign(weights.size() + 1, 0.0);
+        for(unsigned long i = 1; i <= weights.size(); i++)
+        {
+            tree[i] += weights[i - 1];
+            const unsigned long parent = i + (i & (~i + 1));
+            if(parent <= weights.size())
+            {
+                tree[parent] += tree[i];
+            }
+        }
+        highest_bit = 0;
+        if(!weights.empty())
+        {
+            highest_bit = 1;
+            while(highest_bit * 2 <= weights.size())
+            {
+                highest_bit *= 2;
+            }
+        }
+        updates_since_generation = 0;
+    }
+
+    void FenwickTree::assign(const vector<double> &weights_in)
+    {
+        for(const auto &weight : weights_in)
+        {
+            if(weight < 0.0)
+            {
+                throw FatalException("Weights in Fenwick tree must be non-negative. Please report this bug.");
+            }
+        }
+        weights = weights_in;
+        generate();
+    }
+
+    void FenwickTree::clear()
+    {
+        weights.clear();
+        generate();
+    }
+
+    unsigned long FenwickTree::size() const
+    {
+        return weights.size();
+    }
+
+    double FenwickTree::get(const unsigned long &index) const
+    {
+        return weights[index];
+    }
+
+    void FenwickTree::set(const unsigned long &index, const double &weight)
+    {
+#ifdef DEBUG
+        if(index >= weights.size() || weight < 0.0)
+        {
+            std::stringstream ss;
+            ss << "Cannot set weight of " << weight << " at index " << index << " in Fenwick tree of size ";
+            ss << weights.size() << ". Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+#endif // DEBUG
+        const double difference = weight - weights[index];
+        if(difference == 0.0)
+        {
+            return;
+        }
+        weights[index] = weight;
+        // Regenerating after every n updates keeps the cost per update O(log n), while bounding the rounding error.
+        if(++updates_since_generation > weights.size())
+        {
+            generate();
+            return;
+        }
+        for(unsigned long i = index + 1; i <= weights.size(); i += i & (~i + 1))
+        {
+            tree[i] += difference;
+        }
+    }
+
+    double FenwickTree::total() const
+    {
+        double sum = 0.0;
+        for(unsigned long i = weights.size(); i > 0; i -= i & (~i + 1))
+        {
+            sum += tree[i];
+        }
+        return sum;
+    }
+
+    unsigned long FenwickTree::find(const double &target) const
+    {
+        if(weights.empty())
+        {
+            throw FatalException("Cannot find index in empty Fenwick tree. Please report this bug.");
+        }
+        unsigned long position = 0;
+        double remaining = target;
+        for(unsigned long step = highest_bit; step > 0; step /= 2)
+        {
+            if(position + step <= weights.size() && tree[position + step] <= remaining)
+            {
+                position += step;
+                remaining -= tree[position];
+            }
+        }
+        // Rounding can lead to an index with no weight, or past the end, in which case the nearest index below with a
+        // non-zero weight is chosen.
+        if(position >= weights.size())
+        {
+            position = weights.size() - 1;
+        }
+        while(position > 0 && weights[position] == 0.0)
+        {
+            position--;
+        }
+        if(weights[position] == 0.0)
+        {
+            while(position < weights.size() - 1 && weights[position] == 0.0)
+            {
+                position++;
+            }
+        }
+        return position;
+    }
+}
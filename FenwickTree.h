@@ -0,0 +1,93 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file FenwickTree.h
+ * @brief Contains the FenwickTree class for weighted selection from a set of values which change over time.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_FENWICKTREE_H
+#define NECSIM_FENWICKTREE_H
+
+#include <vector>
+
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief Stores a set of non-negative weights as a binary indexed (Fenwick) tree.
+     *
+     * Changing a single weight, and finding the index containing a point in the cumulative sum of the weights, both
+     * take O(log n) time. The tree is periodically regenerated from the stored weights, so that rounding errors from
+     * repeated updates do not accumulate.
+     */
+    class FenwickTree
+    {
+    protected:
+        // The partial sums, indexed from 1.
+        vector<double> tree;
+        // The weight of each index.
+        vector<double> weights;
+        // The largest power of two no greater than the number of weights, used for searching the tree.
+        unsigned long highest_bit;
+        // The number of updates since the tree was last generated from the weights.
+        unsigned long updates_since_generation;
+
+        /**
+         * @brief Generates the partial sums from the weights.
+         */
+        void generate();
+
+    public:
+        FenwickTree();
+
+        /**
+         * @brief Sets all weights.
+         * @param weights_in the weight of each index
+         */
+        void assign(const vector<double> &weights_in);
+
+        /**
+         * @brief Removes all weights.
+         */
+        void clear();
+
+        /**
+         * @brief Gets the number of weights stored.
+         * @return the number of weights
+         */
+        unsigned long size() const;
+
+        /**
+         * @brief Gets the weight of the index.
+         * @param index the index to get the weight of
+         * @return the weight
+         */
+        double get(const unsigned long &index) const;
+
+        /**
+         * @brief Sets the weight of the index.
+         * @param index the index to set the weight of
+         * @param weight the new weight, which must be non-negative
+         */
+        void set(const unsigned long &index, const double &weight);
+
+        /**
+         * @brief Gets the sum of all weights.
+         * @return the total weight
+         */
+        double total() const;
+
+        /**
+         * @brief Finds the index at the given point in the cumulative sum of the weights.
+         *
+         * Indices with a weight of zero are never returned.
+         * @param target a value between 0 and the total weight
+         * @return the index
+         */
+        unsigned long find(const double &target) const;
+    };
+}
+#endif //NECSIM_FENWICKTREE_H
@@ -100,6 +100,11 @@ namespace necsim
             tree_ptr->addGillespie(g_threshold);
         }
 
+        void addAutomaticGillespie()
+        {
+            tree_ptr->addAutomaticGillespie();
+        }
+
         void addSpeciationRates(std::vector<long double> spec_rates_long)
         {
             tree_ptr->addSpeciationRates(spec_rates_long);
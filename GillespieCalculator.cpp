@@ -124,14 +124,18 @@ namespace necsim
         return is;
     }
 
-    /*void swap(GillespieHeapNode &lhs, GillespieHeapNode &rhs) noexcept
+    std::ostream &operator<<(std::ostream &os, const GillespieRates &rates)
     {
-        writeInfo("Custom swap\n");
-        using std::swap;
-        swap(lhs.cell, rhs.cell);
-        swap(lhs.time_of_event, rhs.time_of_event);
-        swap(lhs.event_type, rhs.event_type);
-        swap(*lhs.pos, *rhs.pos);
-    }*/
+        os << rates.step_rate << "," << rates.estimated_event_rate << "," << rates.event_rate << ","
+           << rates.event_proportion << "," << rates.switch_generation << "," << rates.switch_lineages << std::endl;
+        return os;
+    }
 
+    std::istream &operator>>(std::istream &is, GillespieRates &rates)
+    {
+        char delim;
+        is >> rates.step_rate >> delim >> rates.estimated_event_rate >> delim >> rates.event_rate >> delim
+           >> rates.event_proportion >> delim >> rates.switch_generation >> delim >> rates.switch_lineages;
+        return is;
+    }
 }
\ No newline at end of file
@@ -94,113 +94,28 @@ namespace necsim
         friend std::istream &operator>>(std::istream &is, GillespieProbability &gp);
     };
 
-    class GillespieHeapNode
+    /**
+     * @brief The measured speeds of the per-step and Gillespie algorithms, used for deciding when to switch between
+     * the two and stored in the output database for calibrating future simulations.
+     */
+    struct GillespieRates
     {
-    private:
-        void updateHeapPosition()
-        {
-            // Enclosing heap vector not known or no locator to report to
-            if(heap == nullptr || locator == nullptr)
-            {
-                return;
-            }
-
-            // Node is outside its enclosing heap, i.e. it was probably moved to a temporary place
-            if(this < heap->data() || this >= (heap->data() + heap->size()))
-            {
-                return;
-            }
-
-            // Store the heap vector index with the locator
-            *locator = this - heap->data();
-
-        }
-
-    public:
-        Cell cell;
-        double time_of_event;
-        EventType event_type;
-
-        // Pointer to index in heap
-        vector<GillespieHeapNode>* heap;
-        unsigned long* locator;
-
-        GillespieHeapNode(const Cell cell,
-                          const double time_of_event,
-                          const EventType &e,
-                          vector<GillespieHeapNode>* heap,
-                          unsigned long* locator) : cell(cell), time_of_event(time_of_event), event_type(e), heap(heap),
-                                                    locator(locator)
-        {
-            updateHeapPosition();
-        }
-
-        GillespieHeapNode(const double time_of_event, const EventType &e) : GillespieHeapNode(Cell(),
-                                                                                              time_of_event,
-                                                                                              e,
-                                                                                              nullptr,
-                                                                                              nullptr)
-        { }
-
-        GillespieHeapNode() : GillespieHeapNode(Cell(), 0.0, EventType::undefined, nullptr, nullptr)
-        { }
-
-        GillespieHeapNode(const GillespieHeapNode &other) noexcept
-        {
-            cell = other.cell;
-            time_of_event = other.time_of_event;
-            event_type = other.event_type;
-
-            heap = other.heap;
-            locator = other.locator;
-
-            updateHeapPosition();
-        }
-
-        GillespieHeapNode &operator=(const GillespieHeapNode &other)
-        {
-            cell = other.cell;
-            time_of_event = other.time_of_event;
-            event_type = other.event_type;
-
-            heap = other.heap;
-            locator = other.locator;
-
-            updateHeapPosition();
-
-            return *this;
-        }
-
-        GillespieHeapNode(GillespieHeapNode &&other) noexcept
-        {
-            cell = other.cell;
-            time_of_event = other.time_of_event;
-            event_type = other.event_type;
-
-            heap = other.heap;
-            locator = other.locator;
-
-            updateHeapPosition();
-        }
-
-        GillespieHeapNode &operator=(GillespieHeapNode &&other) noexcept
-        {
-            cell = other.cell;
-            time_of_event = other.time_of_event;
-            event_type = other.event_type;
-
-            heap = other.heap;
-            locator = other.locator;
-
-            updateHeapPosition();
-
-            return *this;
-        }
-
-        bool operator<(const GillespieHeapNode &n) const
-        {
-            return time_of_event > n.time_of_event;
-        }
+        // Steps per second of the per-step algorithm over the last measurement before the switch.
+        double step_rate{0.0};
+        // Events per second of the Gillespie algorithm estimated from the last measurement before the switch.
+        double estimated_event_rate{0.0};
+        // Events per second of the Gillespie algorithm, measured after the switch.
+        double event_rate{0.0};
+        // The proportion of the last measured steps which would have been Gillespie events.
+        double event_proportion{1.0};
+        // The generation at which the switch to the Gillespie algorithm was made.
+        double switch_generation{0.0};
+        // The number of lineages when the switch to the Gillespie algorithm was made.
+        unsigned long switch_lineages{0};
+
+        friend std::ostream &operator<<(std::ostream &os, const GillespieRates &rates);
+
+        friend std::istream &operator>>(std::istream &is, GillespieRates &rates);
     };
 
 }
@@ -0,0 +1,260 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file IndexedHeap.cpp
+ * @brief Contains the IndexedHeap class, a priority queue of event times which can be updated by event index.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "IndexedHeap.h"
+#include "custom_exceptions.h"
+
+namespace necsim
+{
+    const unsigned long IndexedHeap::UNUSED;
+    const unsigned long IndexedHeap::ARITY;
+
+    IndexedHeap::IndexedHeap() : entries(), positions()
+    {
+
+    }
+
+    void IndexedHeap::place(const unsigned long &position, const Entry &entry)
+    {
+        entries[position] = entry;
+        positions[entry.index] = position;
+    }
+
+    void IndexedHeap::siftUp(unsigned long position)
+    {
+        const Entry entry = entries[position];
+        while(position > 0)
+        {
+            const unsigned long parent = (position - 1) / ARITY;
+            if(entries[parent].time <= entry.time)
+            {
+                break;
+            }
+            place(position, entries[parent]);
+            position = parent;
+        }
+        place(position, entry);
+    }
+
+    void IndexedHeap::siftDown(unsigned long position)
+    {
+        const Entry entry = entries[position];
+        const unsigned long count = entries.size();
+        while(true)
+        {
+            const unsigned long first_child = position * ARITY + 1;
+            if(first_child >= count)
+            {
+                break;
+            }
+            const unsigned long last_child = std::min(first_child + ARITY, count);
+            unsigned long earliest = first_child;
+            for(unsigned long child = first_child + 1; child < last_child; child++)
+            {
+                if(entries[child].time < entries[earliest].time)
+                {
+                    earliest = child;
+                }
+            }
+            if(entry.time <= entries[earliest].time)
+            {
+                break;
+            }
+            place(position, entries[earliest]);
+            position = earliest;
+        }
+        place(position, entry);
+    }
+
+    void IndexedHeap::clear()
+    {
+        for(const auto &entry : entries)
+        {
+            positions[entry.index] = UNUSED;
+        }
+        entries.clear();
+    }
+
+    void IndexedHeap::setIndexCount(const unsigned long &index_count)
+    {
+        entries.clear();
+        positions.assign(index_count, UNUSED);
+    }
+
+    bool IndexedHeap::empty() const
+    {
+        return entries.empty();
+    }
+
+    unsigned long IndexedHeap::size() const
+    {
+        return entries.size();
+    }
+
+    bool IndexedHeap::contains(const unsigned long &index) const
+    {
+        return index < positions.size() && positions[index] != UNUSED;
+    }
+
+    double IndexedHeap::getTime(const unsigned long &index) const
+    {
+        return entries[positions[index]].time;
+    }
+
+    const IndexedHeap::Entry &IndexedHeap::top() const
+    {
+#ifdef DEBUG
+        if(entries.empty())
+        {
+            throw FatalException("Cannot get the earliest event from an empty heap. Please report this bug.");
+        }
+#endif // DEBUG
+        return entries.front();
+    }
+
+    const IndexedHeap::Entry &IndexedHeap::operator[](const unsigned long &position) const
+    {
+        return entries[position];
+    }
+
+    void IndexedHeap::push(const unsigned long &index, const double &time)
+    {
+        pushUnordered(index, time);
+        siftUp(entries.size() - 1);
+    }
+
+    void IndexedHeap::pushUnordered(const unsigned long &index, const double &time)
+    {
+        if(contains(index) || index >= positions.size())
+        {
+            std::stringstream ss;
+            ss << "Cannot add event with index " << index << " to heap for " << positions.size()
+               << " indices. Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+        entries.push_back(Entry{time, index});
+        positions[index] = entries.size() - 1;
+    }
+
+    void IndexedHeap::heapify()
+    {
+        if(entries.size() < 2)
+        {
+            return;
+        }
+        for(unsigned long position = (entries.size() - 2) / ARITY + 1; position > 0; position--)
+        {
+            siftDown(position - 1);
+        }
+    }
+
+    void IndexedHeap::pop()
+    {
+        remove(top().index);
+    }
+
+    void IndexedHeap::remove(const unsigned long &index)
+    {
+#ifdef DEBUG
+        if(!contains(index))
+        {
+            std::stringstream ss;
+            ss << "Cannot remove index " << index << " which is not in the heap. Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+#endif // DEBUG
+        const unsigned long position = positions[index];
+        positions[index] = UNUSED;
+        const Entry last = entries.back();
+        entries.pop_back();
+        if(position == entries.size())
+        {
+            return;
+        }
+        // Fill the gap with the last entry, which may need to move in either direction.
+        place(position, last);
+        if(position > 0 && entries[(position - 1) / ARITY].time > last.time)
+        {
+            siftUp(position);
+        }
+        else
+        {
+            siftDown(position);
+        }
+    }
+
+    void IndexedHeap::update(const unsigned long &index, const double &time)
+    {
+        if(time < getTime(index))
+        {
+            decreaseKey(index, time);
+        }
+        else
+        {
+            increaseKey(index, time);
+        }
+    }
+
+    void IndexedHeap::decreaseKey(const unsigned long &index, const double &time)
+    {
+#ifdef DEBUG
+        if(!contains(index) || time > getTime(index))
+        {
+            throw FatalException("Cannot decrease key in heap. Please report this bug.");
+        }
+#endif // DEBUG
+        const unsigned long position = positions[index];
+        entries[position].time = time;
+        siftUp(position);
+    }
+
+    void IndexedHeap::increaseKey(const unsigned long &index, const double &time)
+    {
+#ifdef DEBUG
+        if(!contains(index) || time < getTime(index))
+        {
+            throw FatalException("Cannot increase key in heap. Please report this bug.");
+        }
+#endif // DEBUG
+        const unsigned long position = positions[index];
+        entries[position].time = time;
+        siftDown(position);
+    }
+
+    bool IndexedHeap::isValid() const
+    {
+        unsigned long in_heap = 0;
+        for(const auto &position : positions)
+        {
+            if(position != UNUSED)
+            {
+                in_heap++;
+            }
+        }
+        if(in_heap != entries.size())
+        {
+            return false;
+        }
+        for(unsigned long position = 0; position < entries.size(); position++)
+        {
+            if(entries[position].index >= positions.size() || positions[entries[position].index] != position)
+            {
+                return false;
+            }
+            if(position > 0 && entries[(position - 1) / ARITY].time > entries[position].time)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,181 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file IndexedHeap.h
+ * @brief Contains the IndexedHeap class, a priority queue of event times which can be updated by event index.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_INDEXEDHEAP_H
+#define NECSIM_INDEXEDHEAP_H
+
+#include <vector>
+
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief A minimum priority queue of event times, each identified by an index.
+     *
+     * The heap is stored as a 4-ary tree, which is shallower than a binary tree and keeps the children of each node
+     * together in memory. Each entry contains only the time and index of the event, and the position of each index in
+     * the heap is stored separately, so that the time of any event can be changed in O(log n) time.
+     */
+    class IndexedHeap
+    {
+    public:
+        /**
+         * @brief A single event in the heap.
+         */
+        struct Entry
+        {
+            double time;
+            unsigned long index;
+        };
+
+        // Marks an index which is not in the heap.
+        static const unsigned long UNUSED = static_cast<unsigned long>(-1);
+
+    protected:
+        // The number of children of each node.
+        static const unsigned long ARITY = 4;
+        // The events, ordered as a heap.
+        vector<Entry> entries;
+        // The position of each index in the heap, or UNUSED if the index is not in the heap.
+        vector<unsigned long> positions;
+
+        /**
+         * @brief Moves the entry at the position towards the top of the heap, until its parent is earlier.
+         * @param position the position of the entry to move
+         */
+        void siftUp(unsigned long position);
+
+        /**
+         * @brief Moves the entry at the position towards the bottom of the heap, until its children are later.
+         * @param position the position of the entry to move
+         */
+        void siftDown(unsigned long position);
+
+        /**
+         * @brief Places the entry at the position, recording the position for its index.
+         * @param position the position in the heap
+         * @param entry the entry to place
+         */
+        void place(const unsigned long &position, const Entry &entry);
+
+    public:
+        IndexedHeap();
+
+        /**
+         * @brief Removes all events from the heap.
+         */
+        void clear();
+
+        /**
+         * @brief Sets the number of indices which may be stored in the heap, removing all events.
+         * @param index_count one more than the largest index which can be stored
+         */
+        void setIndexCount(const unsigned long &index_count);
+
+        /**
+         * @brief Checks if the heap contains any events.
+         * @return true if there are no events
+         */
+        bool empty() const;
+
+        /**
+         * @brief Gets the number of events in the heap.
+         * @return the number of events
+         */
+        unsigned long size() const;
+
+        /**
+         * @brief Checks if the index is in the heap.
+         * @param index the index to check
+         * @return true if the index has an event in the heap
+         */
+        bool contains(const unsigned long &index) const;
+
+        /**
+         * @brief Gets the time of the event with the index, which must be in the heap.
+         * @param index the index of the event
+         * @return the time of the event
+         */
+        double getTime(const unsigned long &index) const;
+
+        /**
+         * @brief Gets the earliest event.
+         * @return the entry for the earliest event
+         */
+        const Entry &top() const;
+
+        /**
+         * @brief Gets the event at the position in the heap, for iterating over all events.
+         * @param position the position, which must be less than the size of the heap
+         * @return the entry at the position
+         */
+        const Entry &operator[](const unsigned long &position) const;
+
+        /**
+         * @brief Adds an event for an index not already in the heap.
+         * @param index the index of the event
+         * @param time the time of the event
+         */
+        void push(const unsigned long &index, const double &time);
+
+        /**
+         * @brief Adds an event without restoring the heap order, for adding many events at once.
+         *
+         * heapify() must be called before the heap is next used.
+         * @param index the index of the event
+         * @param time the time of the event
+         */
+        void pushUnordered(const unsigned long &index, const double &time);
+
+        /**
+         * @brief Restores the heap order after adding events with pushUnordered().
+         */
+        void heapify();
+
+        /**
+         * @brief Removes the earliest event.
+         */
+        void pop();
+
+        /**
+         * @brief Removes the event with the index, which must be in the heap.
+         * @param index the index of the event to remove
+         */
+        void remove(const unsigned long &index);
+
+        /**
+         * @brief Changes the time of the event with the index, which must be in the heap.
+         * @param index the index of the event
+         * @param time the new time of the event
+         */
+        void update(const unsigned long &index, const double &time);
+
+        /**
+         * @brief Moves the event with the index to an earlier time.
+         * @param index the index of the event
+         * @param time the new time, which must be no later than the current time
+         */
+        void decreaseKey(const unsigned long &index, const double &time);
+
+        /**
+         * @brief Moves the event with the index to a later time.
+         * @param index the index of the event
+         * @param time the new time, which must be no earlier than the current time
+         */
+        void increaseKey(const unsigned long &index, const double &time);
+
+        /**
+         * @brief Checks that the heap is ordered and that the stored positions are correct.
+         * @return true if the heap is valid
+         */
+        bool isValid() const;
+    };
+}
+#endif //NECSIM_INDEXEDHEAP_H
@@ -0,0 +1,171 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file InterpolatedMap.cpp
+ * @brief Contains the InterpolatedMap class for storing the density of each cell between a present and historical map.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include "InterpolatedMap.h"
+#include "custom_exceptions.h"
+
+namespace necsim
+{
+    const uint32_t InterpolatedMap::DIRECT;
+    const unsigned long InterpolatedMap::LOOKUPS_PER_CELL_UPDATE;
+    const unsigned long InterpolatedMap::MIN_CELL_UPDATES;
+
+    InterpolatedMap::InterpolatedMap() : cols(0), values(), changing_cells(), present_values(), historical_values(),
+                                         updates(), map_time(0.0), historical_time(0.0), change_rate(0.0),
+                                         start(std::numeric_limits<double>::infinity()),
+                                         next_update(std::numeric_limits<double>::infinity()), lookups(0),
+                                         cell_updates(0)
+    {
+
+    }
+
+    unsigned long InterpolatedMap::interpolate(const double &present,
+                                               const double &historical,
+                                               const double &map_time_in,
+                                               const double &historical_time_in,
+                                               const double &change_rate_in,
+                                               const double &generation)
+    {
+        double current_time = generation - map_time_in;
+        return (unsigned long) floor(present + (change_rate_in * ((historical - present)
+                                                                  / (historical_time_in - map_time_in))
+                                                * current_time));
+    }
+
+    double InterpolatedMap::updateCell(const unsigned long &changing_index, const double &generation)
+    {
+        const double &present = present_values[changing_index];
+        const double &historical = historical_values[changing_index];
+        const unsigned long value = interpolate(present, historical, map_time, historical_time, change_rate,
+                                                generation);
+        values[changing_cells[changing_index]] = value < DIRECT ? static_cast<uint32_t>(value) : DIRECT;
+        // Find when the interpolated value next crosses an integer, in the direction of change.
+        const double slope = change_rate * ((historical - present) / (historical_time - map_time));
+        const double current = present + slope * (generation - map_time);
+        double crossing = std::numeric_limits<double>::infinity();
+        if(slope > 0.0 && std::isfinite(current))
+        {
+            crossing = map_time + (floor(current) + 1.0 - present) / slope;
+        }
+        else if(slope < 0.0 && std::isfinite(current))
+        {
+            crossing = map_time + (floor(current) - present) / slope;
+        }
+        // The change is scheduled slightly early to allow for rounding errors in the crossing time, after which the
+        // cell is recalculated at each later generation until the density changes.
+        double next = crossing;
+        if(std::isfinite(crossing))
+        {
+            next -= 1e-12 * ((std::fabs(present) + std::fabs(historical) + 1.0) / std::fabs(slope)
+                             + std::fabs(crossing) + std::fabs(map_time) + 1.0);
+        }
+        if(!(next > generation))
+        {
+            next = std::nextafter(generation, std::numeric_limits<double>::infinity());
+        }
+        return next;
+    }
+
+    void InterpolatedMap::update(const double &generation)
+    {
+        while(!updates.empty() && updates.top().time <= generation)
+        {
+            const unsigned long changing_index = updates.top().index;
+            updates.update(changing_index, updateCell(changing_index, generation));
+            cell_updates++;
+        }
+        start = generation;
+        next_update = updates.empty() ? std::numeric_limits<double>::infinity() : updates.top().time;
+        // Stop using the raster if its cells are recalculated too often for the number of lookups it serves.
+        if(cell_updates >= MIN_CELL_UPDATES && cell_updates * LOOKUPS_PER_CELL_UPDATE > lookups)
+        {
+            clear();
+        }
+    }
+
+    void InterpolatedMap::generate(const Matrix<uint32_t> &present,
+                                   const Matrix<uint32_t> &historical,
+                                   const double &map_time_in,
+                                   const double &historical_time_in,
+                                   const double &change_rate_in,
+                                   const double &generation)
+    {
+        if(present.getRows() != historical.getRows() || present.getCols() != historical.getCols())
+        {
+            std::stringstream ss;
+            ss << "Cannot interpolate between a map of " << present.getCols() << " by " << present.getRows()
+               << " cells and a map of " << historical.getCols() << " by " << historical.getRows()
+               << " cells. Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+        const unsigned long rows = present.getRows();
+        cols = present.getCols();
+        map_time = map_time_in;
+        historical_time = historical_time_in;
+        change_rate = change_rate_in;
+        values.resize(rows * cols);
+        changing_cells.clear();
+        present_values.clear();
+        historical_values.clear();
+        for(unsigned long y = 0; y < rows; y++)
+        {
+            for(unsigned long x = 0; x < cols; x++)
+            {
+                const uint32_t historical_value = historical.get(y, x);
+                if(historical_value == present.get(y, x))
+                {
+                    values[y * cols + x] = historical_value;
+                }
+                else
+                {
+                    changing_cells.push_back(y * cols + x);
+                    present_values.push_back(static_cast<double>(present.get(y, x)));
+                    historical_values.push_back(static_cast<double>(historical_value));
+                }
+            }
+        }
+        updates.setIndexCount(changing_cells.size());
+        for(unsigned long i = 0; i < changing_cells.size(); i++)
+        {
+            updates.pushUnordered(i, updateCell(i, generation));
+        }
+        updates.heapify();
+        start = generation;
+        next_update = updates.empty() ? std::numeric_limits<double>::infinity() : updates.top().time;
+        lookups = 0;
+        cell_updates = 0;
+    }
+
+    void InterpolatedMap::clear()
+    {
+        cols = 0;
+        values.clear();
+        values.shrink_to_fit();
+        changing_cells.clear();
+        changing_cells.shrink_to_fit();
+        present_values.clear();
+        present_values.shrink_to_fit();
+        historical_values.clear();
+        historical_values.shrink_to_fit();
+        updates = IndexedHeap();
+        start = std::numeric_limits<double>::infinity();
+        next_update = std::numeric_limits<double>::infinity();
+        lookups = 0;
+        cell_updates = 0;
+    }
+
+    bool InterpolatedMap::empty() const
+    {
+        return values.empty();
+    }
+}
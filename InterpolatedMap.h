@@ -0,0 +1,156 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file InterpolatedMap.h
+ * @brief Contains the InterpolatedMap class for storing the density of each cell between a present and historical map.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_INTERPOLATEDMAP_H
+#define NECSIM_INTERPOLATEDMAP_H
+
+#include <cstdint>
+#include <vector>
+#include "IndexedHeap.h"
+#include "Matrix.h"
+
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief Stores the density of each cell of a map at the current generation, whilst the density changes linearly
+     * from a present map to a historical map.
+     *
+     * The rounded density of a cell only changes when its interpolated value crosses an integer, so the generation of
+     * the next change is scheduled for each cell which differs between the maps. Moving to a later generation only
+     * recalculates the cells which have changed, and each lookup is otherwise a single read from the raster.
+     *
+     * If the densities change more often than they are read, recalculating them costs more than interpolating on
+     * each lookup, so the raster is released and not used again until it is next generated.
+     */
+    class InterpolatedMap
+    {
+    protected:
+        // Marks a cell whose density does not fit in the raster, and so must be calculated directly.
+        static const uint32_t DIRECT = UINT32_MAX;
+        // The number of lookups needed for each cell recalculation for the raster to be kept.
+        static const unsigned long LOOKUPS_PER_CELL_UPDATE = 16;
+        // The number of cell recalculations before the number of lookups is checked.
+        static const unsigned long MIN_CELL_UPDATES = 4096;
+        // The number of columns in the map.
+        unsigned long cols;
+        // The density of each cell, in row-major order.
+        vector<uint32_t> values;
+        // The index of each cell which differs between the maps.
+        vector<unsigned long> changing_cells;
+        // The present and historical density of each changing cell.
+        vector<double> present_values, historical_values;
+        // The generation at which the density of each changing cell may next change.
+        IndexedHeap updates;
+        // The interpolation variables, as in Landscape.
+        double map_time, historical_time, change_rate;
+        // The densities are correct for generations from start up to, but not including, next_update.
+        double start, next_update;
+        // The number of lookups and cell recalculations since the raster was generated.
+        unsigned long lookups, cell_updates;
+
+        /**
+         * @brief Recalculates the density of the changing cell and finds when it may next change.
+         * @param changing_index the index of the cell in changing_cells
+         * @param generation the generation to calculate the density at
+         * @return the generation at which to next recalculate the cell, which is later than the generation
+         */
+        double updateCell(const unsigned long &changing_index, const double &generation);
+
+        /**
+         * @brief Recalculates the density of each cell which has changed by the generation.
+         * @param generation the generation to move to, which must not be earlier than start
+         */
+        void update(const double &generation);
+
+    public:
+        InterpolatedMap();
+
+        /**
+         * @brief Calculates the density of a cell between the present and historical maps.
+         * @param present the density on the present map
+         * @param historical the density on the historical map
+         * @param map_time_in the generation of the present map
+         * @param historical_time_in the generation of the historical map
+         * @param change_rate_in the rate of change from the present to the historical map
+         * @param generation the generation to calculate the density at
+         * @return the rounded density
+         */
+        static unsigned long interpolate(const double &present,
+                                         const double &historical,
+                                         const double &map_time_in,
+                                         const double &historical_time_in,
+                                         const double &change_rate_in,
+                                         const double &generation);
+
+        /**
+         * @brief Generates the densities at the generation, and schedules the changes after it.
+         * @param present the present map
+         * @param historical the historical map, with the same dimensions as the present map
+         * @param map_time_in the generation of the present map
+         * @param historical_time_in the generation of the historical map
+         * @param change_rate_in the rate of change from the present to the historical map
+         * @param generation the generation to generate the densities at
+         */
+        void generate(const Matrix<uint32_t> &present,
+                      const Matrix<uint32_t> &historical,
+                      const double &map_time_in,
+                      const double &historical_time_in,
+                      const double &change_rate_in,
+                      const double &generation);
+
+        /**
+         * @brief Removes the densities and releases their memory, so that lookups are no longer served until the
+         * densities are next generated.
+         */
+        void clear();
+
+        /**
+         * @brief Checks if the densities have been generated.
+         * @return true if there are no densities
+         */
+        bool empty() const;
+
+        /**
+         * @brief Gets the density of the cell, moving the raster to the generation if it is later.
+         * @param y the row of the cell
+         * @param x the column of the cell
+         * @param generation the generation to get the density at
+         * @param value the density of the cell
+         * @return false if the density must instead be calculated directly, because the generation is before the
+         * raster was generated or the density does not fit in the raster
+         */
+        bool get(const unsigned long &y, const unsigned long &x, const double &generation, unsigned long &value)
+        {
+            if(generation < start)
+            {
+                return false;
+            }
+            lookups++;
+            if(generation >= next_update)
+            {
+                update(generation);
+                // The raster is released by the update if it is no longer worth keeping.
+                if(values.empty())
+                {
+                    return false;
+                }
+            }
+            const uint32_t cell_value = values[y * cols + x];
+            if(cell_value == DIRECT)
+            {
+                return false;
+            }
+            value = cell_value;
+            return true;
+        }
+    };
+}
+#endif //NECSIM_INTERPOLATEDMAP_H
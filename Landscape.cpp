@@ -9,7 +9,10 @@
  */
 #define _USE_MATH_DEFINES
 
+#include <chrono>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 #include <utility>
 #include "Landscape.h"
 #include "file_system.h"
@@ -75,6 +78,50 @@ namespace necsim
         return max_value;
     }
 
+    uint32_t importToPagedMapAndRound(const string &map_file,
+                                      PagedMap<uint32_t> &map_in,
+                                      const unsigned long &map_x,
+                                      const unsigned long &map_y,
+                                      const double &scalar,
+                                      const unsigned long &cache_size)
+    {
+        uint32_t max_value = 0;
+        // Values are rounded to float first, as they are when importing the whole map.
+        if(cache_size > 0 && map_in.importPaged(map_file, map_y, map_x, cache_size, [scalar](const double &value)
+        {
+            return (uint32_t) (std::max(round((double) static_cast<float>(value) * scalar), 0.0));
+        }, max_value))
+        {
+            return max_value;
+        }
+        map_in.clearPages();
+        return importToMapAndRound(map_file, map_in, map_x, map_y, scalar);
+    }
+
+    std::future<shared_ptr<ImportedMap>> importToMapInBackground(const string &map_file,
+                                                                 const unsigned long &map_x,
+                                                                 const unsigned long &map_y,
+                                                                 const double &scalar)
+    {
+        return std::async(std::launch::async, [map_file, map_x, map_y, scalar]()
+        {
+            auto imported = make_shared<ImportedMap>();
+            imported->map_file = map_file;
+            imported->messages.capture();
+            try
+            {
+                imported->max_value = importToMapAndRound(map_file, imported->map, map_x, map_y, scalar);
+            }
+            catch(...)
+            {
+                imported->messages.release();
+                throw;
+            }
+            imported->messages.release();
+            return imported;
+        });
+    }
+
     unsigned long archimedesSpiralX(const double &centre_x,
                                     const double &centre_y,
                                     const double &radius,
@@ -153,6 +200,9 @@ namespace necsim
         }
         // Note that the default "null" type is to have 100% forest cover in every cell.
         fine_max = importToMapAndRound(fileinput, fine_map, mapxsize, mapysize, deme);
+        changing_fine_cells_outdated = true;
+        fine_nearest_habitat_outdated = true;
+        fine_density_outdated = true;
     }
 
     void Landscape::calcHistoricalFineMap()
@@ -166,10 +216,15 @@ namespace necsim
         }
         has_historical = file_input != "none";
         historical_fine_max = 0;
-        if(has_historical)
+        if(has_historical
+           && !takeImportedMap(next_historical_fine_map, file_input, historical_fine_map, historical_fine_max))
         {
             historical_fine_max = importToMapAndRound(file_input, historical_fine_map, map_x_size, map_y_size, deme);
         }
+        changing_fine_cells_outdated = true;
+        fine_nearest_habitat_outdated = true;
+        fine_density_outdated = true;
+        setLandscapeFunctions();
     }
 
     void Landscape::calcCoarseMap()
@@ -185,7 +240,12 @@ namespace necsim
         coarse_max = 0;
         if(has_coarse)
         {
-            coarse_max = importToMapAndRound(file_input, coarse_map, map_x_size, map_y_size, deme);
+            coarse_max = importToPagedMapAndRound(file_input,
+                                                  coarse_map,
+                                                  map_x_size,
+                                                  map_y_size,
+                                                  deme,
+                                                  coarse_map_cache_size);
         }
     }
 
@@ -204,12 +264,22 @@ namespace necsim
             has_historical = file_input != "none";
             if(has_historical)
             {
-                historical_coarse_max = importToMapAndRound(file_input,
-                                                            historical_coarse_map,
-                                                            map_x_size,
-                                                            map_y_size,
-                                                            deme);
+                // Maps imported in the background are stored whole, so any tiles of the previous map are removed.
+                historical_coarse_map.clearPages();
+                if(!takeImportedMap(next_historical_coarse_map,
+                                    file_input,
+                                    historical_coarse_map,
+                                    historical_coarse_max))
+                {
+                    historical_coarse_max = importToPagedMapAndRound(file_input,
+                                                                     historical_coarse_map,
+                                                                     map_x_size,
+                                                                     map_y_size,
+                                                                     deme,
+                                                                     coarse_map_cache_size);
+                }
             }
+            setLandscapeFunctions();
         }
     }
 
@@ -490,6 +560,10 @@ namespace necsim
         // only update the map if the historical state has not been reached.
         if(!mapvars->is_historical && has_historical)
         {
+            if(!next_historical_started)
+            {
+                prefetchHistoricalMaps();
+            }
             if(mapvars->gen_since_historical < generation)
             {
                 // Only update the map if the maps have actually changed
@@ -498,19 +572,47 @@ namespace necsim
                     std::stringstream ss;
                     ss << "\nUpdating historical maps at " << generation << "...\n";
                     writeInfo(ss.str());
+                    const auto update_start = std::chrono::steady_clock::now();
                     fine_max = historical_fine_max;
-                    fine_map = historical_fine_map;
+                    changing_fine_cells_outdated = true;
+                    fine_nearest_habitat_outdated = true;
+                    fine_density_outdated = true;
                     coarse_max = historical_coarse_max;
-                    coarse_map = historical_coarse_map;
                     if(mapvars->setHistorical(generation))
                     {
+                        // The historical maps are about to be replaced by the next historical maps, so they can be
+                        // exchanged with the current maps rather than copied.
+                        if(mapvars->historical_fine_map_file != "none")
+                        {
+                            fine_map.swap(historical_fine_map);
+                        }
+                        else
+                        {
+                            fine_map = historical_fine_map;
+                        }
+                        if(has_coarse && mapvars->historical_coarse_map_file != "none")
+                        {
+                            coarse_map.swap(historical_coarse_map);
+                        }
+                        else
+                        {
+                            coarse_map = historical_coarse_map;
+                        }
                         doUpdate();
+                        prefetchHistoricalMaps();
                     }
                     else
                     {
+                        fine_map = historical_fine_map;
+                        coarse_map = historical_coarse_map;
+                        fine_density.clear();
                         recalculateHabitatMax();
                     }
-
+                    ss.str("");
+                    ss << "Historical maps updated in "
+                       << std::chrono::duration<double>(std::chrono::steady_clock::now() - update_start).count()
+                       << " seconds.\n";
+                    writeInfo(ss.str());
                     return true;
                 }
             }
@@ -518,6 +620,51 @@ namespace necsim
         return false;
     }
 
+    void Landscape::prefetchHistoricalMaps()
+    {
+        next_historical_started = true;
+        HistoricalMapParameters next_parameters;
+        if(!mapvars->getNextHistorical(next_parameters))
+        {
+            return;
+        }
+        if(next_parameters.fine_map_file != "none")
+        {
+            next_historical_fine_map = importToMapInBackground(next_parameters.fine_map_file,
+                                                               mapvars->fine_map_x_size,
+                                                               mapvars->fine_map_y_size,
+                                                               deme);
+        }
+        // Coarse maps which may be read in tiles are opened when they are needed instead.
+        if(has_coarse && next_parameters.coarse_map_file != "none" && coarse_map_cache_size == 0)
+        {
+            next_historical_coarse_map = importToMapInBackground(next_parameters.coarse_map_file,
+                                                                 mapvars->coarse_map_x_size,
+                                                                 mapvars->coarse_map_y_size,
+                                                                 deme);
+        }
+    }
+
+    bool Landscape::takeImportedMap(std::future<shared_ptr<ImportedMap>> &next_map,
+                                    const string &map_file,
+                                    Map<uint32_t> &map_out,
+                                    unsigned long &max_out)
+    {
+        if(!next_map.valid())
+        {
+            return false;
+        }
+        shared_ptr<ImportedMap> imported = next_map.get();
+        imported->messages.writeOut();
+        if(imported->map_file != map_file)
+        {
+            return false;
+        }
+        map_out.swap(imported->map);
+        max_out = imported->max_value;
+        return true;
+    }
+
     bool Landscape::requiresUpdate()
     {
         return !mapvars->is_historical && has_historical;
@@ -551,27 +698,65 @@ namespace necsim
         if(landscape_type == "infinite")
         {
             writeInfo("Setting infinite landscape.\n");
-            getValFunc = &Landscape::getValInfinite;
+            boundary = LandscapeBoundary::infinite;
         }
         else if(landscape_type == "tiled_coarse")
         {
             writeInfo("Setting tiled coarse infinite landscape.\n");
-            getValFunc = &Landscape::getValCoarseTiled;
+            boundary = LandscapeBoundary::tiled_coarse;
         }
         else if(landscape_type == "tiled_fine")
         {
             writeInfo("Setting tiled fine infinite landscape.\n");
-            getValFunc = &Landscape::getValFineTiled;
+            boundary = LandscapeBoundary::tiled_fine;
         }
         else if(landscape_type == "closed")
         {
             infinite_boundaries = false;
-            getValFunc = &Landscape::getValFinite;
+            boundary = LandscapeBoundary::closed;
         }
         else
         {
             throw FatalException("Provided landscape type is not a valid option: " + landscape_type);
         }
+        setLandscapeFunctions();
+    }
+
+    void Landscape::setLandscapeFunctions()
+    {
+        switch(boundary)
+        {
+            case LandscapeBoundary::closed:
+                setLandscapeFunctions<LandscapeBoundary::closed>();
+                break;
+
+            case LandscapeBoundary::infinite:
+                setLandscapeFunctions<LandscapeBoundary::infinite>();
+                break;
+
+            case LandscapeBoundary::tiled_coarse:
+                setLandscapeFunctions<LandscapeBoundary::tiled_coarse>();
+                break;
+
+            case LandscapeBoundary::tiled_fine:
+                setLandscapeFunctions<LandscapeBoundary::tiled_fine>();
+                break;
+        }
+    }
+
+    template<LandscapeBoundary landscape_boundary>
+    void Landscape::setLandscapeFunctions()
+    {
+        if(has_historical)
+        {
+            getValFunc = &Landscape::getValIn<landscape_boundary, true>;
+            runDispersalFunc = &Landscape::runDispersalIn<landscape_boundary, true>;
+        }
+        else
+        {
+            getValFunc = &Landscape::getValIn<landscape_boundary, false>;
+            runDispersalFunc = &Landscape::runDispersalIn<landscape_boundary, false>;
+        }
     }
 
     unsigned long Landscape::getVal(const double &x,
@@ -589,15 +774,11 @@ namespace necsim
                                             const long &ywrap,
                                             const double &current_generation)
     {
-        double xval, yval;
-        xval = x + (x_dim * xwrap);
-        yval = y + (y_dim * ywrap);
-        //		// return 0 if the requested coordinate is completely outside the map
-        if(xval < coarse_x_min || xval >= coarse_x_max || yval < coarse_y_min || yval >= coarse_y_max)
+        if(has_historical)
         {
-            return (unsigned long) std::max(deme, 1.0);
+            return getValIn<LandscapeBoundary::infinite, true>(x, y, xwrap, ywrap, current_generation);
         }
-        return getValFinite(x, y, xwrap, ywrap, current_generation);
+        return getValIn<LandscapeBoundary::infinite, false>(x, y, xwrap, ywrap, current_generation);
     }
 
     unsigned long Landscape::getValCoarseTiled(const double &x,
@@ -606,17 +787,11 @@ namespace necsim
                                                const long &ywrap,
                                                const double &current_generation)
     {
-        double newx = fmod(x + (xwrap * x_dim) + fine_x_offset + coarse_x_offset, coarse_map.getCols());
-        double newy = fmod(y + (ywrap * y_dim) + fine_x_offset + coarse_x_offset, coarse_map.getRows());
-        if(newx < 0)
-        {
-            newx += coarse_map.getCols();
-        }
-        if(newy < 0)
+        if(has_historical)
         {
-            newy += coarse_map.getRows();
+            return getValIn<LandscapeBoundary::tiled_coarse, true>(x, y, xwrap, ywrap, current_generation);
         }
-        return getValCoarse(newx, newy, current_generation);
+        return getValIn<LandscapeBoundary::tiled_coarse, false>(x, y, xwrap, ywrap, current_generation);
     }
 
     unsigned long Landscape::getValFineTiled(const double &x,
@@ -625,29 +800,11 @@ namespace necsim
                                              const long &ywrap,
                                              const double &current_generation)
     {
-
-        double newx = fmod(x + (xwrap * x_dim) + fine_x_offset, fine_map.getCols());
-        double newy = fmod(y + (ywrap * y_dim) + fine_y_offset, fine_map.getRows());
-        // Now adjust for incorrect wrapping behaviour of fmod
-        if(newx < 0)
-        {
-            newx += fine_map.getCols();
-        }
-        if(newy < 0)
-        {
-            newy += fine_map.getRows();
-        }
-#ifdef DEBUG
-        if(newx >= fine_map.getCols() || newx < 0 || newy >= fine_map.getRows() || newy < 0)
+        if(has_historical)
         {
-            std::stringstream ss;
-            ss << "Fine map indexing out of range of fine map." << std::endl;
-            ss << "x, y: " << newx << ", " << newy << std::endl;
-            ss << "cols, rows: " << fine_map.getCols() << ", " << fine_map.getRows() << std::endl;
-            throw std::out_of_range (ss.str());
+            return getValIn<LandscapeBoundary::tiled_fine, true>(x, y, xwrap, ywrap, current_generation);
         }
-#endif
-        return getValFine(newx, newy, current_generation);
+        return getValIn<LandscapeBoundary::tiled_fine, false>(x, y, xwrap, ywrap, current_generation);
     }
 
     unsigned long Landscape::getValCoarseClamped(const double &x,
@@ -675,8 +832,27 @@ namespace necsim
 
     unsigned long Landscape::getValCoarse(const double &xval, const double &yval, const double &current_generation)
     {
-        unsigned long retval = 0;
         if(has_historical)
+        {
+            return getValCoarseIn<true>(xval, yval, current_generation);
+        }
+        return getValCoarseIn<false>(xval, yval, current_generation);
+    }
+
+    unsigned long Landscape::getValFine(const double &xval, const double &yval, const double &current_generation)
+    {
+        if(has_historical)
+        {
+            return getValFineIn<true>(xval, yval, current_generation);
+        }
+        return getValFineIn<false>(xval, yval, current_generation);
+    }
+
+    template<bool historical>
+    unsigned long Landscape::getValCoarseIn(const double &xval, const double &yval, const double &current_generation)
+    {
+        unsigned long retval = 0;
+        if constexpr(historical)
         {
             if(is_historical || historical_coarse_map.get(yval, xval) == coarse_map.get(yval, xval))
             {
@@ -714,32 +890,70 @@ namespace necsim
         return retval;
     }
 
-    unsigned long Landscape::getValFine(const double &xval, const double &yval, const double &current_generation)
+    template<bool historical>
+    unsigned long Landscape::getValFineIn(const double &xval, const double &yval, const double &current_generation)
     {
         unsigned long retval = 0;
-        if(has_historical)
+        if constexpr(historical)
         {
+            if(materialise_density && !is_historical)
+            {
+                if(fine_density_outdated)
+                {
+                    fine_density.generate(fine_map,
+                                          historical_fine_map,
+                                          current_map_time,
+                                          gen_since_historical,
+                                          habitat_change_rate,
+                                          current_generation);
+                    fine_density_outdated = false;
+                }
+                if(fine_density.get(static_cast<unsigned long>(yval),
+                                    static_cast<unsigned long>(xval),
+                                    current_generation,
+                                    retval))
+                {
+#ifdef DEBUG
+                    const uint32_t historical_value = historical_fine_map.get(yval, xval);
+                    const uint32_t present_value = fine_map.get(yval, xval);
+                    const unsigned long direct_value = historical_value == present_value ? historical_value :
+                                                       InterpolatedMap::interpolate(present_value,
+                                                                                    historical_value,
+                                                                                    current_map_time,
+                                                                                    gen_since_historical,
+                                                                                    habitat_change_rate,
+                                                                                    current_generation);
+                    if(retval != direct_value)
+                    {
+                        std::stringstream ss;
+                        ss << "Materialised density of " << retval << " at " << xval << ", " << yval
+                           << " does not match the interpolated density of " << direct_value << " at generation "
+                           << current_generation << ". Please report this bug." << std::endl;
+                        throw FatalException(ss.str());
+                    }
+#endif // DEBUG
+                    return retval;
+                }
+            }
             if(is_historical || historical_fine_map.get(yval, xval) == fine_map.get(yval, xval))
             {
                 retval = historical_fine_map.get(yval, xval);
             }
             else
             {
-                double currentTime = current_generation - current_map_time;
 #ifdef historical_mode
+                double currentTime = current_generation - current_map_time;
                 retval = (unsigned long)floor(fine_map.get(yval, xval) +
                                                (habitat_change_rate * ((historical_fine_map.get(yval, xval) -
                                                fine_map.get(yval, xval)) /
                                                        (gen_since_historical-current_map_time)) * currentTime));
 #else
-                retval = (unsigned long) floor(fine_map.get(yval, xval) + (habitat_change_rate
-                                                                           * ((static_cast<double>(historical_fine_map.get(
-                                                                                   yval,
-                                                                                   xval))
-                                                                               - static_cast<double>(fine_map.get(yval,
-                                                                                                                  xval)))
-                                                                              / (gen_since_historical
-                                                                                 - current_map_time)) * currentTime));
+                retval = InterpolatedMap::interpolate(fine_map.get(yval, xval),
+                                                      historical_fine_map.get(yval, xval),
+                                                      current_map_time,
+                                                      gen_since_historical,
+                                                      habitat_change_rate,
+                                                      current_generation);
 #endif
             }
         }
@@ -749,7 +963,7 @@ namespace necsim
         }
         // Note that debug mode will throw an exception if the returned value is less than the historical state
 #ifdef historical_mode
-        if(has_historical)
+        if(historical)
         {
             if(retval > historical_fine_map.get(yval, xval))
             {
@@ -767,32 +981,91 @@ namespace necsim
                                           const long &ywrap,
                                           const double &current_generation)
     {
+        if(has_historical)
+        {
+            return getValIn<LandscapeBoundary::closed, true>(x, y, xwrap, ywrap, current_generation);
+        }
+        return getValIn<LandscapeBoundary::closed, false>(x, y, xwrap, ywrap, current_generation);
+    }
 
-        double xval, yval;
-        xval = x + (x_dim * xwrap);  //
-        yval = y + (y_dim * ywrap);
-        //		// return 0 if the requested coordinate is completely outside the map
-        if(xval < coarse_x_min || xval >= coarse_x_max || yval < coarse_y_min || yval >= coarse_y_max)
+    template<LandscapeBoundary landscape_boundary, bool historical>
+    unsigned long Landscape::getValIn(const double &x,
+                                      const double &y,
+                                      const long &xwrap,
+                                      const long &ywrap,
+                                      const double &current_generation)
+    {
+        if constexpr(landscape_boundary == LandscapeBoundary::tiled_coarse)
         {
-            return 0;
+            double newx = fmod(x + (xwrap * x_dim) + fine_x_offset + coarse_x_offset, coarse_map.getCols());
+            double newy = fmod(y + (ywrap * y_dim) + fine_x_offset + coarse_x_offset, coarse_map.getRows());
+            if(newx < 0)
+            {
+                newx += coarse_map.getCols();
+            }
+            if(newy < 0)
+            {
+                newy += coarse_map.getRows();
+            }
+            return getValCoarseIn<historical>(newx, newy, current_generation);
         }
-        if((xval < fine_x_min || xval >= fine_x_max || yval < fine_y_min || yval >= fine_y_max)
-           && has_coarse)  // check if the coordinate comes from the coarse resolution map.
+        else if constexpr(landscape_boundary == LandscapeBoundary::tiled_fine)
         {
+            double newx = fmod(x + (xwrap * x_dim) + fine_x_offset, fine_map.getCols());
+            double newy = fmod(y + (ywrap * y_dim) + fine_y_offset, fine_map.getRows());
+            // Now adjust for incorrect wrapping behaviour of fmod
+            if(newx < 0)
+            {
+                newx += fine_map.getCols();
+            }
+            if(newy < 0)
+            {
+                newy += fine_map.getRows();
+            }
+#ifdef DEBUG
+            if(newx >= fine_map.getCols() || newx < 0 || newy >= fine_map.getRows() || newy < 0)
+            {
+                std::stringstream ss;
+                ss << "Fine map indexing out of range of fine map." << std::endl;
+                ss << "x, y: " << newx << ", " << newy << std::endl;
+                ss << "cols, rows: " << fine_map.getCols() << ", " << fine_map.getRows() << std::endl;
+                throw std::out_of_range (ss.str());
+            }
+#endif
+            return getValFineIn<historical>(newx, newy, current_generation);
+        }
+        else
+        {
+            double xval, yval;
+            xval = x + (x_dim * xwrap);  //
+            yval = y + (y_dim * ywrap);
+            //		// return 0 if the requested coordinate is completely outside the map
+            if(xval < coarse_x_min || xval >= coarse_x_max || yval < coarse_y_min || yval >= coarse_y_max)
+            {
+                // infinite landscapes are completely habitat outside the maps
+                if constexpr(landscape_boundary == LandscapeBoundary::infinite)
+                {
+                    return (unsigned long) std::max(deme, 1.0);
+                }
+                return 0;
+            }
+            if((xval < fine_x_min || xval >= fine_x_max || yval < fine_y_min || yval >= fine_y_max)
+               && has_coarse)  // check if the coordinate comes from the coarse resolution map.
+            {
+                // take in to account the fine map offsetting
+                xval += fine_x_offset;
+                yval += fine_y_offset;
+                // take in to account the coarse map offsetting and the increased scale of the larger map.
+                xval = floor((xval + coarse_x_offset) / scale);
+                yval = floor((yval + coarse_y_offset) / scale);
+                return getValCoarseIn<historical>(xval, yval, current_generation);
+            }
             // take in to account the fine map offsetting
+            // this is done twice to avoid having all the comparisons involve additions.
             xval += fine_x_offset;
             yval += fine_y_offset;
-            // take in to account the coarse map offsetting and the increased scale of the larger map.
-            xval = floor((xval + coarse_x_offset) / scale);
-            yval = floor((yval + coarse_y_offset) / scale);
-            return getValCoarse(xval, yval, current_generation);
+            return getValFineIn<historical>(xval, yval, current_generation);
         }
-        // take in to account the fine map offsetting
-        // this is done twice to avoid having all the comparisons involve additions.
-        xval += fine_x_offset;
-        yval += fine_y_offset;
-        return getValFine(xval, yval, current_generation);
-
     }
 
     unsigned long Landscape::convertSampleXToFineX(const unsigned long &x, const long &xwrap) const
@@ -911,6 +1184,19 @@ namespace necsim
                                           long &startywrap,
                                           bool &disp_comp,
                                           const double &generation)
+    {
+        return (this->*runDispersalFunc)(dist, angle, startx, starty, startxwrap, startywrap, disp_comp, generation);
+    }
+
+    template<LandscapeBoundary landscape_boundary, bool historical>
+    unsigned long Landscape::runDispersalIn(const double &dist,
+                                            const double &angle,
+                                            long &startx,
+                                            long &starty,
+                                            long &startxwrap,
+                                            long &startywrap,
+                                            bool &disp_comp,
+                                            const double &generation)
     {
         // Checks that the start point is not out of matrix - this might have to be disabled to ensure that when updating the
         // map, it doesn't cause problems.
@@ -938,7 +1224,7 @@ namespace necsim
             throw FatalException("Using dispersal relative cost is deprecated.");
 
         }
-        unsigned long ret = getVal(newx, newy, 0, 0, generation);
+        unsigned long ret = getValIn<landscape_boundary, historical>(newx, newy, 0, 0, generation);
         if(ret > 0)
         {
             long newxwrap, newywrap;
@@ -984,7 +1270,8 @@ namespace necsim
     {
         double theta = 0;
         double radius = 1.0;
-        if(!getVal(end_x, end_y, start_x_wrap, start_y_wrap, generation))
+        if(!getVal(end_x, end_y, start_x_wrap, start_y_wrap, generation)
+           && !findNearestFineHabitatCell(start_x, start_y, start_x_wrap, start_y_wrap, end_x, end_y, generation))
         {
             while(true)
             {
@@ -1027,6 +1314,106 @@ namespace necsim
         }
     }
 
+    void Landscape::calcFineNearestHabitat(const double &generation)
+    {
+        const unsigned long rows = fine_map.getRows();
+        const unsigned long cols = fine_map.getCols();
+        fine_nearest_habitat_outdated = false;
+        fine_nearest_habitat_historical = is_historical;
+        fine_nearest_habitat_start = generation;
+        fine_nearest_habitat_end = std::numeric_limits<double>::infinity();
+        if(!DistanceTransform::canGenerate(rows, cols))
+        {
+            fine_nearest_habitat.clear();
+            return;
+        }
+        vector<bool> habitat(rows * cols);
+        for(unsigned long y = 0; y < rows; y++)
+        {
+            for(unsigned long x = 0; x < cols; x++)
+            {
+                habitat[y * cols + x] = getValFine(x, y, generation) != 0;
+            }
+        }
+        fine_nearest_habitat.generate(rows, cols, habitat);
+        if(has_historical && !is_historical)
+        {
+            fine_nearest_habitat_end = gen_since_historical;
+            // Each changing cell contains habitat while its interpolated density is at least one, so find the next
+            // generation at which any of them crosses that threshold.
+            const double gradient = habitat_change_rate / (gen_since_historical - current_map_time);
+            for(const auto &cell : getChangingFineCells())
+            {
+                const auto current = static_cast<double>(fine_map.get(cell.y, cell.x));
+                const auto historical = static_cast<double>(historical_fine_map.get(cell.y, cell.x));
+                const double change = gradient * (historical - current);
+                if(change == 0.0)
+                {
+                    continue;
+                }
+                const double crossing = current_map_time + (1.0 - current) / change;
+                if(crossing > generation)
+                {
+                    fine_nearest_habitat_end = std::min(fine_nearest_habitat_end, crossing);
+                }
+            }
+        }
+    }
+
+    bool Landscape::findNearestFineHabitatCell(const long &start_x,
+                                               const long &start_y,
+                                               const long &start_x_wrap,
+                                               const long &start_y_wrap,
+                                               double &end_x,
+                                               double &end_y,
+                                               const double &generation)
+    {
+        const long x_val = start_x + x_dim * start_x_wrap;
+        const long y_val = start_y + y_dim * start_y_wrap;
+        if(x_val < fine_x_min || x_val >= fine_x_max || y_val < fine_y_min || y_val >= fine_y_max)
+        {
+            return false;
+        }
+        if(fine_nearest_habitat_outdated || fine_nearest_habitat_historical != is_historical
+           || generation < fine_nearest_habitat_start || generation >= fine_nearest_habitat_end)
+        {
+            calcFineNearestHabitat(generation);
+        }
+        const auto fine_x = static_cast<unsigned long>(x_val + fine_x_offset);
+        const auto fine_y = static_cast<unsigned long>(y_val + fine_y_offset);
+        unsigned long nearest_x, nearest_y;
+        if(fine_nearest_habitat.empty() || !fine_nearest_habitat.getNearest(fine_y, fine_x, nearest_y, nearest_x))
+        {
+            return false;
+        }
+        if(!getValFine(nearest_x, nearest_y, generation))
+        {
+            // The crossing generation was within rounding error of this generation.
+            calcFineNearestHabitat(generation);
+            if(!fine_nearest_habitat.getNearest(fine_y, fine_x, nearest_y, nearest_x))
+            {
+                return false;
+            }
+        }
+        if(has_coarse || infinite_boundaries)
+        {
+            // Habitat outside the fine map could be closer than the habitat found.
+            const long x_distance = static_cast<long>(nearest_x) - static_cast<long>(fine_x);
+            const long y_distance = static_cast<long>(nearest_y) - static_cast<long>(fine_y);
+            const long edge_distance = std::min(std::min(static_cast<long>(fine_x) + 1,
+                                                         static_cast<long>(fine_map.getCols() - fine_x)),
+                                                std::min(static_cast<long>(fine_y) + 1,
+                                                         static_cast<long>(fine_map.getRows() - fine_y)));
+            if(x_distance * x_distance + y_distance * y_distance > edge_distance * edge_distance)
+            {
+                return false;
+            }
+        }
+        end_x = static_cast<double>(static_cast<long>(nearest_x) - fine_x_offset - x_dim * start_x_wrap);
+        end_y = static_cast<double>(static_cast<long>(nearest_y) - fine_y_offset - y_dim * start_y_wrap);
+        return true;
+    }
+
     bool Landscape::findAnyHabitatCell(const long &start_x,
                                        const long &start_y,
                                        const long &start_x_wrap,
@@ -1099,6 +1486,8 @@ namespace necsim
         current_map_time = 0;
         check_set_dim = false;
         is_historical = false;
+        fine_nearest_habitat_outdated = true;
+        fine_density_outdated = true;
     }
 
     string Landscape::printVars()
@@ -1123,12 +1512,37 @@ namespace necsim
         return has_historical;
     }
 
+    const vector<Cell> &Landscape::getChangingFineCells()
+    {
+        if(changing_fine_cells_outdated)
+        {
+            changing_fine_cells.clear();
+            // Once the final historical map has been reached, the fine map is a copy of it.
+            if(requiresUpdate() && fine_map.getRows() == historical_fine_map.getRows()
+               && fine_map.getCols() == historical_fine_map.getCols())
+            {
+                for(unsigned long y = 0; y < fine_map.getRows(); y++)
+                {
+                    for(unsigned long x = 0; x < fine_map.getCols(); x++)
+                    {
+                        if(fine_map.get(y, x) != historical_fine_map.get(y, x))
+                        {
+                            changing_fine_cells.emplace_back(x, y);
+                        }
+                    }
+                }
+            }
+            changing_fine_cells_outdated = false;
+        }
+        return changing_fine_cells;
+    }
+
     Map<uint32_t> &Landscape::getFineMap()
     {
         return fine_map;
     }
 
-    Map<uint32_t> &Landscape::getCoarseMap()
+    PagedMap<uint32_t> &Landscape::getCoarseMap()
     {
         return coarse_map;
     }
@@ -1138,7 +1552,7 @@ namespace necsim
         return fine_map;
     }
 
-    const Map<uint32_t> &Landscape::getCoarseMap() const
+    const PagedMap<uint32_t> &Landscape::getCoarseMap() const
     {
         return coarse_map;
     }
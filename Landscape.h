@@ -20,11 +20,17 @@
 #include <cmath>
 #include <stdexcept>
 #include <memory>
+#include <future>
 
 #include "cpp17_includes.h"
 #include "Map.h"
+#include "PagedMap.h"
 #include "DataMask.h"
 #include "SimParameters.h"
+#include "Cell.h"
+#include "DistanceTransform.h"
+#include "InterpolatedMap.h"
+#include "Logging.h"
 
 
 namespace necsim
@@ -46,6 +52,48 @@ namespace necsim
                                  unsigned long map_y,
                                  double scalar);
 
+    /**
+     * @brief Imports the map as importToMapAndRound() does, unless a cache size is given and the map is a .tif file, in
+     * which case the map is opened to be read in tiles when they are needed.
+     * @param map_file the path to the map file to import
+     * @param map_in the map to import to
+     * @param map_x the x dimension of the matrix
+     * @param map_y the y dimension of the matrix
+     * @param scalar the scalar to multiply all values in the final matrix by (before rounding to integer)
+     * @param cache_size the memory in bytes for keeping tiles of the map, or 0 to import the whole map
+     * @return the maximum value from the imported matrix
+     */
+    uint32_t importToPagedMapAndRound(const string &map_file,
+                                      PagedMap<uint32_t> &map_in,
+                                      const unsigned long &map_x,
+                                      const unsigned long &map_y,
+                                      const double &scalar,
+                                      const unsigned long &cache_size);
+
+    /**
+     * @brief A map imported on a background thread, along with the messages written whilst importing it.
+     */
+    struct ImportedMap
+    {
+        string map_file;
+        Map<uint32_t> map;
+        uint32_t max_value = 0;
+        LogCapture messages;
+    };
+
+    /**
+     * @brief Starts importing the map on a background thread, as importToMapAndRound() does.
+     * @param map_file the path to the map file to import
+     * @param map_x the x dimension of the matrix
+     * @param map_y the y dimension of the matrix
+     * @param scalar the scalar to multiply all values in the final matrix by (before rounding to integer)
+     * @return the imported map, once the import is complete
+     */
+    std::future<shared_ptr<ImportedMap>> importToMapInBackground(const string &map_file,
+                                                                 const unsigned long &map_x,
+                                                                 const unsigned long &map_y,
+                                                                 const double &scalar);
+
     /**
      * @brief Gets the x coordinate of the archimedes spiral
      * @param centre_x the x coordinate of the spiral centre
@@ -80,6 +128,17 @@ namespace necsim
      */
     double calculateDistance(const double &start_x, const double &start_y, const double &end_x, const double &end_y);
 
+    /**
+     * @brief The behaviour of the landscape outside the fine and coarse maps.
+     */
+    enum class LandscapeBoundary
+    {
+        closed,
+        infinite,
+        tiled_coarse,
+        tiled_fine
+    };
+
     /**
      * @class Landscape
      * @brief Contains all maps and provides the functions for accessing a grid cell in the correct temporal and spacial
@@ -105,10 +164,10 @@ namespace necsim
         Map<uint32_t> fine_map;
         // the historical finer map.
         Map<uint32_t> historical_fine_map;
-        // the coarser grid for the wider zone.
-        Map<uint32_t> coarse_map;
+        // the coarser grid for the wider zone, which may be read in tiles when needed.
+        PagedMap<uint32_t> coarse_map;
         // the historical coarser map.
-        Map<uint32_t> historical_coarse_map;
+        PagedMap<uint32_t> historical_coarse_map;
         // for importing and storing the simulation set-up options.
         shared_ptr<SimParameters> mapvars;
         // the minimum values for each dimension for offsetting.
@@ -158,6 +217,33 @@ namespace necsim
         string next_map;
         // If this is false, there is no coarse map defined, so ignore the boundaries.
         bool has_coarse;
+        // The cells of the fine map which differ from the historical fine map, and so change over time.
+        vector<Cell> changing_fine_cells;
+        // True if the fine or historical fine map has changed since changing_fine_cells was found.
+        bool changing_fine_cells_outdated;
+        // The nearest habitat cell to each cell of the fine map.
+        DistanceTransform fine_nearest_habitat;
+        // True if the fine or historical fine map has changed since fine_nearest_habitat was generated.
+        bool fine_nearest_habitat_outdated;
+        // True if fine_nearest_habitat was generated after the historical state was reached.
+        bool fine_nearest_habitat_historical;
+        // The generations between which no fine cell changes between habitat and non-habitat, so that
+        // fine_nearest_habitat remains correct.
+        double fine_nearest_habitat_start, fine_nearest_habitat_end;
+        // If true, the fine map densities between the present and historical maps are stored in fine_density, rather
+        // than being interpolated on every call. This is only safe if the landscape is used by a single thread.
+        bool materialise_density;
+        // The fine map densities at the current generation, whilst between the present and historical maps.
+        InterpolatedMap fine_density;
+        // True if the fine or historical fine map has changed since fine_density was generated.
+        bool fine_density_outdated;
+        // The historical maps which follow the current historical maps, imported on background threads.
+        std::future<shared_ptr<ImportedMap>> next_historical_fine_map, next_historical_coarse_map;
+        // True if the import of the next historical maps has been started.
+        bool next_historical_started;
+        // The memory in bytes for keeping tiles of each coarse map read from a .tif file, or 0 to import the coarse
+        // maps whole.
+        unsigned long coarse_map_cache_size;
 
         // Typedef for single application of the infinite landscape verses bounded landscape.
         typedef unsigned long (Landscape::*fptr)(const double &x,
@@ -167,6 +253,100 @@ namespace necsim
                                                  const double &dCurrentGen);
 
         fptr getValFunc;
+
+        // Typedef for the move routine specialised for the landscape type.
+        typedef unsigned long (Landscape::*dispersal_fptr)(const double &dist,
+                                                           const double &angle,
+                                                           long &startx,
+                                                           long &starty,
+                                                           long &startxwrap,
+                                                           long &startywrap,
+                                                           bool &disp_comp,
+                                                           const double &generation);
+
+        dispersal_fptr runDispersalFunc;
+        // The behaviour of the landscape outside the maps, chosen by setLandscape().
+        LandscapeBoundary boundary;
+
+        /**
+         * @brief Gets the value from the fine maps, specialised for whether there are historical maps.
+         * @tparam historical true if there are historical maps to interpolate between
+         * @param xval the x coordinate
+         * @param yval the y coordinate
+         * @param current_generation the current generation timer
+         * @return the value of the map at the given coordinates and time
+         */
+        template<bool historical>
+        unsigned long getValFineIn(const double &xval, const double &yval, const double &current_generation);
+
+        /**
+         * @brief Gets the value from the coarse maps, specialised for whether there are historical maps.
+         * @tparam historical true if there are historical maps to interpolate between
+         * @param xval the x coordinate
+         * @param yval the y coordinate
+         * @param current_generation the current generation timer
+         * @return the value of the map at the given coordinates and time
+         */
+        template<bool historical>
+        unsigned long getValCoarseIn(const double &xval, const double &yval, const double &current_generation);
+
+        /**
+         * @brief Gets the value at a particular coordinate from the correct map, specialised for the landscape type.
+         *
+         * Each specialisation inlines the map lookups, so that getVal() makes a single call through getValFunc.
+         * @tparam landscape_boundary the behaviour of the landscape outside the maps
+         * @tparam historical true if there are historical maps to interpolate between
+         * @param x the x position on the grid.
+         * @param y the y position on the grid.
+         * @param xwrap the number of wraps in the x dimension..
+         * @param ywrap the number of wraps in the y dimension..
+         * @param current_generation the current generation time.
+         * @return the value on the correct map at the correct space.
+         */
+        template<LandscapeBoundary landscape_boundary, bool historical>
+        unsigned long getValIn(const double &x,
+                               const double &y,
+                               const long &xwrap,
+                               const long &ywrap,
+                               const double &current_generation);
+
+        /**
+         * @brief The move routine for runDispersal(), specialised for the landscape type.
+         * @tparam landscape_boundary the behaviour of the landscape outside the maps
+         * @tparam historical true if there are historical maps to interpolate between
+         * @param dist the distance travelled.
+         * @param angle the angle of movement.
+         * @param startx the start x position.
+         * @param starty the start y position.
+         * @param startxwrap the start x wrapping.
+         * @param startywrap the start y wrapping.
+         * @param disp_comp set to true if the dispersal was to a non-habitat cell.
+         * @param generation the time in generations since the start of the simulation.
+         * @return the density value at the end dispersal point
+         */
+        template<LandscapeBoundary landscape_boundary, bool historical>
+        unsigned long runDispersalIn(const double &dist,
+                                     const double &angle,
+                                     long &startx,
+                                     long &starty,
+                                     long &startxwrap,
+                                     long &startywrap,
+                                     bool &disp_comp,
+                                     const double &generation);
+
+        /**
+         * @brief Points getValFunc and runDispersalFunc at the specialisations for the landscape type.
+         *
+         * Must be called whenever the landscape type or the presence of historical maps changes.
+         */
+        void setLandscapeFunctions();
+
+        /**
+         * @brief Points getValFunc and runDispersalFunc at the specialisations for the given landscape type.
+         * @tparam landscape_boundary the behaviour of the landscape outside the maps
+         */
+        template<LandscapeBoundary landscape_boundary>
+        void setLandscapeFunctions();
     public:
         /**
          * @brief The default constructor.
@@ -179,7 +359,12 @@ namespace necsim
                       gen_since_historical(1.0), current_map_time(0.0), is_historical(false), has_historical(false),
                       habitat_max(1), fine_max(0), coarse_max(0), historical_fine_max(0), historical_coarse_max(0),
                       landscape_type("closed"), infinite_boundaries(false), next_map(""), has_coarse(false),
-                      getValFunc(nullptr)
+                      changing_fine_cells(), changing_fine_cells_outdated(true), fine_nearest_habitat(),
+                      fine_nearest_habitat_outdated(true), fine_nearest_habitat_historical(false),
+                      fine_nearest_habitat_start(0.0), fine_nearest_habitat_end(0.0), materialise_density(false),
+                      fine_density(), fine_density_outdated(true), next_historical_fine_map(),
+                      next_historical_coarse_map(), next_historical_started(false), coarse_map_cache_size(0),
+                      getValFunc(nullptr), runDispersalFunc(nullptr), boundary(LandscapeBoundary::closed)
         {
             setLandscape("closed");
         }
@@ -196,6 +381,19 @@ namespace necsim
          */
         bool hasHistorical();
 
+        /**
+         * @brief Gets the cells of the fine map whose density changes over time.
+         *
+         * These are the cells in which the fine map differs from the historical fine map, and are the only cells for
+         * which getValFine() can change as the generation increases or the maps are updated.
+         *
+         * The list is found by comparing every cell of the two maps, once for each pair of fine and historical fine
+         * maps, so each map update costs one pass over the fine map here, as does the import of the next historical
+         * map. No pass is made once the final historical map has been reached.
+         * @return the changing cells, with x and y as the column and row of the fine map
+         */
+        const vector<Cell> &getChangingFineCells();
+
         /**
          * @brief Gets the fine map object
          * @return reference to the fine map
@@ -206,7 +404,7 @@ namespace necsim
          * @brief Gets the coarse map object
          * @return reference to the coarse map
          */
-        Map<uint32_t> &getCoarseMap();
+        PagedMap<uint32_t> &getCoarseMap();
 
         /**
          * @brief Gets the fine map object
@@ -218,7 +416,7 @@ namespace necsim
          * @brief Gets the coarse map object
          * @return reference to the coarse map
          */
-        const Map<uint32_t> &getCoarseMap() const;
+        const PagedMap<uint32_t> &getCoarseMap() const;
 
         /**
          * @brief Sets the dimensions of the grid, the area where the species are initially sampled from.
@@ -313,6 +511,27 @@ namespace necsim
          */
         bool updateMap(double generation);
 
+        /**
+         * @brief Starts importing the historical maps which follow the current historical maps on background threads,
+         * so that they are ready by the next map update.
+         */
+        void prefetchHistoricalMaps();
+
+        /**
+         * @brief Takes the map from a background import, if it is of the required file.
+         *
+         * Any background import is waited for, and then removed.
+         * @param next_map the background import
+         * @param map_file the path to the required map file
+         * @param map_out the map to exchange the imported values into
+         * @param max_out the maximum value from the imported map
+         * @return true if the map was taken from the background import
+         */
+        bool takeImportedMap(std::future<shared_ptr<ImportedMap>> &next_map,
+                             const string &map_file,
+                             Map<uint32_t> &map_out,
+                             unsigned long &max_out);
+
         /**
          * @brief Checks if the map will require another update.
          * @return true if another update will be performed
@@ -344,6 +563,39 @@ namespace necsim
             return true;
         }
 
+        /**
+         * @brief Sets whether the fine map densities are stored whilst between the present and historical maps.
+         *
+         * The stored densities take 4 bytes for each fine map cell, plus 48 bytes for each cell which differs between
+         * the present and historical maps. They are released once the densities change too often for the number of
+         * lookups, or once the final historical map is reached.
+         *
+         * The stored densities are moved to later generations by lookups, so this should only be enabled if the
+         * landscape is not shared between threads.
+         * @param materialise_density_in if true, store the densities
+         */
+        void setMaterialiseDensity(const bool &materialise_density_in)
+        {
+            materialise_density = materialise_density_in;
+            fine_density_outdated = true;
+            if(!materialise_density)
+            {
+                fine_density.clear();
+            }
+        }
+
+        /**
+         * @brief Sets the memory for keeping tiles of the coarse maps, which are then read from .tif files in tiles
+         * when they are needed rather than imported whole. This must be set before the coarse maps are imported.
+         *
+         * Tiles are read by lookups, so this should only be enabled if the landscape is not shared between threads.
+         * @param cache_size_in the memory in megabytes for each coarse map, or 0 to import the coarse maps whole
+         */
+        void setCoarseMapCacheSize(const unsigned long &cache_size_in)
+        {
+            coarse_map_cache_size = cache_size_in * 1024 * 1024;
+        }
+
         /**
          * @brief Sets the historical state of the system.
          * @param historical_in the historical state.
@@ -396,8 +648,8 @@ namespace necsim
         /**
          * @brief Gets the value at a particular coordinate from the correct map.
          * Takes in to account temporal and spatial referencing.
-         * This version involves a call to the function pointer, *getValFunc, so that the correct call to either
-         * getValFinite() or getValInfinite is made.
+         * This version involves a single call to the function pointer, *getValFunc, which calls the specialisation
+         * chosen by setLandscapeFunctions().
          * @param x the x position on the grid.
          * @param y the y position on the grid.
          * @param xwrap the number of wraps in the x dimension..
@@ -631,6 +883,7 @@ namespace necsim
          * @brief The function that actually performs the dispersal.
          * It is included here for easier  programming and efficiency as the function doesn't need to perform all the checks
          * until the edge of the fine grid.
+         * Calls the specialisation chosen by setLandscapeFunctions() through runDispersalFunc.
          * @param dist the distance travelled (or "distance energy" if dispersal_relative_cost is not 1).
          * @param angle the angle of movement.
          * @param startx the start x position.
@@ -667,7 +920,9 @@ namespace necsim
                                         const double &generation);
 
         /**
-         * @brief Gets the nearest habitat cells from a particular point, spiraling outwards.
+         * @brief Gets the nearest habitat cells from a particular point.
+         *
+         * Uses the distance transform of the fine map where possible, otherwise spirals outwards.
          * @param start_x the start x coordinate
          * @param start_y the start y coordinate
          * @param start_x_wrap the starting x wrapping
@@ -684,6 +939,37 @@ namespace necsim
                                     double &end_y,
                                     const double &generation);
 
+        /**
+         * @brief Generates the nearest habitat cell to each cell of the fine map at the given generation.
+         *
+         * Also finds the range of generations over which the habitat cells remain the same, so that the transform is
+         * only generated again once a changing cell gains or loses habitat, or the maps are updated.
+         * @param generation the generation timer
+         */
+        void calcFineNearestHabitat(const double &generation);
+
+        /**
+         * @brief Looks up the nearest habitat cell from the start position, if it is within the fine map.
+         *
+         * The result is only used if it is certain to be the nearest habitat cell, i.e. there is no habitat outside the
+         * fine map, or the habitat found is no further away than the edge of the fine map.
+         * @param start_x the start x coordinate
+         * @param start_y the start y coordinate
+         * @param start_x_wrap the starting x wrapping
+         * @param start_y_wrap the starting y wrapping
+         * @param end_x the end x coordinate value to modify
+         * @param end_y the end y coordinate value to modify
+         * @param generation the generation timer
+         * @return true if the nearest habitat cell was found
+         */
+        bool findNearestFineHabitatCell(const long &start_x,
+                                        const long &start_y,
+                                        const long &start_x_wrap,
+                                        const long &start_y_wrap,
+                                        double &end_x,
+                                        double &end_y,
+                                        const double &generation);
+
         /**
          * @brief Finds the nearest habitat cell using a much slower method (scanning the entire map for cells.
          * @param start_x the start x coordinate
@@ -12,6 +12,9 @@
 
 namespace necsim
 {
+    // The messages written on this thread are collected here instead, if it is not null.
+    static thread_local LogCapture *log_capture = nullptr;
+
     bool loggerIsSetup()
     {
         return true;
@@ -19,34 +22,114 @@ namespace necsim
 
     void writeInfo(string message)
     {
+        if(log_capture != nullptr)
+        {
+            log_capture->add(LogCapture::INFO_LEVEL, message);
+            return;
+        }
         logger->writeInfo(message);
     }
 
     void writeWarning(string message)
     {
+        if(log_capture != nullptr)
+        {
+            log_capture->add(LogCapture::WARNING_LEVEL, message);
+            return;
+        }
         logger->writeWarning(message);
     }
 
     void writeError(string message)
     {
+        if(log_capture != nullptr)
+        {
+            log_capture->add(LogCapture::ERROR_LEVEL, message);
+            return;
+        }
         logger->writeError(message);
     }
 
     void writeCritical(string message)
     {
+        if(log_capture != nullptr)
+        {
+            log_capture->add(LogCapture::CRITICAL_LEVEL, message);
+            return;
+        }
         logger->writeCritical(message);
     }
 
 #ifdef DEBUG
     void writeLog(const int &level, string message)
     {
+        if(log_capture != nullptr)
+        {
+            log_capture->add(level, message);
+            return;
+        }
         logger->writeLog(level, message);
     }
 
     void writeLog(const int &level, std::stringstream &message)
     {
-        logger->writeLog(level, message.str());
+        writeLog(level, message.str());
     }
 
 #endif //DEBUG
+
+    const int LogCapture::INFO_LEVEL;
+    const int LogCapture::WARNING_LEVEL;
+    const int LogCapture::ERROR_LEVEL;
+    const int LogCapture::CRITICAL_LEVEL;
+
+    void LogCapture::capture()
+    {
+        log_capture = this;
+    }
+
+    void LogCapture::release()
+    {
+        if(log_capture == this)
+        {
+            log_capture = nullptr;
+        }
+    }
+
+    void LogCapture::add(const int &level, const string &message)
+    {
+        messages.emplace_back(level, message);
+    }
+
+    void LogCapture::writeOut()
+    {
+        for(const auto &message : messages)
+        {
+            switch(message.first)
+            {
+                case INFO_LEVEL:
+                    writeInfo(message.second);
+                    break;
+
+                case WARNING_LEVEL:
+                    writeWarning(message.second);
+                    break;
+
+                case ERROR_LEVEL:
+                    writeError(message.second);
+                    break;
+
+                case CRITICAL_LEVEL:
+                    writeCritical(message.second);
+                    break;
+
+                default:
+#ifdef DEBUG
+                    writeLog(message.first, message.second);
+#endif // DEBUG
+                    break;
+            }
+        }
+        messages.clear();
+    }
 }
\ No newline at end of file
@@ -11,6 +11,8 @@
 #define NECSIM_LOGGING_H
 
 #include <string>
+#include <utility>
+#include <vector>
 #include "Logger.h"
 namespace necsim
 {
@@ -66,5 +68,47 @@ namespace necsim
     void writeLog(const int &level, std::stringstream &message);
 
 #endif // DEBUG
+
+    /**
+     * @brief Collects the messages written on a thread, instead of passing them to the logger.
+     *
+     * The logger is not necessarily safe to use from more than one thread, so work on a background thread should
+     * collect its messages, and the main thread should write them out once the work is complete.
+     */
+    class LogCapture
+    {
+    protected:
+        // The level and text of each message, in the order they were written.
+        std::vector<std::pair<int, string>> messages;
+
+    public:
+        // The levels of the messages from writeInfo(), writeWarning(), writeError() and writeCritical().
+        static const int INFO_LEVEL = 20;
+        static const int WARNING_LEVEL = 30;
+        static const int ERROR_LEVEL = 40;
+        static const int CRITICAL_LEVEL = 50;
+
+        /**
+         * @brief Collects the messages written on the current thread, until release() is called on the same thread.
+         */
+        void capture();
+
+        /**
+         * @brief Stops collecting messages on the current thread.
+         */
+        void release();
+
+        /**
+         * @brief Adds a message to the collected messages.
+         * @param level the level of logging severity
+         * @param message the message
+         */
+        void add(const int &level, const string &message);
+
+        /**
+         * @brief Writes out the collected messages, and removes them.
+         */
+        void writeOut();
+    };
 }
 #endif //MEANDISTANCEMODULE_LOGGING_H
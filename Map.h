@@ -14,10 +14,18 @@
 #include <string>
 #include <cstring>
 #include <sstream>
+#include <algorithm>
+#include <functional>
+#include <vector>
 #include <gdal_priv.h>
 #include <cpl_conv.h> // for CPLMalloc()
 #include <sstream>
 #include <memory>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include "cpp17_includes.h"
 #include "Logging.h"
 #include "Matrix.h"
@@ -49,6 +57,8 @@ namespace necsim
         using Matrix<T>::num_cols;
         using Matrix<T>::num_rows;
         bool cpl_error_set;
+        // The largest native block of a file, in bytes, which is read whole rather than one row at a time.
+        static const unsigned long MAX_BLOCK_BYTES = 64 * 1024 * 1024;
     public:
         using Matrix<T>::setSize;
         using Matrix<T>::getCols;
@@ -397,6 +407,91 @@ namespace necsim
             return false;
         }
 
+        /**
+         * @brief Reads a tif file one row at a time, passing each row to the provided function instead of storing the
+         * whole raster. No data values are converted to 0.
+         * @note Opens and closes the connection to the file object.
+         * @param filename the path to the file to read
+         * @param process_row function called with the index and values of each row
+         * @return true if the file is a tif file and has been read
+         */
+        bool importTifRows(const string &filename,
+                           const std::function<void(const unsigned long &, const std::vector<double> &)> &process_row)
+        {
+            if(filename.find(".tif") == string::npos)
+            {
+                return false;
+            }
+            setCPLErrorHandler();
+            std::stringstream ss;
+            ss << "Importing " << filename << " by row" << std::endl;
+            writeInfo(ss.str());
+            open(filename);
+            getRasterBand();
+            getBlockSizes();
+            getMetaData();
+            std::vector<double> row(block_x_size, 0.0);
+            for(unsigned long j = 0; j < block_y_size; j++)
+            {
+                cpl_error = (*po_band)->RasterIO(GF_Read,
+                                                 0,
+                                                 static_cast<int>(j),
+                                                 static_cast<int>(block_x_size),
+                                                 1,
+                                                 row.data(),
+                                                 static_cast<int>(block_x_size),
+                                                 1,
+                                                 GDT_Float64,
+                                                 0,
+                                                 0);
+                checkTifImportFailure();
+                std::replace(row.begin(), row.end(), no_data_value, 0.0);
+                process_row(j, row);
+            }
+            close();
+            removeCPLErrorHandler();
+            return true;
+        }
+
+        /**
+         * @brief Reads a rectangular window of the open tif file. No data values are converted to 0.
+         * @note The connection to the file object must already be open, with the raster band and metadata read.
+         * @param x_offset the first column of the window
+         * @param y_offset the first row of the window
+         * @param width the number of columns in the window
+         * @param height the number of rows in the window
+         * @param values the values of the window in row-major order, resized to fit the window
+         */
+        void readWindow(const unsigned long &x_offset,
+                        const unsigned long &y_offset,
+                        const unsigned long &width,
+                        const unsigned long &height,
+                        std::vector<double> &values)
+        {
+#ifdef DEBUG
+            if(po_band == nullptr)
+            {
+                throw FatalException("po_band is nullptr during window read - please report this bug.");
+            }
+#endif // DEBUG
+            values.resize(width * height);
+            setCPLErrorHandler();
+            cpl_error = (*po_band)->RasterIO(GF_Read,
+                                             static_cast<int>(x_offset),
+                                             static_cast<int>(y_offset),
+                                             static_cast<int>(width),
+                                             static_cast<int>(height),
+                                             values.data(),
+                                             static_cast<int>(width),
+                                             static_cast<int>(height),
+                                             GDT_Float64,
+                                             0,
+                                             0);
+            checkTifImportFailure();
+            removeCPLErrorHandler();
+            std::replace(values.begin(), values.end(), no_data_value, 0.0);
+        }
+
         /**
          * @brief Opens the offset map and fetches the metadata.
          * @param offset_map the offset map to open (should be the larger map).
@@ -481,33 +576,10 @@ namespace necsim
          */
         void defaultImport()
         {
-            setCPLErrorHandler();
-            unsigned int number_printed = 0;
-            for(uint32_t j = 0; j < num_rows; j++)
+            importConverted<T>(gdal_data_type, [](const T &value)
             {
-                printNumberComplete(j, number_printed);
-                cpl_error = (*po_band)->RasterIO(GF_Read,
-                                                 0,
-                                                 j,
-                                                 static_cast<int>(block_x_size),
-                                                 1,
-                                                 &matrix[j * num_cols],
-                                                 static_cast<int>(block_x_size),
-                                                 1,
-                                                 gdal_data_type,
-                                                 0,
-                                                 0);
-                checkTifImportFailure();
-                // Now convert the no data values to 0
-                for(uint32_t i = 0; i < num_cols; i++)
-                {
-                    if(get(j, i) == no_data_value)
-                    {
-                        get(j, i) = 0;
-                    }
-                }
-            }
-            removeCPLErrorHandler();
+                return value;
+            });
         }
 
         /**
@@ -516,43 +588,11 @@ namespace necsim
          */
         void importFromDoubleAndMakeBool()
         {
-            setCPLErrorHandler();
             writeInfo("\nConverting from double to boolean.\n");
-            unsigned int number_printed = 0;
-            // create an empty row of type float
-            double* t1;
-            t1 = (double*) CPLMalloc(sizeof(double) * num_cols);
-            // import the data a row at a time, using our template row.
-            for(uint32_t j = 0; j < num_rows; j++)
+            importConverted<double>(GDT_Float64, [](const double &value)
             {
-                printNumberComplete(j, number_printed);
-                cpl_error = (*po_band)->RasterIO(GF_Read,
-                                                 0,
-                                                 j,
-                                                 static_cast<int>(block_x_size),
-                                                 1,
-                                                 &t1[0],
-                                                 static_cast<int>(block_x_size),
-                                                 1,
-                                                 GDT_Float64,
-                                                 0,
-                                                 0);
-                checkTifImportFailure();
-                // now copy the data to our Map, converting float to int. Round or floor...? hmm, floor?
-                for(unsigned long i = 0; i < num_cols; i++)
-                {
-                    if(t1[i] == no_data_value)
-                    {
-                        this->setValue(j, i, false);
-                    }
-                    else
-                    {
-                        this->setValue(j, i, t1[i] >= 0.5);
-                    }
-                }
-            }
-            CPLFree(t1);
-            removeCPLErrorHandler();
+                return static_cast<T>(value >= 0.5);
+            });
         }
 
         /**
@@ -564,23 +604,30 @@ namespace necsim
          */
         template<typename T2> void importUsingBuffer(GDALDataType dt_buff)
         {
-            setCPLErrorHandler();
             std::stringstream ss;
             ss << "\nUsing buffer of type " << GDALGetDataTypeName(dt_buff) << " into array of dimensions ";
             ss << num_cols << " by " << num_rows << " with block size " << block_x_size << ", " << block_y_size << std::endl;
             writeInfo(ss.str());
-            unsigned int number_printed = 0;
-            // create an empty row of type float
-            T2* t1;
-            t1 = (T2*) CPLMalloc(sizeof(T2) * num_cols);
-            if(CPLGetLastErrorNo() != CE_None)
+            importConverted<T2>(dt_buff, [](const T2 &value)
             {
-                std::stringstream os;
-                os << "Error thrown by CPLMalloc: " << CPLGetLastErrorType() << ": " << CPLGetLastErrorMsg() << std::endl;
-                throw FatalException(os.str());
-            }
-            // import the data a row at a time, using our template row.
-            auto int_block_x_size = static_cast<int>(block_x_size);
+                return static_cast<T>(value);
+            });
+        }
+
+        /**
+         * @brief Imports the raster, reading whole blocks of the file where they are small enough, and otherwise reading
+         * one row at a time.
+         *
+         * Values are read from the file as T2, no data values are set to 0 and all other values are converted to T.
+         *
+         * @tparam T2 the type to read the values from the file as
+         * @tparam Convert the type of the conversion function
+         * @param dt_buff the gdal data type matching T2
+         * @param convert function converting each value which is not the no data value from T2 to T
+         */
+        template<typename T2, typename Convert> void importConverted(GDALDataType dt_buff, const Convert &convert)
+        {
+            setCPLErrorHandler();
 #ifdef DEBUG
             if(sizeof(T2) * 8 != GDALGetDataTypeSize(dt_buff))
             {
@@ -589,56 +636,199 @@ namespace necsim
                 ss0 << GDALGetDataTypeSize(dt_buff) << "). Please report this bug." << std::endl;
                 throw FatalException(ss0.str());
             }
-            if(t1 == nullptr)
+            if(po_band == nullptr)
             {
-                std::stringstream ss1;
-                ss1 << "CPL malloc could not acquire " << sizeof(T2) * num_cols << " of space and returned a nullptr.";
-                ss1 << " Please check that your install of gdal is fully functional, and otherwise report this bug."
-                    << std::endl;
-                throw FatalException(ss1.str());
+                throw FatalException("po_band is nullptr during import - please report this bug.");
             }
-            if(static_cast<unsigned long>(int_block_x_size) != block_x_size)
+#endif // DEBUG
+            int native_block_x_size = 0;
+            int native_block_y_size = 0;
+            (*po_band)->GetBlockSize(&native_block_x_size, &native_block_y_size);
+            const auto native_data_type = (*po_band)->GetRasterDataType();
+            const unsigned long block_bytes = static_cast<unsigned long>(native_block_x_size)
+                                              * static_cast<unsigned long>(native_block_y_size)
+                                              * static_cast<unsigned long>(GDALGetDataTypeSize(native_data_type) / 8);
+            if(native_block_x_size > 0 && native_block_y_size > 0 && block_bytes <= MAX_BLOCK_BYTES)
             {
-                std::stringstream ss2;
-                ss2 << "Error in integer conversion - please report this bug: " << int_block_x_size << " != ";
-                ss2 << block_x_size << std::endl;
-                throw FatalException(ss2.str());
+                importBlocks<T2>(dt_buff,
+                                 native_data_type,
+                                 static_cast<unsigned long>(native_block_x_size),
+                                 static_cast<unsigned long>(native_block_y_size),
+                                 convert);
             }
-            if(po_band == nullptr)
+            else
             {
-                CPLFree(t1);
-                throw FatalException("po_band is nullptr during import using buffer - please report this bug.");
+                importRows<T2>(dt_buff, convert);
             }
-#endif // DEBUG
+            removeCPLErrorHandler();
+        }
+
+        /**
+         * @brief Converts a row of values read from the file and stores them in the matrix.
+         * @tparam T2 the type of the values read from the file
+         * @tparam Convert the type of the conversion function
+         * @param values the values read from the file
+         * @param index the index in the matrix of the first value
+         * @param number the number of values
+         * @param convert function converting each value which is not the no data value from T2 to T
+         */
+        template<typename T2, typename Convert> void storeConverted(const T2* values,
+                                                                    const unsigned long &index,
+                                                                    const unsigned long &number,
+                                                                    const Convert &convert)
+        {
+            for(unsigned long i = 0; i < number; i++)
+            {
+                const T2 value = values[i];
+                matrix[index + i] = static_cast<double>(value) == no_data_value ? static_cast<T>(0) : convert(value);
+            }
+        }
+
+        /**
+         * @brief Imports the raster one row at a time, for files whose native blocks are too large to read whole.
+         * @tparam T2 the type to read the values from the file as
+         * @tparam Convert the type of the conversion function
+         * @param dt_buff the gdal data type matching T2
+         * @param convert function converting each value which is not the no data value from T2 to T
+         */
+        template<typename T2, typename Convert> void importRows(GDALDataType dt_buff, const Convert &convert)
+        {
+            unsigned int number_printed = 0;
+            std::vector<T2> row(num_cols);
             for(uint32_t j = 0; j < num_rows; j++)
             {
                 printNumberComplete(j, number_printed);
                 cpl_error = (*po_band)->RasterIO(GF_Read,
                                                  0,
                                                  j,
-                                                 int_block_x_size,
+                                                 static_cast<int>(block_x_size),
                                                  1,
-                                                 t1,
-                                                 int_block_x_size,
+                                                 row.data(),
+                                                 static_cast<int>(block_x_size),
                                                  1,
                                                  dt_buff,
                                                  0,
                                                  0);
                 checkTifImportFailure();
-                for(unsigned long i = 0; i < num_cols; i++)
+                storeConverted(row.data(), j * num_cols, num_cols, convert);
+            }
+        }
+
+        /**
+         * @brief Imports the raster one native block of the file at a time, decoding rows of blocks on several threads.
+         *
+         * Each additional thread opens its own connection to the file, as gdal datasets cannot be shared between
+         * threads. Every thread reads whole rows of blocks, so no two threads write to the same cells, except for
+         * boolean maps, whose cells share storage and are therefore read on a single thread. Progress is only written
+         * from the calling thread.
+         *
+         * @tparam T2 the type to read the values from the file as
+         * @tparam Convert the type of the conversion function
+         * @param dt_buff the gdal data type matching T2
+         * @param native_data_type the data type of the values stored in the file
+         * @param native_block_x_size the number of columns in each native block
+         * @param native_block_y_size the number of rows in each native block
+         * @param convert function converting each value which is not the no data value from T2 to T
+         */
+        template<typename T2, typename Convert> void importBlocks(GDALDataType dt_buff,
+                                                                 GDALDataType native_data_type,
+                                                                 const unsigned long &native_block_x_size,
+                                                                 const unsigned long &native_block_y_size,
+                                                                 const Convert &convert)
+        {
+            const unsigned long native_bytes = static_cast<unsigned long>(GDALGetDataTypeSize(native_data_type) / 8);
+            const unsigned long block_columns = (num_cols + native_block_x_size - 1) / native_block_x_size;
+            const unsigned long block_rows = (num_rows + native_block_y_size - 1) / native_block_y_size;
+            unsigned long num_threads = std::is_same<T, bool>::value ? 1 : std::max(std::thread::hardware_concurrency(),
+                                                                                     1u);
+            num_threads = std::min(num_threads, block_rows);
+            std::atomic<unsigned long> next_block_row(0);
+            std::atomic<unsigned long> rows_complete(0);
+            std::atomic<bool> failed(false);
+            std::vector<std::exception_ptr> errors(std::max(num_threads, 1UL));
+            unsigned int number_printed = 0;
+            auto read_blocks = [&](GDALRasterBand* band, const unsigned long &thread_index)
+            {
+                try
                 {
-                    if(t1[i] == no_data_value)
+                    std::vector<unsigned char> block(native_block_x_size * native_block_y_size * native_bytes);
+                    std::vector<T2> row(native_block_x_size);
+                    for(unsigned long block_y = next_block_row++; block_y < block_rows && !failed;
+                        block_y = next_block_row++)
                     {
-                        this->setValue(j, i, static_cast<T>(0));
-                    }
-                    else
-                    {
-                        this->setValue(j, i, static_cast<T>(t1[i]));
+                        const unsigned long y_offset = block_y * native_block_y_size;
+                        const unsigned long height = std::min(native_block_y_size, num_rows - y_offset);
+                        for(unsigned long block_x = 0; block_x < block_columns; block_x++)
+                        {
+                            const unsigned long x_offset = block_x * native_block_x_size;
+                            const unsigned long width = std::min(native_block_x_size, num_cols - x_offset);
+                            if(band->ReadBlock(static_cast<int>(block_x), static_cast<int>(block_y), block.data())
+                               >= CE_Failure)
+                            {
+                                std::stringstream ss;
+                                ss << "Could not read block " << block_x << ", " << block_y << " of " << file_name
+                                   << ": " << CPLGetLastErrorMsg() << std::endl;
+                                throw FatalException(ss.str());
+                            }
+                            for(unsigned long y = 0; y < height; y++)
+                            {
+                                GDALCopyWords(block.data() + y * native_block_x_size * native_bytes,
+                                              native_data_type,
+                                              static_cast<int>(native_bytes),
+                                              row.data(),
+                                              dt_buff,
+                                              static_cast<int>(sizeof(T2)),
+                                              static_cast<int>(width));
+                                storeConverted(row.data(), (y_offset + y) * num_cols + x_offset, width, convert);
+                            }
+                        }
+                        rows_complete += height;
+                        if(thread_index == 0)
+                        {
+                            printNumberComplete(static_cast<uint32_t>(rows_complete), number_printed);
+                        }
                     }
                 }
+                catch(...)
+                {
+                    failed = true;
+                    errors[thread_index] = std::current_exception();
+                }
+            };
+            std::vector<std::thread> threads;
+            for(unsigned long i = 1; i < num_threads; i++)
+            {
+                threads.emplace_back([&, i]()
+                                     {
+                                         CPLPushErrorHandler(CPLQuietErrorHandler);
+                                         auto dataset = (GDALDataset*) GDALOpen(file_name.c_str(), GA_ReadOnly);
+                                         if(dataset == nullptr)
+                                         {
+                                             failed = true;
+                                             errors[i] = std::make_exception_ptr(
+                                                     FatalException("Could not open " + file_name + " for reading."));
+                                         }
+                                         else
+                                         {
+                                             read_blocks(dataset->GetRasterBand(1), i);
+                                             GDALClose(dataset);
+                                         }
+                                         CPLPopErrorHandler();
+                                     });
+            }
+            read_blocks(*po_band, 0);
+            for(auto &thread : threads)
+            {
+                thread.join();
+            }
+            for(const auto &error : errors)
+            {
+                if(error)
+                {
+                    removeCPLErrorHandler();
+                    std::rethrow_exception(error);
+                }
             }
-            CPLFree(t1);
-            removeCPLErrorHandler();
         }
 
         /**
@@ -679,6 +869,28 @@ namespace necsim
             }
         }
 
+        /**
+         * @brief Exchanges the values, size and file connection of this map with another, without copying the values.
+         * @param m the map to exchange with
+         */
+        void swap(Map &m) noexcept
+        {
+            Matrix<T>::swap(m);
+            std::swap(po_dataset, m.po_dataset);
+            std::swap(po_band, m.po_band);
+            std::swap(block_x_size, m.block_x_size);
+            std::swap(block_y_size, m.block_y_size);
+            std::swap(no_data_value, m.no_data_value);
+            std::swap(file_name, m.file_name);
+            std::swap(gdal_data_type, m.gdal_data_type);
+            std::swap(cpl_error, m.cpl_error);
+            std::swap(upper_left_x, m.upper_left_x);
+            std::swap(upper_left_y, m.upper_left_y);
+            std::swap(x_res, m.x_res);
+            std::swap(y_res, m.y_res);
+            std::swap(cpl_error_set, m.cpl_error_set);
+        }
+
         /**
          * @brief Output operator
          * @param os the output stream
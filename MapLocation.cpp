@@ -32,4 +32,15 @@ namespace necsim
         is >> m.x >> delim >> m.y >> delim >> m.xwrap >> delim >> m.ywrap;
         return is;
     }
+
+    std::size_t MapLocationHash::operator()(const MapLocation &m) const
+    {
+        // Combine the hash of each coordinate in turn.
+        std::size_t seed = 0;
+        for(const auto &value : {m.x, m.y, m.xwrap, m.ywrap})
+        {
+            seed ^= std::hash<long>()(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
 }
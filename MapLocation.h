@@ -5,6 +5,7 @@
 #ifndef NECSIM_MAPLOCATION_H
 #define NECSIM_MAPLOCATION_H
 #include <iostream>
+#include <functional>
 namespace necsim
 {
     struct MapLocation
@@ -56,5 +57,18 @@ namespace necsim
          */
         friend std::istream &operator>>(std::istream &is, MapLocation &m);
     };
+
+    /**
+     * @brief Hashes a MapLocation, for use as a key in unordered containers.
+     */
+    struct MapLocationHash
+    {
+        /**
+         * @brief Calculates the hash of the location.
+         * @param m the location to hash
+         * @return the hash value
+         */
+        std::size_t operator()(const MapLocation &m) const;
+    };
 }
 #endif //NECSIM_MAPLOCATION_H
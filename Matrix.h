@@ -27,6 +27,7 @@
 #include <cstring>
 #include <stdexcept>
 #include <vector>
+#include <utility>
 
 #ifdef use_csv
 #include<cmath>
@@ -112,6 +113,17 @@ namespace necsim
             num_rows = rows;
         }
 
+        /**
+         * @brief Exchanges the values and size of this matrix with another, without copying the values.
+         * @param m the matrix to exchange with
+         */
+        void swap(Matrix &m) noexcept
+        {
+            std::swap(num_cols, m.num_cols);
+            std::swap(num_rows, m.num_rows);
+            matrix.swap(m.matrix);
+        }
+
         /**
          * @brief Getter for the number of columns.
          * @return the number of columns.
@@ -84,7 +84,7 @@ namespace necsim
         }
     }
 
-    void Metacommunity::addSpecies(unsigned long &species_count, TreeNode* tree_node, std::set<unsigned long> &species_list)
+    void Metacommunity::addSpecies(unsigned long &species_count, TreeNodeReference tree_node, std::set<unsigned long> &species_list)
     {
 
         auto species_id = species_abundances_handler->getRandomSpeciesID();
@@ -99,12 +99,22 @@ namespace necsim
             species_count++;
         }
 #ifdef DEBUG
-        if(tree_node->getSpeciesID() != 0)
+        if(tree_node.getSpeciesID() != 0)
         {
             throw FatalException("Trying to add species for lineages with non-zero species id. Please report this bug.");
         }
 #endif // DEBUG
-        tree_node->burnSpecies(species_id);
+        tree_node.burnSpecies(species_id);
+    }
+
+    bool Metacommunity::canCalculateMultipleRates() const
+    {
+        return false;
+    }
+
+    bool Metacommunity::canCalculateInParallel() const
+    {
+        return false;
     }
 
     void Metacommunity::createMetacommunityNSENeutralModel()
@@ -127,6 +137,8 @@ namespace necsim
         // Dispose of any previous Tree object and create a new one
         metacommunity_tree = Tree();
         metacommunity_tree.internalSetup(temp_parameters);
+        // Jump directly between speciation and coalescence events, rather than simulating every death.
+        metacommunity_tree.addGillespie(0.0);
         // Run our simulation and calculate the species abundance distribution (as this is all that needs to be stored).
         if(!metacommunity_tree.runSimulation())
         {
@@ -158,7 +170,7 @@ namespace necsim
         Community::applyNoOutput(sp);
     }
 
-    void Metacommunity::applyNoOutput(shared_ptr<SpecSimParameters> sp, shared_ptr<vector<TreeNode>> tree_data)
+    void Metacommunity::applyNoOutput(shared_ptr<SpecSimParameters> sp, shared_ptr<TreeNodeStore> tree_data)
     {
 #ifdef DEBUG
         writeLog(10, "********************");
@@ -114,10 +114,22 @@ namespace necsim
          * species has been selected from the metacommunity
          *
          * @param species_count the total number of species currently in the community
-         * @param tree_node pointer to the TreeNode object for this lineage
+         * @param tree_node reference to the node for this lineage
          * @param species_list the set of all species ids.
          */
-        void addSpecies(unsigned long &species_count, TreeNode* tree_node, std::set<unsigned long> &species_list) override;
+        void addSpecies(unsigned long &species_count, TreeNodeReference tree_node, std::set<unsigned long> &species_list) override;
+
+        /**
+         * @brief Species IDs are drawn from the metacommunity, so each speciation rate must be calculated separately.
+         * @return false
+         */
+        bool canCalculateMultipleRates() const override;
+
+        /**
+         * @brief Species IDs are drawn from the metacommunity in order, so communities must be calculated sequentially.
+         * @return false
+         */
+        bool canCalculateInParallel() const override;
 
         /**
          * @brief Creates the metacommunity in memory using a non-spatially_explicit neutral model, which is run using the
@@ -137,7 +149,7 @@ namespace necsim
          * for the metacommunity structure, but doesn't write the output
           * @param sp speciation parameters to apply, including speciation rate, times and spatial sampling procedure.
           */
-        void applyNoOutput(shared_ptr<SpecSimParameters> sp, shared_ptr<vector<TreeNode>> tree_data) override;
+        void applyNoOutput(shared_ptr<SpecSimParameters> sp, shared_ptr<TreeNodeStore> tree_data) override;
 
         /**
          * @brief Approximates the SAD from a NSE neutral model, based on Chisholm and Pacala (2010).
@@ -0,0 +1,382 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file PagedMap.h
+ * @brief Contains PagedMap for reading tiles of a .tif file on demand, keeping only the most recently used tiles.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_PAGEDMAP_H
+#define NECSIM_PAGEDMAP_H
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Map.h"
+
+namespace necsim
+{
+    /**
+     * @brief A map which can either store all of its values, as Map does, or read square tiles of a .tif file when
+     * they are first needed.
+     *
+     * Paged maps keep the most recently used tiles up to a memory budget, discarding the least recently used tile
+     * when another must be read. Values can only be read from a paged map through get(), which should be called from
+     * a single thread.
+     *
+     * @tparam T the type of the values
+     */
+    template<class T>
+    class PagedMap : public Map<T>
+    {
+    protected:
+        // The number of rows and columns in each tile.
+        static const unsigned long TILE_SIZE = 64;
+        // Marks a tile which is not cached, or a slot with no neighbour in the order of use.
+        static const unsigned long NONE = std::numeric_limits<unsigned long>::max();
+        using Matrix<T>::matrix;
+        using Matrix<T>::num_cols;
+        using Matrix<T>::num_rows;
+        using Map<T>::block_x_size;
+        using Map<T>::block_y_size;
+        // True if values are read from the file when needed, rather than stored in the matrix.
+        bool paged;
+        // Converts each value read from the file to the stored value.
+        std::function<T(const double &)> convert;
+        // The number of tiles across the map, and the most tiles which are kept at once.
+        unsigned long tiles_across, max_tiles;
+        // The slot of each tile of the map, or NONE if the tile is not kept.
+        vector<unsigned long> tile_slots;
+        // The tile in each slot, and the slots used before and after it, from the most to the least recently used.
+        vector<unsigned long> slot_tiles, slot_previous, slot_next;
+        // The most and least recently used slots.
+        unsigned long most_recent, least_recent;
+        // The values of the tiles in each slot, each of TILE_SIZE rows of TILE_SIZE values.
+        vector<T> tile_values;
+        // The last tile read from, and the index of its values in tile_values.
+        unsigned long last_tile, last_offset;
+        // The number of tiles which have been read from the file.
+        unsigned long tiles_read;
+
+        /**
+         * @brief Removes the slot from the order of use.
+         * @param slot the slot to remove
+         */
+        void unlinkSlot(const unsigned long &slot)
+        {
+            if(slot_previous[slot] == NONE)
+            {
+                most_recent = slot_next[slot];
+            }
+            else
+            {
+                slot_next[slot_previous[slot]] = slot_next[slot];
+            }
+            if(slot_next[slot] == NONE)
+            {
+                least_recent = slot_previous[slot];
+            }
+            else
+            {
+                slot_previous[slot_next[slot]] = slot_previous[slot];
+            }
+        }
+
+        /**
+         * @brief Adds the slot to the order of use as the most recently used.
+         * @param slot the slot to add
+         */
+        void linkSlot(const unsigned long &slot)
+        {
+            slot_previous[slot] = NONE;
+            slot_next[slot] = most_recent;
+            if(most_recent == NONE)
+            {
+                least_recent = slot;
+            }
+            else
+            {
+                slot_previous[most_recent] = slot;
+            }
+            most_recent = slot;
+        }
+
+        /**
+         * @brief Reads the tile from the file into a free slot, or the least recently used slot if all are in use.
+         * @param tile the index of the tile
+         * @return the slot containing the tile
+         */
+        unsigned long readTile(const unsigned long &tile)
+        {
+            unsigned long slot;
+            if(slot_tiles.size() < max_tiles)
+            {
+                slot = slot_tiles.size();
+                slot_tiles.push_back(tile);
+                slot_previous.push_back(NONE);
+                slot_next.push_back(NONE);
+                tile_values.resize(tile_values.size() + TILE_SIZE * TILE_SIZE);
+            }
+            else
+            {
+                slot = least_recent;
+                unlinkSlot(slot);
+                tile_slots[slot_tiles[slot]] = NONE;
+                slot_tiles[slot] = tile;
+            }
+            const unsigned long y_offset = (tile / tiles_across) * TILE_SIZE;
+            const unsigned long x_offset = (tile % tiles_across) * TILE_SIZE;
+            const unsigned long height = std::min(TILE_SIZE, num_rows - y_offset);
+            const unsigned long width = std::min(TILE_SIZE, num_cols - x_offset);
+            std::vector<double> window;
+            this->readWindow(x_offset, y_offset, width, height, window);
+            auto values = tile_values.begin() + slot * TILE_SIZE * TILE_SIZE;
+            for(unsigned long y = 0; y < height; y++)
+            {
+                std::transform(window.begin() + y * width,
+                               window.begin() + (y + 1) * width,
+                               values + y * TILE_SIZE,
+                               convert);
+            }
+            tile_slots[tile] = slot;
+            linkSlot(slot);
+            tiles_read++;
+            return slot;
+        }
+
+    public:
+        PagedMap() : Map<T>(), paged(false), convert(), tiles_across(0), max_tiles(0), tile_slots(), slot_tiles(),
+                     slot_previous(), slot_next(), most_recent(NONE), least_recent(NONE), tile_values(),
+                     last_tile(NONE), last_offset(0), tiles_read(0)
+        {
+
+        }
+
+        PagedMap(const PagedMap &m) : PagedMap()
+        {
+            *this = m;
+        }
+
+        ~PagedMap() override = default;
+
+        /**
+         * @brief Opens a .tif file to be read one tile at a time, rather than importing every value.
+         *
+         * The file is read once to find the maximum value, and the connection is then kept open until the map is
+         * cleared.
+         *
+         * @param filename the path to the file
+         * @param rows_in the expected number of rows, or 0 to use the raster size
+         * @param cols_in the expected number of columns, or 0 to use the raster size
+         * @param cache_size the memory in bytes for keeping tiles, of which at least one tile is always kept
+         * @param convert_in converts each value read from the file, after no data values are set to 0
+         * @param max_value the largest converted value in the file
+         * @return true if the file is a .tif file and has been opened, otherwise the map is unchanged
+         */
+        bool importPaged(const string &filename,
+                         const unsigned long &rows_in,
+                         const unsigned long &cols_in,
+                         const unsigned long &cache_size,
+                         const std::function<T(const double &)> &convert_in,
+                         T &max_value)
+        {
+            if(filename.find(".tif") == string::npos)
+            {
+                return false;
+            }
+            clearPages();
+            max_value = T();
+            this->importTifRows(filename, [&max_value, &convert_in](const unsigned long &, const vector<double> &row)
+            {
+                for(const auto &value : row)
+                {
+                    max_value = std::max(max_value, convert_in(value));
+                }
+            });
+            this->open(filename);
+            this->getRasterBand();
+            this->getBlockSizes();
+            this->getMetaData();
+            if((rows_in != 0 && rows_in != block_y_size) || (cols_in != 0 && cols_in != block_x_size))
+            {
+                std::stringstream ss;
+                ss << "Raster data size does not match inputted dimensions for " << filename << ". Using raster sizes."
+                   << std::endl;
+                ss << "Old dimensions: " << cols_in << ", " << rows_in << std::endl;
+                ss << "New dimensions: " << block_x_size << ", " << block_y_size << std::endl;
+                writeWarning(ss.str());
+            }
+            matrix.clear();
+            matrix.shrink_to_fit();
+            num_rows = block_y_size;
+            num_cols = block_x_size;
+            paged = true;
+            convert = convert_in;
+            tiles_across = (num_cols + TILE_SIZE - 1) / TILE_SIZE;
+            const unsigned long total_tiles = tiles_across * ((num_rows + TILE_SIZE - 1) / TILE_SIZE);
+            max_tiles = std::min(std::max(cache_size / (TILE_SIZE * TILE_SIZE * sizeof(T)), 1UL), total_tiles);
+            tile_slots.assign(total_tiles, NONE);
+            std::stringstream ss;
+            ss << "Reading " << filename << " in tiles of " << TILE_SIZE << " by " << TILE_SIZE
+               << " cells, keeping up to " << max_tiles << " of " << total_tiles << " tiles." << std::endl;
+            writeInfo(ss.str());
+            return true;
+        }
+
+        /**
+         * @brief Removes the tiles and closes the file of a paged map, leaving an empty map. Maps which store all of
+         * their values are unchanged.
+         */
+        void clearPages()
+        {
+            if(!paged)
+            {
+                return;
+            }
+            this->close();
+            num_rows = 0;
+            num_cols = 0;
+            paged = false;
+            convert = nullptr;
+            tiles_across = 0;
+            max_tiles = 0;
+            tile_slots.clear();
+            tile_slots.shrink_to_fit();
+            slot_tiles.clear();
+            slot_previous.clear();
+            slot_next.clear();
+            most_recent = NONE;
+            least_recent = NONE;
+            tile_values.clear();
+            tile_values.shrink_to_fit();
+            last_tile = NONE;
+            last_offset = 0;
+            tiles_read = 0;
+        }
+
+        /**
+         * @brief Checks if the values are read from the file when needed.
+         * @return true if the map is paged
+         */
+        bool isPaged() const
+        {
+            return paged;
+        }
+
+        /**
+         * @brief Gets the number of tiles which have been read from the file.
+         * @return the number of tiles read, including tiles which were read again after being discarded
+         */
+        unsigned long getTilesRead() const
+        {
+            return tiles_read;
+        }
+
+        /**
+         * @brief Gets the value at a particular index, reading its tile from the file if the map is paged and the
+         * tile is not kept.
+         * @param row the row number to get the value at
+         * @param col the column number to get the value at
+         * @return the value at the specified row and column
+         */
+        T get(const unsigned long &row, const unsigned long &col)
+        {
+            if(!paged)
+            {
+                return Matrix<T>::get(row, col);
+            }
+#ifdef DEBUG
+            if(row >= num_rows || col >= num_cols)
+            {
+                std::stringstream ss;
+                ss << "Index of " << row << ", " << col << " is out of range of paged map with size " << num_rows;
+                ss << ", " << num_cols << std::endl;
+                throw std::out_of_range(ss.str());
+            }
+#endif // DEBUG
+            const unsigned long tile = (row / TILE_SIZE) * tiles_across + col / TILE_SIZE;
+            if(tile != last_tile)
+            {
+                unsigned long slot = tile_slots[tile];
+                if(slot == NONE)
+                {
+                    slot = readTile(tile);
+                }
+                else if(slot != most_recent)
+                {
+                    unlinkSlot(slot);
+                    linkSlot(slot);
+                }
+                last_tile = tile;
+                last_offset = slot * TILE_SIZE * TILE_SIZE;
+            }
+            return tile_values[last_offset + (row % TILE_SIZE) * TILE_SIZE + col % TILE_SIZE];
+        }
+
+        /**
+         * @brief Exchanges the values, tiles and file connection of this map with another.
+         * @param m the map to exchange with
+         */
+        void swap(PagedMap &m) noexcept
+        {
+            Map<T>::swap(m);
+            std::swap(paged, m.paged);
+            std::swap(convert, m.convert);
+            std::swap(tiles_across, m.tiles_across);
+            std::swap(max_tiles, m.max_tiles);
+            tile_slots.swap(m.tile_slots);
+            slot_tiles.swap(m.slot_tiles);
+            slot_previous.swap(m.slot_previous);
+            slot_next.swap(m.slot_next);
+            std::swap(most_recent, m.most_recent);
+            std::swap(least_recent, m.least_recent);
+            tile_values.swap(m.tile_values);
+            std::swap(last_tile, m.last_tile);
+            std::swap(last_offset, m.last_offset);
+            std::swap(tiles_read, m.tiles_read);
+        }
+
+        /**
+         * @brief Assignment operator, which closes the file of a paged map before copying the other map.
+         * @param m the PagedMap object to copy from
+         * @return the self PagedMap object
+         */
+        PagedMap &operator=(const PagedMap &m)
+        {
+            if(this != &m)
+            {
+                clearPages();
+                Map<T>::operator=(m);
+                // A paged map has no stored values, so its size is not copied with the matrix.
+                num_rows = m.num_rows;
+                num_cols = m.num_cols;
+                paged = m.paged;
+                convert = m.convert;
+                tiles_across = m.tiles_across;
+                max_tiles = m.max_tiles;
+                tile_slots = m.tile_slots;
+                slot_tiles = m.slot_tiles;
+                slot_previous = m.slot_previous;
+                slot_next = m.slot_next;
+                most_recent = m.most_recent;
+                least_recent = m.least_recent;
+                tile_values = m.tile_values;
+                last_tile = m.last_tile;
+                last_offset = m.last_offset;
+                tiles_read = m.tiles_read;
+            }
+            return *this;
+        }
+    };
+
+    template<class T> const unsigned long PagedMap<T>::TILE_SIZE;
+
+    template<class T> const unsigned long PagedMap<T>::NONE;
+}
+#endif //NECSIM_PAGEDMAP_H
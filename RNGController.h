@@ -128,7 +128,7 @@ namespace random_numbers
     /**
      * @brief Contains the functions for random number generation, based on the Xoroshiro256+ algorithm.
      */
-    class RNGController : public virtual Xoroshiro256plus
+    class RNGController : public Xoroshiro256plus
     {
 
     private:
@@ -255,22 +255,27 @@ namespace random_numbers
         /**
          * @brief Generates a random distance from a rayleigh distribution, given that the distance is more than some
          * minimum.
+         *
+         * The squared distance beyond the minimum is exponentially distributed, so the conditional distribution is
+         * sampled directly, with no loss of precision however unlikely the minimum distance is.
          * @param dist the minimum distance to generate
          * @return a random distance greater than the minimum provided
          */
         double rayleighMinDist(const double &dist)
         {
-            double min_prob = rayleighCDF(dist);
-            double rand_prob = min_prob + (1 - min_prob) * d01();
-            double out = sigma * pow(-2 * log(rand_prob), 0.5);
-            if(out < dist)
-            {
-                // This probably means that the rayleigh distribution has a less-than-machine-precision probability of
-                // producing this distance.
-                // Therefore, we just return the distance
-                return dist;
-            }
-            return out;
+            const double out = sqrt(dist * dist - 2.0 * sigma * sigma * log(1.0 - d01()));
+            return std::max(out, dist);
+        }
+
+        /**
+         * @brief Gets the probability of a distance from the rayleigh distribution being greater than the given
+         * distance.
+         * @param dist the distance to obtain the probability of
+         * @return the probability of producing a larger distance
+         */
+        double rayleighSurvival(const double &dist)
+        {
+            return exp(-(dist * dist) / (2.0 * sigma * sigma));
         }
 
         /**
@@ -321,21 +326,38 @@ namespace random_numbers
 
         /**
          * @brief Gets a fat-tailed random distance greater than some minimum
+         *
+         * Draws from fattail() beyond the minimum distance correspond to the uniform random numbers below a threshold,
+         * so the conditional distribution is sampled directly by scaling the random number, with no loss of precision
+         * however unlikely the minimum distance is.
          * @param min_distance the minimum distance to return
          * @return a fat-tailed distance greater than the minimum
          */
         double fattailMinDistance(const double &min_distance)
         {
-            double prob = fattailCDF(min_distance);
-            double random_number = 1 - (prob + d01() * (1 - prob));
-            double result = sigma * pow((tau * (pow(random_number, -2.0 / tau)) - 1.0), 0.5);
-            // This is an approximation for scenarios when the probability of dispersing very long distances
-            // is less than machine precision
-            if(result < min_distance)
+            const double sigma_squared = sigma * sigma;
+            if(sigma_squared + min_distance * min_distance <= tau * sigma_squared)
             {
-                result = fattail() + min_distance;
+                // Every draw is at least the minimum distance.
+                return std::max(fattail(), min_distance);
             }
-            return result;
+            const double scaled = (sigma_squared + min_distance * min_distance) * pow(1.0 - d01(), -2.0 / tau);
+            return std::max(sqrt(scaled - sigma_squared), min_distance);
+        }
+
+        /**
+         * @brief Gets a random distance from the old fat-tailed dispersal kernel greater than some minimum.
+         *
+         * Samples the conditional distribution of fattail_old() beyond the minimum distance directly, in the same way as
+         * fattailMinDistance().
+         * @param min_distance the minimum distance to return
+         * @return a fat-tailed distance greater than the minimum
+         */
+        double fattailOldMinDistance(const double &min_distance)
+        {
+            const double sigma_squared = sigma * sigma;
+            const double scaled = (sigma_squared + min_distance * min_distance) * pow(1.0 - d01(), 2.0 / (2.0 + tau));
+            return std::max(sqrt(scaled - sigma_squared), min_distance);
         }
 
         // this new version corrects the 1.0 to 2.0 and doesn't require the values to be passed every time.
@@ -418,12 +440,17 @@ namespace random_numbers
         /**
          * @brief Generates a random distance from a norm-uniform distribution, given that the distance is more than some
          * minimum.
+         *
+         * Each distribution is chosen in proportion to its probability of producing a distance beyond the minimum, so
+         * that the result is drawn from the conditional distribution of normUniform().
          * @param dist the minimum distance to generate
          * @return a random distance greater than the minimum provided
          */
         double normUniformMinDistance(const double &min_distance)
         {
-            if(d01() < m_prob)
+            const double uniform_weight = cutoff > min_distance ? m_prob * (1.0 - min_distance / cutoff) : 0.0;
+            const double normal_weight = (1.0 - m_prob) * rayleighSurvival(min_distance);
+            if(d01() * (uniform_weight + normal_weight) < uniform_weight)
             {
                 // Then it does come from the uniform distribution
                 return uniformMinDistance(min_distance);
@@ -542,7 +569,7 @@ namespace random_numbers
             else if(dispersal_method == "fat-tail-old")
             {
                 dispersalFunction = &RNGController::fattail_old;
-                dispersalFunctionMinDistance = &RNGController::fattailMinDistance;
+                dispersalFunctionMinDistance = &RNGController::fattailOldMinDistance;
 
                 if(tau > -2 || sigma < 0)
                 {
@@ -622,6 +649,60 @@ namespace random_numbers
         {
             return exponentialDistribution(lambda, d01());
         }
+        /**
+         * @brief Generates a random number from a Poisson distribution with the provided mean.
+         *
+         * Small means use sequential search of the cumulative distribution; larger means use the transformed
+         * rejection method (PTRS) of Hormann (1993), so that the expected cost does not grow with the mean.
+         * @param mean the mean of the Poisson distribution
+         * @return the randomly generated Poisson number
+         */
+        unsigned long randomPoisson(const double &mean)
+        {
+            if(mean <= 0.0)
+            {
+                return 0;
+            }
+            if(mean < 10.0)
+            {
+                double probability = exp(-mean);
+                double cumulative = probability;
+                const double u = d01();
+                unsigned long k = 0;
+                while(u > cumulative && probability > 0.0)
+                {
+                    k++;
+                    probability *= mean / k;
+                    cumulative += probability;
+                }
+                return k;
+            }
+            const double log_mean = log(mean);
+            const double b = 0.931 + 2.53 * sqrt(mean);
+            const double a = -0.059 + 0.02483 * b;
+            const double inverse_alpha = 1.1239 + 1.1328 / (b - 3.4);
+            const double v_r = 0.9277 - 3.6224 / (b - 2);
+            while(true)
+            {
+                const double u = d01() - 0.5;
+                const double v = d01();
+                const double u_s = 0.5 - fabs(u);
+                const double k = floor((2 * a / u_s + b) * u + mean + 0.43);
+                if(u_s >= 0.07 && v <= v_r)
+                {
+                    return static_cast<unsigned long>(k);
+                }
+                if(k < 0 || (u_s < 0.013 && v > u_s))
+                {
+                    continue;
+                }
+                if(log(v) + log(inverse_alpha) - log(a / (u_s * u_s) + b) <= -mean + k * log_mean - lgamma(k + 1))
+                {
+                    return static_cast<unsigned long>(k);
+                }
+            }
+        }
+
         template<typename T>
         const static T exponentialDistribution(const T lambda, const T r)
         {
@@ -8,7 +8,11 @@
  *
  * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
  */
+#include <algorithm>
+#include <cctype>
+#include <sstream>
 #include "SQLiteHandler.h"
+#include "Logging.h"
 
 using namespace std::chrono_literals;
 
@@ -42,7 +46,8 @@ namespace necsim
         sqlite3_reset(stmt);
     }
 
-    SQLiteHandler::SQLiteHandler() : database(nullptr), file_name(""), stmt(nullptr)
+    SQLiteHandler::SQLiteHandler() : database(nullptr), file_name(""), stmt(nullptr), statement_cache(),
+                                     transaction_depth(0)
     {
 
     }
@@ -77,6 +82,8 @@ namespace necsim
 
     void SQLiteHandler::close()
     {
+        clearStatementCache();
+        transaction_depth = 0;
         sqlite3_close_v2(database);
         database = nullptr;
     }
@@ -188,14 +195,125 @@ namespace necsim
         }
     }
 
+    void SQLiteHandler::setPragmas(const SQLitePragmas &pragmas)
+    {
+        // The page size must be set before the database file is created and before the journal mode is changed, as it
+        // is ignored once the database is in WAL mode.
+        if(pragmas.page_size > 0)
+        {
+            execute("PRAGMA page_size=" + std::to_string(pragmas.page_size) + ";");
+        }
+        if(!pragmas.journal_mode.empty())
+        {
+            const std::vector<std::string> journal_modes = {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+            if(std::find(journal_modes.begin(), journal_modes.end(), pragmas.journal_mode) == journal_modes.end())
+            {
+                throw FatalException("Journal mode " + pragmas.journal_mode + " is not a valid SQLite journal mode.");
+            }
+            // The journal mode is returned, which differs from the requested mode if it is not supported (for
+            // example, WAL is not available for the unix-dotfile VFS).
+            auto journal_stmt = prepare("PRAGMA journal_mode=" + pragmas.journal_mode + ";");
+            int rc = journal_stmt->step();
+            std::string journal_mode;
+            if(rc == SQLITE_ROW)
+            {
+                journal_mode = reinterpret_cast<const char*>(sqlite3_column_text(journal_stmt->stmt, 0));
+            }
+            finalise();
+            std::transform(journal_mode.begin(), journal_mode.end(), journal_mode.begin(), ::toupper);
+            if(journal_mode != pragmas.journal_mode)
+            {
+                std::stringstream ss;
+                ss << "Could not set journal mode to " << pragmas.journal_mode << " for " << file_name
+                   << ", using " << journal_mode << " instead." << std::endl;
+                writeInfo(ss.str());
+            }
+        }
+        if(!pragmas.synchronous.empty())
+        {
+            const std::vector<std::string> synchronous_levels = {"OFF", "NORMAL", "FULL", "EXTRA"};
+            if(std::find(synchronous_levels.begin(), synchronous_levels.end(), pragmas.synchronous)
+               == synchronous_levels.end())
+            {
+                throw FatalException("Synchronous level " + pragmas.synchronous + " is not a valid SQLite level.");
+            }
+            execute("PRAGMA synchronous=" + pragmas.synchronous + ";");
+        }
+    }
+
+    shared_ptr<SQLStatement> SQLiteHandler::getCachedStatement(const std::string &command)
+    {
+        auto cached = statement_cache.find(command);
+        if(cached != statement_cache.end())
+        {
+            return cached->second;
+        }
+        auto cached_stmt = make_shared<SQLStatement>();
+        int rc = sqlite3_prepare_v2(database,
+                                    command.c_str(),
+                                    static_cast<int>(command.size()),
+                                    &cached_stmt->stmt,
+                                    nullptr);
+        if(rc != SQLITE_OK && rc != SQLITE_DONE)
+        {
+            std::stringstream ss;
+            ss << "Could not prepare statement: " << command << std::endl << getErrorMsg(rc);
+            throw FatalException(ss.str());
+        }
+        cached_stmt->last_command = command;
+        statement_cache[command] = cached_stmt;
+        return cached_stmt;
+    }
+
+    void SQLiteHandler::clearStatementCache()
+    {
+        for(auto &cached : statement_cache)
+        {
+            sqlite3_finalize(cached.second->stmt);
+            cached.second->stmt = nullptr;
+        }
+        statement_cache.clear();
+    }
+
+    int SQLiteHandler::getMaxVariables()
+    {
+        return sqlite3_limit(database, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+    }
+
     void SQLiteHandler::beginTransaction()
     {
-        execute("BEGIN TRANSACTION;");
+        if(transaction_depth == 0)
+        {
+            execute("BEGIN TRANSACTION;");
+        }
+        transaction_depth++;
     }
 
     void SQLiteHandler::endTransaction()
     {
-        execute("END TRANSACTION;");
+        if(transaction_depth == 0)
+        {
+            throw FatalException("Attempted to end a transaction which has not been started.");
+        }
+        transaction_depth--;
+        if(transaction_depth == 0)
+        {
+            execute("END TRANSACTION;");
+        }
+    }
+
+    void SQLiteHandler::rollbackTransaction()
+    {
+        if(transaction_depth > 0)
+        {
+            transaction_depth = 0;
+            sqlite3_exec(database, "ROLLBACK TRANSACTION;", nullptr, nullptr, nullptr);
+        }
+    }
+
+    bool SQLiteHandler::inTransaction() const
+    {
+        return transaction_depth > 0;
     }
 
     bool SQLiteHandler::isOpen()
@@ -226,4 +344,133 @@ namespace necsim
         finalise();
         return has_table;
     }
-}
\ No newline at end of file
+
+    SQLTransaction::SQLTransaction(SQLiteHandler &database_in) : database(database_in), committed(false)
+    {
+        database.beginTransaction();
+    }
+
+    SQLTransaction::~SQLTransaction()
+    {
+        if(!committed)
+        {
+            database.rollbackTransaction();
+        }
+    }
+
+    void SQLTransaction::commit()
+    {
+        if(!committed)
+        {
+            committed = true;
+            database.endTransaction();
+        }
+    }
+
+    SQLBulkInsert::SQLBulkInsert(SQLiteHandler &database_in, const std::string &table,
+                                 const std::vector<std::string> &columns, const unsigned long &rows_per_statement_in)
+            : database(database_in), insert_command(), row_placeholder(), column_count(columns.size()),
+              rows_per_statement(rows_per_statement_in), values(), rows_written(0)
+    {
+        if(columns.empty())
+        {
+            throw FatalException("Cannot insert into " + table + " without any columns.");
+        }
+        std::stringstream ss;
+        ss << "INSERT INTO " << table << " (";
+        for(unsigned long i = 0; i < columns.size(); i++)
+        {
+            ss << (i == 0 ? "" : ", ") << columns[i];
+            row_placeholder += i == 0 ? "(?" : ",?";
+        }
+        ss << ") VALUES ";
+        row_placeholder += ")";
+        insert_command = ss.str();
+        const auto max_rows = static_cast<unsigned long>(std::max(database.getMaxVariables(), 1)) / column_count;
+        rows_per_statement = std::max(std::min(rows_per_statement, max_rows), 1ul);
+        values.reserve(rows_per_statement * column_count);
+    }
+
+    SQLBulkInsert &SQLBulkInsert::add(const std::string &value)
+    {
+        values.emplace_back();
+        values.back().type = SQLBulkValue::Type::text;
+        values.back().text = value;
+        return *this;
+    }
+
+    void SQLBulkInsert::endRow()
+    {
+        if(values.size() % column_count != 0)
+        {
+            throw FatalException("Incorrect number of values added to row for " + insert_command);
+        }
+        if(values.size() >= rows_per_statement * column_count)
+        {
+            writeRows(rows_per_statement);
+            values.clear();
+        }
+    }
+
+    void SQLBulkInsert::flush()
+    {
+        const unsigned long row_count = values.size() / column_count;
+        if(row_count > 0)
+        {
+            writeRows(row_count);
+        }
+        values.clear();
+    }
+
+    unsigned long SQLBulkInsert::getRowsWritten() const
+    {
+        return rows_written;
+    }
+
+    void SQLBulkInsert::writeRows(const unsigned long &row_count)
+    {
+        std::string command = insert_command;
+        command.reserve(insert_command.size() + row_count * (row_placeholder.size() + 1));
+        for(unsigned long i = 0; i < row_count; i++)
+        {
+            command += i == 0 ? "" : ",";
+            command += row_placeholder;
+        }
+        command += ";";
+        auto stmt = database.getCachedStatement(command);
+        for(unsigned long i = 0; i < row_count * column_count; i++)
+        {
+            const auto &value = values[i];
+            const int index = static_cast<int>(i + 1);
+            switch(value.type)
+            {
+            case SQLBulkValue::Type::integer:
+                sqlite3_bind_int64(stmt->stmt, index, value.integer);
+                break;
+
+            case SQLBulkValue::Type::real:
+                sqlite3_bind_double(stmt->stmt, index, value.real);
+                break;
+
+            case SQLBulkValue::Type::text:
+                sqlite3_bind_text(stmt->stmt,
+                                  index,
+                                  value.text.c_str(),
+                                  static_cast<int>(value.text.size()),
+                                  SQLITE_TRANSIENT);
+                break;
+            }
+        }
+        int rc = stmt->step();
+        stmt->clearAndReset();
+        if(rc != SQLITE_DONE)
+        {
+            std::stringstream ss;
+            ss << "Could not insert into database. Check destination file has not been moved or deleted and that an "
+                  "entry doesn't already exist with the same ID." << std::endl;
+            ss << database.getErrorMsg(rc);
+            throw FatalException(ss.str());
+        }
+        rows_written += row_count;
+    }
+}
@@ -17,6 +17,10 @@
 #include <memory>
 #include <thread>
 #include <chrono>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #ifdef WIN_INSTALL
 #define NOMINMAX
@@ -58,6 +62,31 @@ namespace necsim
 
     };
 
+    /**
+     * @brief The pragmas to apply to a database connection. Empty values leave the SQLite defaults unchanged.
+     */
+    struct SQLitePragmas
+    {
+        // One of DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF.
+        std::string journal_mode;
+        // One of OFF, NORMAL, FULL or EXTRA.
+        std::string synchronous;
+        // Only has an effect before any tables are created in the database.
+        unsigned long page_size;
+
+        SQLitePragmas() : journal_mode(), synchronous(), page_size(0)
+        {
+
+        }
+
+        SQLitePragmas(std::string journal_mode_in, std::string synchronous_in, const unsigned long &page_size_in)
+                : journal_mode(std::move(journal_mode_in)), synchronous(std::move(synchronous_in)),
+                  page_size(page_size_in)
+        {
+
+        }
+    };
+
     /**
      * Handler for the SQLite connection, including proper opening and closing of the database object.
      */
@@ -67,6 +96,10 @@ namespace necsim
         sqlite3* database;
         std::string file_name;
         shared_ptr<SQLStatement> stmt;
+        // Prepared statements which are kept until the connection is closed, indexed by command.
+        std::map<std::string, shared_ptr<SQLStatement>> statement_cache;
+        // The number of nested transactions which have been started.
+        unsigned long transaction_depth;
     public:
         /**
          * @brief Default constructor
@@ -161,8 +194,36 @@ namespace necsim
          */
         void execute(const string &command);
 
+        /**
+         * @brief Applies the pragmas to the open connection.
+         * @param pragmas the journal mode, synchronous level and page size to set
+         */
+        void setPragmas(const SQLitePragmas &pragmas);
+
+        /**
+         * @brief Gets a prepared statement for the command, which is only prepared the first time it is requested.
+         *
+         * The statement is reset after each use, rather than finalised, and is finalised when the connection is closed.
+         * @param command the command to prepare
+         * @return pointer to the prepared statement
+         */
+        shared_ptr<SQLStatement> getCachedStatement(const std::string &command);
+
+        /**
+         * @brief Finalises all cached statements.
+         */
+        void clearStatementCache();
+
+        /**
+         * @brief Gets the maximum number of parameters that can be bound to a single statement.
+         * @return the maximum number of parameters
+         */
+        int getMaxVariables();
+
         /**
          * @brief Starts a transaction from this database object.
+         *
+         * Transactions can be nested, in which case only the outermost transaction is committed to the database.
          */
         void beginTransaction();
 
@@ -171,6 +232,17 @@ namespace necsim
          */
         void endTransaction();
 
+        /**
+         * @brief Rolls back the current transaction, including any nested transactions. Errors are ignored.
+         */
+        void rollbackTransaction();
+
+        /**
+         * @brief Checks if there is a transaction in progress.
+         * @return true if a transaction has been started and not ended
+         */
+        bool inTransaction() const;
+
         /**
          * @brief Checks if the database is open.
          * @return true, if the database is not a nullptr.
@@ -195,5 +267,146 @@ namespace necsim
          */
         bool hasTable(const std::string &table_name);
     };
+
+    /**
+     * @brief Holds a transaction open on the database for the lifetime of the object.
+     *
+     * The transaction is rolled back on destruction unless commit() has been called, so that an exception does not
+     * leave partial output in the database.
+     */
+    class SQLTransaction
+    {
+    private:
+        SQLiteHandler &database;
+        bool committed;
+
+    public:
+        /**
+         * @brief Starts the transaction.
+         * @param database_in the database to start the transaction on
+         */
+        explicit SQLTransaction(SQLiteHandler &database_in);
+
+        SQLTransaction(const SQLTransaction &) = delete;
+
+        SQLTransaction &operator=(const SQLTransaction &) = delete;
+
+        /**
+         * @brief Rolls back the transaction, if it has not been committed.
+         */
+        ~SQLTransaction();
+
+        /**
+         * @brief Ends the transaction.
+         */
+        void commit();
+    };
+
+    /**
+     * @brief A single value to insert using SQLBulkInsert.
+     */
+    struct SQLBulkValue
+    {
+        enum class Type
+        {
+            integer, real, text
+        };
+        Type type;
+        sqlite3_int64 integer;
+        double real;
+        std::string text;
+    };
+
+    /**
+     * @brief Inserts rows into a table using multi-row INSERT statements, which are prepared once and cached on the
+     * database.
+     *
+     * Values are added in column order, followed by a call to endRow(). Rows are written out once enough have been
+     * added to fill a statement, and any remaining rows are written by flush(), which must be called before the object
+     * is destroyed.
+     */
+    class SQLBulkInsert
+    {
+    private:
+        SQLiteHandler &database;
+        std::string insert_command;
+        std::string row_placeholder;
+        unsigned long column_count;
+        unsigned long rows_per_statement;
+        std::vector<SQLBulkValue> values;
+        unsigned long rows_written;
+
+        /**
+         * @brief Writes out the first row_count rows of values in a single statement.
+         * @param row_count the number of rows to write
+         */
+        void writeRows(const unsigned long &row_count);
+
+    public:
+        /**
+         * @brief Creates the bulk insert for the given table and columns.
+         * @param database_in the database to insert into
+         * @param table the name of the table
+         * @param columns the names of the columns to insert values for
+         * @param rows_per_statement_in the maximum number of rows to insert in each statement, which is reduced if the
+         * database cannot bind enough parameters
+         */
+        SQLBulkInsert(SQLiteHandler &database_in, const std::string &table, const std::vector<std::string> &columns,
+                      const unsigned long &rows_per_statement_in = 100);
+
+        SQLBulkInsert(const SQLBulkInsert &) = delete;
+
+        SQLBulkInsert &operator=(const SQLBulkInsert &) = delete;
+
+        /**
+         * @brief Adds an integer value to the current row.
+         * @param value the value to add
+         * @return this object, for chaining
+         */
+        template<class T> typename std::enable_if<std::is_integral<T>::value, SQLBulkInsert &>::type add(const T &value)
+        {
+            values.emplace_back();
+            values.back().type = SQLBulkValue::Type::integer;
+            values.back().integer = static_cast<sqlite3_int64>(value);
+            return *this;
+        }
+
+        /**
+         * @brief Adds a floating point value to the current row.
+         * @param value the value to add
+         * @return this object, for chaining
+         */
+        template<class T> typename std::enable_if<std::is_floating_point<T>::value, SQLBulkInsert &>::type
+        add(const T &value)
+        {
+            values.emplace_back();
+            values.back().type = SQLBulkValue::Type::real;
+            values.back().real = static_cast<double>(value);
+            return *this;
+        }
+
+        /**
+         * @brief Adds a text value to the current row.
+         * @param value the value to add
+         * @return this object, for chaining
+         */
+        SQLBulkInsert &add(const std::string &value);
+
+        /**
+         * @brief Ends the current row, writing out the buffered rows if there are enough to fill a statement.
+         */
+        void endRow();
+
+        /**
+         * @brief Writes out all buffered rows.
+         */
+        void flush();
+
+        /**
+         * @brief Gets the number of rows that have been written to the database.
+         * @return the number of rows written
+         */
+        unsigned long getRowsWritten() const;
+    };
 }
 #endif //SQLITEHANDLER_H
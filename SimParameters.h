@@ -81,9 +81,15 @@ namespace necsim
         unsigned long sample_x_offset{}, sample_y_offset{};
         // The fine map variables at the same resolution as the grid.
         unsigned long fine_map_x_size{}, fine_map_y_size{}, fine_map_x_offset{}, fine_map_y_offset{};
+        // if true, the fine map densities between the present and historical maps are stored rather than interpolated
+        // on every lookup, using more memory.
+        bool materialise_fine_density{};
         // the coarse map variables at a scaled resolution of the fine map.
         unsigned long coarse_map_x_size{}, coarse_map_y_size{}, coarse_map_x_offset{}, coarse_map_y_offset{};
         unsigned long coarse_map_scale{};
+        // the memory in megabytes for keeping tiles of each coarse map, which are then read when needed (0 to import
+        // the coarse maps whole).
+        unsigned long coarse_map_cache_size{};
         unsigned long desired_specnum{};
         // the relative cost of moving through non-forest
         double dispersal_relative_cost{};
@@ -140,6 +146,18 @@ namespace necsim
         // a map of relative reproduction probabilities.
         string reproduction_file;
 
+        // the format to use when pausing simulations, either text or binary.
+        string pause_format;
+
+        // the interval in seconds and in steps between periodic checkpoints of the simulation (0 to disable).
+        unsigned long checkpoint_interval{}, checkpoint_steps{};
+
+        // the SQLite journal mode and synchronous level for the output database (empty to use the SQLite defaults).
+        string sqlite_journal_mode, sqlite_synchronous;
+
+        // the page size for new output databases (0 to use the SQLite default).
+        unsigned long sqlite_page_size{};
+
         std::queue<HistoricalMapParameters> all_historical_map_parameters;
         bool has_parsed_historical;
 
@@ -160,6 +178,7 @@ namespace necsim
             death_file = "none";
             reproduction_file = "none";
             dispersal_file = "none";
+            pause_format = "text";
             min_speciation_gen = 0.0;
             max_speciation_gen = 0.0;
             is_protracted = false;
@@ -220,12 +239,16 @@ namespace necsim
             fine_map_y_size = stoul(configs.getSectionOptions("fine_map", "y", "0"));
             fine_map_x_offset = stoul(configs.getSectionOptions("fine_map", "x_off", "0"));
             fine_map_y_offset = stoul(configs.getSectionOptions("fine_map", "y_off", "0"));
+            materialise_fine_density = static_cast<bool>(stoi(configs.getSectionOptions("fine_map",
+                                                                                         "materialise_density",
+                                                                                         "0")));
             coarse_map_file = configs.getSectionOptions("coarse_map", "path", "none");
             coarse_map_x_size = stoul(configs.getSectionOptions("coarse_map", "x", "0"));
             coarse_map_y_size = stoul(configs.getSectionOptions("coarse_map", "y", "0"));
             coarse_map_x_offset = stoul(configs.getSectionOptions("coarse_map", "x_off", "0"));
             coarse_map_y_offset = stoul(configs.getSectionOptions("coarse_map", "y_off", "0"));
             coarse_map_scale = stoul(configs.getSectionOptions("coarse_map", "scale", "0"));
+            coarse_map_cache_size = stoul(configs.getSectionOptions("coarse_map", "cache_size", "0"));
             historical_fine_map_file = configs.getSectionOptions("historical_fine0", "path", "none");
             historical_coarse_map_file = configs.getSectionOptions("historical_coarse0", "path", "none");
             dispersal_method = configs.getSectionOptions("dispersal", "method", "none");
@@ -238,6 +261,12 @@ namespace necsim
             death_file = configs.getSectionOptions("death", "map", "none");
             reproduction_file = configs.getSectionOptions("reproduction", "map", "none");
             output_directory = configs.getSectionOptions("main", "output_directory", "Default");
+            pause_format = configs.getSectionOptions("main", "pause_format", "text");
+            checkpoint_interval = stoul(configs.getSectionOptions("main", "checkpoint_interval", "0"));
+            checkpoint_steps = stoul(configs.getSectionOptions("main", "checkpoint_steps", "0"));
+            sqlite_journal_mode = configs.getSectionOptions("sqlite", "journal_mode", "");
+            sqlite_synchronous = configs.getSectionOptions("sqlite", "synchronous", "");
+            sqlite_page_size = stoul(configs.getSectionOptions("sqlite", "page_size", "0"));
             seed = stol(configs.getSectionOptions("main", "seed", "0"));
             task = stol(configs.getSectionOptions("main", "task", "0"));
             tau = stod(configs.getSectionOptions("main", "tau", "0.0"));
@@ -571,6 +600,22 @@ namespace necsim
             return needs_update;
         }
 
+        /**
+         * @brief Gets the parameters of the historical maps which follow the current historical maps.
+         * @param next_parameters the parameters of the next historical maps
+         * @return true if there are further historical maps
+         */
+        bool getNextHistorical(HistoricalMapParameters &next_parameters)
+        {
+            parseHistorical();
+            if(all_historical_map_parameters.empty())
+            {
+                return false;
+            }
+            next_parameters = all_historical_map_parameters.front();
+            return true;
+        }
+
         /**
          * @brief Checks if there will be another update to be performed on the map.
          * @return true if another map update exists
@@ -238,10 +238,7 @@ namespace necsim
             mutex.lock();
             writeRepeatInfo(finished);
             finished++;
-            mutex.unlock();
-
-            std::fill(distance_accumulator.begin(), distance_accumulator.end(), 0.0);
-
+            // Random start cells come from the shared random number generator, so must be drawn inside the lock.
             if(chooseRandomCells)
             {
                 start_cell = getRandomCell();
@@ -250,6 +247,9 @@ namespace necsim
             {
                 start_cell = cells[i];
             }
+            mutex.unlock();
+
+            std::fill(distance_accumulator.begin(), distance_accumulator.end(), 0.0);
 
             for(unsigned long k = 0; k < num_repeats; k++)
             {
@@ -19,8 +19,8 @@ namespace necsim
 {
     SimulatedSpeciesAbundancesHandler::SimulatedSpeciesAbundancesHandler() : species_abundances(),
                                                                              species_richness_per_abundance(),
-                                                                             cumulative_abundance_map(
-                                                                                     make_shared<std::map<unsigned long, unsigned long>>()),
+                                                                             abundance_classes(),
+                                                                             abundance_sampler(),
                                                                              total_species_number(0),
                                                                              number_of_individuals(0)
     { }
@@ -68,7 +68,7 @@ namespace necsim
             metacommunity_size += item.second;
         }
         generateAbundanceTable(abundance_list);
-        generateCumulativeAbundances(abundance_list);
+        generateAbundanceSampler(abundance_list);
     }
 
     void SimulatedSpeciesAbundancesHandler::setAbundanceList(shared_ptr<vector<unsigned long>> abundance_list_in)
@@ -76,7 +76,7 @@ namespace necsim
         max_species_id = 0;
         number_of_individuals = 0;
         generateAbundanceTable(abundance_list_in);
-        generateCumulativeAbundances(abundance_list_in);
+        generateAbundanceSampler(abundance_list_in);
     }
 
     void SimulatedSpeciesAbundancesHandler::generateAbundanceTable(shared_ptr<vector<unsigned long>> abundance_list)
@@ -95,94 +95,62 @@ namespace necsim
         writeInfo("done.\n");
     }
 
-    void SimulatedSpeciesAbundancesHandler::generateCumulativeAbundances(
-            shared_ptr<vector<unsigned long>> abundance_list)
+    void SimulatedSpeciesAbundancesHandler::generateAbundanceSampler(shared_ptr<vector<unsigned long>> abundance_list)
     {
-        writeInfo("Generating cumulative abundances...");
+        writeInfo("Generating abundance sampler...");
         if(abundance_list->empty())
         {
             throw FatalException("Abundance list is empty - please report this bug.");
         }
-        // Holds a sorted abundance list (as doubles).
-        vector<unsigned long> temp_cumulative_abundances;
-        temp_cumulative_abundances.resize(abundance_list->size(), 0);
-        partial_sum(abundance_list->begin(), abundance_list->end(), temp_cumulative_abundances.begin());
-#ifdef DEBUG
-        unsigned long total_sum = accumulate(abundance_list->begin(), abundance_list->end(), (unsigned long) 0);
-        if(temp_cumulative_abundances.empty())
+        // Every species with the same abundance is equally likely, so only the abundance values need to be chosen from,
+        // weighted by the total number of individuals with each abundance.
+        std::map<unsigned long, unsigned long> individuals_per_abundance;
+        for(const auto &abundance : *abundance_list)
         {
-            throw FatalException("Temporary cumulative abundance list is empty - please report this bug.");
+            if(abundance > 0)
+            {
+                individuals_per_abundance[abundance] += abundance;
+            }
         }
-        if(total_sum == 0)
+        if(individuals_per_abundance.empty())
         {
             throw FatalException("Total sum of abundances is 0 - please report this bug.");
         }
-#endif // DEBUG
-
-        for(unsigned long i = 0; i < temp_cumulative_abundances.size(); i++)
+        abundance_classes.clear();
+        abundance_classes.reserve(individuals_per_abundance.size());
+        vector<unsigned long> weights;
+        weights.reserve(individuals_per_abundance.size());
+        for(const auto &item : individuals_per_abundance)
         {
-            (*cumulative_abundance_map)[temp_cumulative_abundances[i]] = (*abundance_list)[i];
+            abundance_classes.push_back(item.first);
+            weights.push_back(item.second);
         }
-        if(cumulative_abundance_map->begin()->second == 0)
-        {
 #ifdef DEBUG
-            if(cumulative_abundance_map->begin()->first != 0)
-            {
-                std::stringstream ss;
-                ss << "Species abundance generated for " << cumulative_abundance_map->begin()->first;
-                ss << " has zero abundance. Please report this bug." << std::endl;
-                throw FatalException(ss.str());
-            }
-#endif // DEBUG
-            // Remove the first 0 (if there is one)
-            cumulative_abundance_map->erase(cumulative_abundance_map->begin());
-        }
-#ifdef DEBUG
-        if(cumulative_abundance_map->rbegin()->first != metacommunity_size)
+        unsigned long total_sum = accumulate(weights.begin(), weights.end(), (unsigned long) 0);
+        if(total_sum != metacommunity_size)
         {
             std::stringstream ss;
-            ss << "Last cumulative abundance value (" << cumulative_abundance_map->rbegin()->first;
-            ss << ") is not equal to community size (" << metacommunity_size << "). Please report this bug." << std::endl;
-            throw FatalException(ss.str());
-        }
-        if(metacommunity_size == 1 && cumulative_abundance_map->size() != 1)
-        {
-            std::stringstream ss;
-            ss << "Community size is 1, but cumulative abundance map has " << cumulative_abundance_map->size();
-            ss << " elements. Please report this bug." << std::endl;
+            ss << "Total of abundances (" << total_sum << ") is not equal to community size (" << metacommunity_size;
+            ss << "). Please report this bug." << std::endl;
             throw FatalException(ss.str());
         }
 #endif // DEBUG
+        abundance_sampler.setup(weights);
         writeInfo("done.\n");
     }
 
     unsigned long SimulatedSpeciesAbundancesHandler::getRandomAbundanceOfIndividual()
     {
 #ifdef DEBUG
-        if(cumulative_abundance_map->size() == 1)
-        {
-            if(cumulative_abundance_map->begin()->second == 0)
-            {
-                throw FatalException("Only one abundance found in abundance list, and it is 0. Please report this bug.");
-            }
-            return cumulative_abundance_map->begin()->second;
-        }
-        if(cumulative_abundance_map->empty())
+        if(abundance_classes.empty() || abundance_sampler.size() != abundance_classes.size())
         {
-            throw FatalException("Cumulative abundance map is empty. Please report this bug.");
+            throw FatalException("Abundance sampler has not been generated. Please report this bug.");
         }
-        if(metacommunity_size == 1)
+#endif // DEBUG
+        if(abundance_classes.size() == 1)
         {
-            std::stringstream ss;
-            ss << "Community size is 1 with cumulative abundance map: " << std::endl;
-            for(const auto &item: *cumulative_abundance_map)
-            {
-                ss << item.first << ": " << item.second << std::endl;
-            }
-            ss << "Please report this bug." << std::endl;
-            throw FatalException(ss.str());
+            return abundance_classes[0];
         }
-#endif // DEBUG
-        return cumulative_abundance_map->upper_bound(random->i0(metacommunity_size - 1))->second;
+        return abundance_classes[abundance_sampler.sample(random->d01())];
     }
 }
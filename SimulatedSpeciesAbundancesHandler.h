@@ -23,6 +23,7 @@
 
 #include "neutral_analytical.h"
 #include "RNGController.h"
+#include "AliasSampler.h"
 #include "custom_exceptions.h"
 #include "double_comparison.h"
 #include "SpeciesAbundancesHandler.h"
@@ -42,8 +43,10 @@ namespace necsim
         std::map<unsigned long, vector<unsigned long>> species_abundances;
         // Maps abundance values to the maximum number of species expected to be contained.
         std::map<unsigned long, unsigned long> species_richness_per_abundance;
-        // Maps cumulative probabilities of choosing each abundance to abundance values
-        shared_ptr<std::map<unsigned long, unsigned long>> cumulative_abundance_map;
+        // Each abundance value which can be chosen, in the order of the alias table
+        vector<unsigned long> abundance_classes;
+        // Alias table for choosing an abundance value, weighted by the number of individuals with that abundance
+        AliasSampler abundance_sampler;
         // Total species number
         double total_species_number;
         unsigned long number_of_individuals;
@@ -80,11 +83,10 @@ namespace necsim
         void generateAbundanceTable(shared_ptr<vector<unsigned long>> abundance_list);
 
         /**
-         * @brief Generates the cumulative abundances, rescaled from 0-1, for randomly choosing an abundance using binary
-         * search
+         * @brief Generates the alias table for randomly choosing the abundance of an individual in constant time.
          * @param abundance_list vector of species abundances
          */
-        void generateCumulativeAbundances(shared_ptr<vector<unsigned long>> abundance_list);
+        void generateAbundanceSampler(shared_ptr<vector<unsigned long>> abundance_list);
 
         /**
          * @brief Gets a random species abundance.
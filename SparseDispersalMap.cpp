@@ -0,0 +1,264 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file SparseDispersalMap.cpp
+ * @brief Contains the SparseDispersalMap class for storing dispersal probability maps as compressed rows.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "SparseDispersalMap.h"
+#include "AliasSampler.h"
+#include "Map.h"
+#include "custom_exceptions.h"
+#include "Logging.h"
+
+namespace necsim
+{
+    SparseDispersalMap::SparseDispersalMap() : num_cols(0), file_name(), row_start(1, 0), column(), raw_value(),
+                                               cumulative(), alias_probability(), alias_entry(),
+                                               exclude_self_dispersal(false)
+    {
+
+    }
+
+    void SparseDispersalMap::import(const string &file_name_in, const unsigned long &dimension)
+    {
+        if(!fs::exists(file_name_in) || fs::is_directory(file_name_in))
+        {
+            std::stringstream ss;
+            ss << "Cannot import from " << file_name_in << ": file does not exist.";
+            throw FatalException(ss.str());
+        }
+        clear();
+        file_name = file_name_in;
+        num_cols = dimension;
+        Map<double> reader;
+        bool has_warned = false;
+        const bool is_tif = reader.importTifRows(file_name, [this, &dimension, &has_warned](const unsigned long &,
+                                                                                           const vector<double> &row)
+        {
+            if(row.size() != dimension && !has_warned)
+            {
+                has_warned = true;
+                std::stringstream ss;
+                ss << "Raster data size does not match inputted dimensions for " << file_name
+                   << ". Using raster sizes." << std::endl;
+                writeWarning(ss.str());
+            }
+            num_cols = row.size();
+            addRow(row);
+        });
+        if(!is_tif)
+        {
+            // Other formats are read in full, then compressed row by row.
+            reader.setSize(dimension, dimension);
+            reader.import(file_name);
+            num_cols = reader.getCols();
+            vector<double> row(reader.getCols());
+            for(unsigned long i = 0; i < reader.getRows(); i++)
+            {
+                for(unsigned long j = 0; j < reader.getCols(); j++)
+                {
+                    row[j] = reader.get(i, j);
+                }
+                addRow(row);
+            }
+        }
+        std::stringstream ss;
+        ss << "Stored " << getNonZeroCount() << " non-zero dispersal probabilities for " << getRows() << " cells."
+           << std::endl;
+        writeInfo(ss.str());
+    }
+
+    void SparseDispersalMap::addRow(const vector<double> &row)
+    {
+        num_cols = std::max(num_cols, static_cast<unsigned long>(row.size()));
+        for(unsigned long i = 0; i < row.size(); i++)
+        {
+            if(row[i] != 0.0)
+            {
+                column.push_back(i);
+                raw_value.push_back(row[i]);
+            }
+        }
+        cumulative.resize(raw_value.size(), 0.0);
+        alias_probability.resize(raw_value.size(), 1.0);
+        alias_entry.resize(raw_value.size(), 0);
+        row_start.push_back(raw_value.size());
+    }
+
+    void SparseDispersalMap::clear()
+    {
+        num_cols = 0;
+        file_name.clear();
+        row_start.assign(1, 0);
+        column.clear();
+        raw_value.clear();
+        cumulative.clear();
+        alias_probability.clear();
+        alias_entry.clear();
+    }
+
+    unsigned long SparseDispersalMap::getRows() const
+    {
+        return row_start.size() - 1;
+    }
+
+    unsigned long SparseDispersalMap::getCols() const
+    {
+        return num_cols;
+    }
+
+    unsigned long SparseDispersalMap::getNonZeroCount() const
+    {
+        return raw_value.size();
+    }
+
+    const string &SparseDispersalMap::getFileName() const
+    {
+        return file_name;
+    }
+
+    unsigned long SparseDispersalMap::rowBegin(const unsigned long &row) const
+    {
+        return row_start[row];
+    }
+
+    unsigned long SparseDispersalMap::rowEnd(const unsigned long &row) const
+    {
+        return row_start[row + 1];
+    }
+
+    unsigned long SparseDispersalMap::getColumn(const unsigned long &entry) const
+    {
+        return column[entry];
+    }
+
+    double SparseDispersalMap::getRawValue(const unsigned long &entry) const
+    {
+        return raw_value[entry];
+    }
+
+    double SparseDispersalMap::getRawValue(const unsigned long &row, const unsigned long &col) const
+    {
+        const auto begin = column.begin() + row_start[row];
+        const auto end = column.begin() + row_start[row + 1];
+        const auto found = std::lower_bound(begin, end, col);
+        if(found == end || *found != col)
+        {
+            return 0.0;
+        }
+        return raw_value[found - column.begin()];
+    }
+
+    double SparseDispersalMap::getProbability(const unsigned long &entry) const
+    {
+        // The row containing the entry is needed to know if this is the first value in the row.
+        const auto row = static_cast<unsigned long>(std::upper_bound(row_start.begin(), row_start.end(), entry)
+                                                    - row_start.begin() - 1);
+        if(entry == row_start[row])
+        {
+            return cumulative[entry];
+        }
+        return cumulative[entry] - cumulative[entry - 1];
+    }
+
+    double SparseDispersalMap::getProbability(const unsigned long &row, const unsigned long &col) const
+    {
+        const auto begin = column.begin() + row_start[row];
+        const auto end = column.begin() + row_start[row + 1];
+        const auto found = std::lower_bound(begin, end, col);
+        if(found == end || *found != col)
+        {
+            return 0.0;
+        }
+        const auto entry = static_cast<unsigned long>(found - column.begin());
+        if(entry == row_start[row])
+        {
+            return cumulative[entry];
+        }
+        return cumulative[entry] - cumulative[entry - 1];
+    }
+
+    double SparseDispersalMap::sumRawRow(const unsigned long &row) const
+    {
+        double total = 0.0;
+        for(unsigned long entry = row_start[row]; entry < row_start[row + 1]; entry++)
+        {
+            total += raw_value[entry];
+        }
+        return total;
+    }
+
+    void SparseDispersalMap::setExcludeSelfDispersal(const bool &exclude)
+    {
+        exclude_self_dispersal = exclude;
+    }
+
+    bool SparseDispersalMap::isIncluded(const unsigned long &row, const unsigned long &entry) const
+    {
+        return !exclude_self_dispersal || column[entry] != row;
+    }
+
+    void SparseDispersalMap::calculateCumulative(const vector<double> &density, const vector<double> &reproduction)
+    {
+        if(density.size() < num_cols || (!reproduction.empty() && reproduction.size() < num_cols))
+        {
+            throw FatalException("Weights do not cover all columns of the dispersal map. Please report this bug.");
+        }
+        vector<unsigned long> small_work;
+        vector<unsigned long> large_work;
+        for(unsigned long row = 0; row < getRows(); row++)
+        {
+            // Store the weighted values first, then generate the alias table and convert to cumulative probabilities.
+            double total_value = 0.0;
+            for(unsigned long entry = row_start[row]; entry < row_start[row + 1]; entry++)
+            {
+                double value = 0.0;
+                if(isIncluded(row, entry))
+                {
+                    value = raw_value[entry] * density[column[entry]];
+                    if(!reproduction.empty())
+                    {
+                        value *= reproduction[column[entry]];
+                    }
+                }
+                cumulative[entry] = value;
+                total_value += value;
+            }
+            const unsigned long row_size = row_start[row + 1] - row_start[row];
+            random_numbers::AliasSampler::generateTable(cumulative.data() + row_start[row], row_size,
+                                                        alias_probability.data() + row_start[row],
+                                                        alias_entry.data() + row_start[row], small_work, large_work);
+            if(total_value == 0.0)
+            {
+                continue;
+            }
+            double running_total = 0.0;
+            for(unsigned long entry = row_start[row]; entry < row_start[row + 1]; entry++)
+            {
+                running_total += cumulative[entry] / total_value;
+                cumulative[entry] = running_total;
+            }
+        }
+    }
+
+    unsigned long SparseDispersalMap::sample(const unsigned long &row, const double &random_number) const
+    {
+        const unsigned long row_size = row_start[row + 1] - row_start[row];
+        if(row_size == 0)
+        {
+            std::stringstream ss;
+            ss << "No dispersal probabilities from row " << row << " of the dispersal map." << std::endl;
+            throw FatalException(ss.str());
+        }
+        const unsigned long entry = random_numbers::AliasSampler::sampleTable(alias_probability.data() + row_start[row],
+                                                                              alias_entry.data() + row_start[row],
+                                                                              row_size, random_number);
+        return column[row_start[row] + entry];
+    }
+}
@@ -0,0 +1,186 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file SparseDispersalMap.h
+ * @brief Contains the SparseDispersalMap class for storing dispersal probability maps as compressed rows.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_SPARSEDISPERSALMAP_H
+#define NECSIM_SPARSEDISPERSALMAP_H
+
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief Stores a dispersal probability map as the non-zero values of each row (compressed sparse rows).
+     *
+     * Rows are the source cells and columns are the destination cells. The raw values from the dispersal map file are
+     * kept, so that the cumulative probabilities can be recalculated when the density or reproduction rates of the
+     * destination cells change. Memory use scales with the number of non-zero values, rather than with the square of
+     * the number of cells. Each row also has an alias table, so sampling a destination takes constant time.
+     */
+    class SparseDispersalMap
+    {
+    protected:
+        unsigned long num_cols;
+        string file_name;
+        // The index of the first non-zero value in each row, followed by the total number of non-zero values.
+        vector<unsigned long> row_start;
+        // The column of each non-zero value.
+        vector<unsigned long> column;
+        // The raw value from the dispersal map file for each non-zero value.
+        vector<double> raw_value;
+        // The cumulative probability across the row, including each non-zero value.
+        vector<double> cumulative;
+        // The alias table for each row, indexed relative to the start of the row.
+        vector<double> alias_probability;
+        vector<unsigned long> alias_entry;
+        // If true, dispersal from a cell to itself is given zero probability.
+        bool exclude_self_dispersal;
+
+    public:
+        SparseDispersalMap();
+
+        /**
+         * @brief Imports the dispersal map from file, storing only the non-zero values.
+         *
+         * Tif files are read one row at a time, so that the full matrix is never held in memory.
+         * @param file_name_in the path to the dispersal map file
+         * @param dimension the expected number of rows and columns
+         */
+        void import(const string &file_name_in, const unsigned long &dimension);
+
+        /**
+         * @brief Adds a row to the end of the map, storing the non-zero values.
+         * @param row the values of every column in the row
+         */
+        void addRow(const vector<double> &row);
+
+        /**
+         * @brief Removes all rows from the map.
+         */
+        void clear();
+
+        /**
+         * @brief Gets the number of rows in the map.
+         * @return the number of rows
+         */
+        unsigned long getRows() const;
+
+        /**
+         * @brief Gets the number of columns in the map.
+         * @return the number of columns
+         */
+        unsigned long getCols() const;
+
+        /**
+         * @brief Gets the number of non-zero values stored.
+         * @return the number of non-zero values
+         */
+        unsigned long getNonZeroCount() const;
+
+        /**
+         * @brief Gets the file the map was imported from.
+         * @return the file name
+         */
+        const string &getFileName() const;
+
+        /**
+         * @brief Gets the index of the first non-zero value in the row.
+         * @param row the row index
+         * @return the index of the first non-zero value
+         */
+        unsigned long rowBegin(const unsigned long &row) const;
+
+        /**
+         * @brief Gets the index after the last non-zero value in the row.
+         * @param row the row index
+         * @return the index after the last non-zero value
+         */
+        unsigned long rowEnd(const unsigned long &row) const;
+
+        /**
+         * @brief Gets the column of the non-zero value.
+         * @param entry the index of the non-zero value
+         * @return the column
+         */
+        unsigned long getColumn(const unsigned long &entry) const;
+
+        /**
+         * @brief Gets the raw value from the dispersal map file for the non-zero value.
+         * @param entry the index of the non-zero value
+         * @return the raw value
+         */
+        double getRawValue(const unsigned long &entry) const;
+
+        /**
+         * @brief Gets the raw value from the dispersal map file for the given row and column.
+         * @param row the row index
+         * @param col the column index
+         * @return the raw value, which is 0 if the value is not stored
+         */
+        double getRawValue(const unsigned long &row, const unsigned long &col) const;
+
+        /**
+         * @brief Gets the probability of dispersal for the non-zero value, from the cumulative probabilities.
+         * @param entry the index of the non-zero value
+         * @return the probability of dispersal
+         */
+        double getProbability(const unsigned long &entry) const;
+
+        /**
+         * @brief Gets the probability of dispersal from the row to the column.
+         * @param row the row index
+         * @param col the column index
+         * @return the probability of dispersal
+         */
+        double getProbability(const unsigned long &row, const unsigned long &col) const;
+
+        /**
+         * @brief Sums the raw values across the row.
+         * @param row the row index
+         * @return the sum of the raw values
+         */
+        double sumRawRow(const unsigned long &row) const;
+
+        /**
+         * @brief Sets whether dispersal from a cell to itself should be given zero probability.
+         * @param exclude if true, self-dispersal is excluded when calculating the cumulative probabilities
+         */
+        void setExcludeSelfDispersal(const bool &exclude);
+
+        /**
+         * @brief Checks if the non-zero value is used for dispersal.
+         * @param row the row of the non-zero value
+         * @param entry the index of the non-zero value
+         * @return false if the value is self-dispersal, which has been excluded
+         */
+        bool isIncluded(const unsigned long &row, const unsigned long &entry) const;
+
+        /**
+         * @brief Calculates the cumulative probabilities and alias tables for each row from the raw values, multiplied
+         * by the density and reproduction rate of the destination column.
+         *
+         * Rows with a total of zero have all cumulative probabilities set to zero.
+         * @param density the density of each column
+         * @param reproduction the reproduction rate of each column, or empty if all reproduction rates are equal
+         */
+        void calculateCumulative(const vector<double> &density, const vector<double> &reproduction);
+
+        /**
+         * @brief Picks the destination column for the random number, using the alias table of the row.
+         * @param row the row index of the source cell
+         * @param random_number a random number between 0 and 1
+         * @return the destination column
+         */
+        unsigned long sample(const unsigned long &row, const double &random_number) const;
+    };
+}
+#endif //NECSIM_SPARSEDISPERSALMAP_H
@@ -12,6 +12,7 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include "SpatialTree.h"
 
 #ifdef WIN_INSTALL
@@ -21,7 +22,6 @@
 #define dup2 _dup2
 #endif
 
-#include "eastl/heap.h"
 
 namespace necsim
 {
@@ -126,6 +126,7 @@ namespace necsim
         {
             // Set the dimensions
             landscape->setDims(sim_parameters);
+            landscape->setCoarseMapCacheSize(sim_parameters->coarse_map_cache_size);
             try
             {
                 // Set the time variables
@@ -287,12 +288,15 @@ namespace necsim
 #endif
             generateObjects();
         }
+        // The landscape is only used by this thread, so the interpolated densities can be stored between lookups.
+        landscape->setMaterialiseDensity(sim_parameters->materialise_fine_density);
     }
 
     unsigned long SpatialTree::fillObjects(const unsigned long &initial_count)
     {
         active[0].setup(0, 0, 0, 0, 0, 0, 0);
         grid.setSize(sim_parameters->grid_y_size, sim_parameters->grid_x_size);
+        wrapped_lineages.clear();
         unsigned long number_start = 0;
         std::stringstream os;
         os << "\rSetting up simulation...filling grid                           " << std::flush;
@@ -315,11 +319,7 @@ namespace necsim
                     samplegrid.recalculateCoordinates(x, y, x_wrap, y_wrap);
                     if(grid.get(y, x).getListSize() == 0)
                     {
-                        unsigned long stored_next = grid.get(y, x).getNext();
-                        unsigned long stored_nwrap = grid.get(y, x).getNwrap();
                         grid.get(y, x).initialise(landscape->getVal(x, y, 0, 0, 0));
-                        grid.get(y, x).setNwrap(stored_nwrap);
-                        grid.get(y, x).setNext(stored_next);
                     }
                     if(x_wrap == 0 && y_wrap == 0)
                     {
@@ -383,7 +383,7 @@ namespace necsim
                                                                number_start,
                                                                0,
                                                                1);
-                                    addWrappedLineage(number_start, x, y);
+                                    addWrappedLineage(number_start);
                                     // Add a tip in the TreeNode for calculation of the coalescence tree at the
                                     // end of the simulation.
                                     // This also contains the start x and y position of the species.
@@ -462,17 +462,7 @@ namespace necsim
         {
             return grid.get(location.y, location.x).getListSize();
         }
-        unsigned long next = grid.get(location.y, location.x).getNext();
-        unsigned long total = 0;
-        while(next != 0)
-        {
-            if(static_cast<MapLocation>(active[next]) == location)
-            {
-                total++;
-            }
-            next = active[next].getNext();
-        }
-        return total;
+        return wrapped_lineages.count(location);
     }
 
     unsigned long SpatialTree::getNumberIndividualsAtLocation(const MapLocation &location) const
@@ -482,19 +472,11 @@ namespace necsim
 
     void SpatialTree::removeOldPosition(const unsigned long &chosen)
     {
-        long nwrap = active[chosen].getNwrap();
         long oldx = active[chosen].getXpos();
         long oldy = active[chosen].getYpos();
-        if(nwrap == 0)
+        unsigned long moved;
+        if(active[chosen].isOnGrid())
         {
-#ifdef DEBUG
-
-            if(active[chosen].getXwrap() != 0 || active[chosen].getYwrap() != 0)
-            {
-                active[chosen].logActive(50);
-                throw FatalException("ERROR_MOVE_015: Nwrap not set correctly. Nwrap 0, but x and y wrap not 0. ");
-            }
-#endif // DEBUG
             // Then the lineage exists in the main lineage_indices;
             // debug (can be removed later)
 #ifdef historical_mode
@@ -506,105 +488,19 @@ namespace necsim
                 throw FatalException("ERROR_MOVE_001: Listpos outside maxsize. Check move programming function.");
             }
 #endif
-            // delete the species from the lineage_indices
-            grid.get(oldy, oldx).deleteSpecies(active[chosen].getListpos());
-            // clear out the variables.
-            active[chosen].setNext(0);
-            active[chosen].setNwrap(0);
-            active[chosen].setListPosition(0);
-        }
-        else  // need to loop over the nwrap to check nexts
-        {
-            if(nwrap == 1)
-            {
-                grid.get(oldy, oldx).setNext(active[chosen].getNext());
-                // Now reduce the nwrap of the lineages that have been effected.
-                long nextpos = active[chosen].getNext();
-                // loop over the rest of the lineage_indices, reducing the nwrap
-                while(nextpos != 0)
-                {
-                    active[nextpos].decreaseNwrap();
-                    nextpos = active[nextpos].getNext();
-                }
-                // decrease the nwrap
-                grid.get(oldy, oldx).decreaseNwrap();
-                active[chosen].setNwrap(0);
-                active[chosen].setNext(0);
-                active[chosen].setListPosition(0);
-            }
-            else
-            {
-                long lastpos = grid.get(oldy, oldx).getNext();
-                while(active[lastpos].getNext()
-                      != chosen)  // loop until we reach the next, then set the next correctly.
-                {
-                    lastpos = active[lastpos].getNext();
-                }
-                if(lastpos != 0)
-                {
-                    active[lastpos].setNext(active[chosen].getNext());
-#ifdef DEBUG
-                    if(active[lastpos].getNwrap() != (active[chosen].getNwrap() - 1))
-                    {
-                        writeLog(50, "Logging last position: ");
-                        active[lastpos].logActive(50);
-                        writeLog(50, "Logging chosen position: ");
-                        active[chosen].logActive(50);
-                        throw FatalException("Nwrap setting of either chosen or the "
-                                             "lineage wrapped before chosen. Check move function.");
-                    }
-#endif // DEBUG
-                    lastpos = active[lastpos].getNext();
-                    while(lastpos != 0)
-                    {
-                        active[lastpos].decreaseNwrap();
-                        lastpos = active[lastpos].getNext();
-                    }
-                }
-                else
-                {
-#ifdef DEBUG
-                    writeLog(50, "Logging chosen");
-                    active[chosen].logActive(50);
-#endif // DEBUG
-                    throw FatalException("Last position before chosen is 0 - this is impossible.");
-                }
-                grid.get(oldy, oldx).decreaseNwrap();
-                active[chosen].setNwrap(0);
-                active[chosen].setNext(0);
-                active[chosen].setListPosition(0);
-            }
-#ifdef DEBUG
-            unsigned long iCount = 1;
-            long pos = grid.get(oldy, oldx).getNext();
-            if(pos == 0)
-            {
-                iCount = 0;
-            }
-            else
-            {
-                unsigned long c = 0;
-                while(active[pos].getNext() != 0)
-                {
-                    c++;
-                    iCount++;
-                    pos = active[pos].getNext();
-                    if(c > std::numeric_limits<unsigned long>::max())
-                    {
-                        throw FatalException("ERROR_MOVE_014: Wrapping exceeds numeric limits.");
-                    }
-                }
-            }
-
-            if(iCount != grid.get(oldy, oldx).getNwrap())
-            {
-                std::stringstream ss;
-                ss << "Nwrap: " << grid.get(oldy, oldx).getNwrap() << " Counted lineages: " << iCount << std::endl;
-                writeLog(50, ss);
-                throw FatalException("Nwrap not set correctly after move for grid cell");
-            }
-#endif // DEBUG
+            // delete the species from the lineage_indices, updating the lineage moved into its place
+            moved = grid.get(oldy, oldx).deleteSpecies(active[chosen].getListpos());
+        }
+        else
+        {
+            moved = wrapped_lineages.remove(active[chosen], active[chosen].getListpos());
+        }
+        if(moved != 0)
+        {
+            active[moved].setListPosition(active[chosen].getListpos());
         }
+        // clear out the variables.
+        active[chosen].setListPosition(0);
     }
 
     void SpatialTree::calcMove()
@@ -637,14 +533,8 @@ namespace necsim
     {
 
         // Calculate the new position of the move, whilst also calculating the probability of coalescence.
-        unsigned long nwrap = active[this_step.chosen].getNwrap();
         if(this_step.isOnGrid())
         {
-            // Debug check (to remove later)
-            if(nwrap != 0)
-            {
-                throw FatalException("Nwrap not set correctly. Check move programming function.");
-            }
             // then the procedure is relatively simple.
             // check for coalescence
             // check if the grid needs to be updated.
@@ -670,7 +560,7 @@ namespace necsim
                     active[this_step.chosen].logActive(50);
                     writeLog(50, "Logging this_step.coalchosen: ");
                     active[this_step.coalchosen].logActive(50);
-                    throw FatalException("Nwrap not set correctly. Please report this bug.");
+                    throw FatalException("Coalescing lineage is not at the same location. Please report this bug.");
                 }
             }
 #endif
@@ -689,49 +579,19 @@ namespace necsim
                         "ERROR_MOVE_001: Listpos outside maxsize. Check move programming function.");
                 }
 #endif
-                active[this_step.chosen].setNwrap(0);
                 active[this_step.chosen].setListPosition(tmplistindex);
                 this_step.coal = false;
             }
             else  // then coalescence has occured
             {
-                active[this_step.chosen].setNwrap(0);
                 active[this_step.chosen].setListPosition(0);
                 // DO THE COALESCENCE STUFF
                 this_step.coal = true;
             }
         }
-        else  // need to check all the possible places the lineage could be.
+        else  // need to check the lineages at the same wrapped location.
         {
-            if(nwrap != 0)
-            {
-                throw FatalException("Nwrap not set correctly in move.");
-            }
-            nwrap = grid.get(this_step.y, this_step.x).getNwrap();
-            if(nwrap != 0)  // then coalescence is possible and we need to loop over the nexts to check those that are
-                // in the same position
-            {
-                calcWrappedCoalescence(nwrap);
-            }
-            else  // just add the lineage to next.
-            {
-                if(grid.get(this_step.y, this_step.x).getNext() != 0)
-                {
-                    throw FatalException("No nwrap recorded, but next is non-zero.");
-                }
-                this_step.coalchosen = 0;
-                this_step.coal = false;
-                grid.get(this_step.y, this_step.x).setNext(this_step.chosen);
-                active[this_step.chosen].setNwrap(1);
-                active[this_step.chosen].setNext(0);
-                grid.get(this_step.y, this_step.x).increaseNwrap();
-#ifdef DEBUG
-                if(grid.get(this_step.y, this_step.x).getNwrap() != 1)
-                {
-                    throw FatalException("Nwrap not set correctly in move.");
-                }
-#endif
-            }
+            calcWrappedCoalescence();
             if(this_step.coalchosen != 0)
             {
                 if(active[this_step.coalchosen].getXpos() != (unsigned long) this_step.x
@@ -745,97 +605,31 @@ namespace necsim
                     writeLog(50, "Logging this_step.coalchosen: ");
                     active[this_step.coalchosen].logActive(50);
 #endif // DEBUG
-                    throw FatalException("Nwrap not set correctly. Check move "
+                    throw FatalException("Coalescing lineage is not at the same location. Check move "
                                          "programming function.");
                 }
             }
         }
     }
 
-    void SpatialTree::calcWrappedCoalescence(const unsigned long &nwrap)
+    void SpatialTree::calcWrappedCoalescence()
     {
-
-        // Count the possible matches of the position.
-        unsigned long matches = 0;
-        // Create an array containing the lineage_indices of active references for those that match as
-        // this stops us having to loop twice over the same lineage_indices.
-        vector<unsigned long> match_list(nwrap);
-        unsigned long next_active;
-        next_active = grid.get(this_step.y, this_step.x).getNext();
-        // Count if the first "next" matches
-        if(active[next_active].getXwrap() == this_step.xwrap && active[next_active].getYwrap() == this_step.ywrap)
-        {
-#ifdef DEBUG
-            if(active[next_active].getNwrap() != 1)
-            {
-                throw FatalException("ERROR_MOVE_022a: Nwrap not set correctly in move.");
-            }
-#endif
-            match_list[matches] = next_active;  // add the match to the lineage_indices of matches.
-            matches++;
-        }
-        // Now loop over the remaining nexts counting matches
-        //#ifdef DEBUG
-        unsigned long ncount = 1;
-        //#endif
-        while(active[next_active].getNext() != 0)
-        {
-            next_active = active[next_active].getNext();
-            if(active[next_active].getXwrap() == this_step.xwrap && active[next_active].getYwrap() == this_step.ywrap)
-            {
-                match_list[matches] = next_active;
-                matches++;
-            }
-            // check
-            //#ifdef DEBUG
-            ncount++;
-#ifdef DEBUG
-            if(active[next_active].getNwrap() != ncount)
-            {
-                throw FatalException("ERROR_MOVE_022d: Nwrap not set correctly in move.");
-            }
-#endif
-        }
-        if(nwrap != ncount)
-        {
-            throw FatalException("Nwrap not set correctly in move.");
-        }
-        // Matches now contains the number of lineages at the exact x,y, xwrap and ywrap position.
-        // Check if there were no matches at all
-        if(matches == 0)
-        {
-            this_step.coalchosen = 0;
-            this_step.coal = false;
-            active[next_active].setNext(this_step.chosen);
-            grid.get(this_step.y, this_step.x).increaseNwrap();
-            active[this_step.chosen].setNwrap(grid.get(this_step.y, this_step.x).getNwrap());
-            active[this_step.chosen].setListPosition(0);
-        }
-        else  // if there were matches, generate a random number to see if coalescence occured or not
+        // The lineages at the exact x, y, xwrap and ywrap position.
+        const unsigned long matches = wrapped_lineages.count(this_step);
+        this_step.coalchosen = 0;
+        this_step.coal = false;
+        if(matches != 0)
         {
+            // Generate a random number to see if coalescence occurred or not
             unsigned long randwrap = floor(NR->d01() * (landscape->getVal(this_step.x,
                                                                           this_step.y,
                                                                           this_step.xwrap,
                                                                           this_step.ywrap,
                                                                           generation)) + 1);
-            // Get the random reference from the match lineage_indices.
-            // If the movement is to an empty space, then we can update the chain to include the new
-            // lineage.
-            if(randwrap > matches)  // coalescence has not occured
-            {
-                // os << "This shouldn't happen" << std::endl;
-                this_step.coalchosen = 0;
-                this_step.coal = false;
-                active[next_active].setNext(this_step.chosen);
-                grid.get(this_step.y, this_step.x).increaseNwrap();
-
-                active[this_step.chosen].setNwrap(grid.get(this_step.y, this_step.x).getNwrap());
-                active[this_step.chosen].setListPosition(0);
-            }
-            else  // coalescence has occured
+            if(randwrap <= matches)  // coalescence has occured
             {
                 this_step.coal = true;
-                this_step.coalchosen = match_list[randwrap - 1];
+                this_step.coalchosen = wrapped_lineages.get(this_step, randwrap - 1);
                 active[this_step.chosen].setEndpoint<Step>(this_step);
                 if(this_step.coalchosen == 0)
                 {
@@ -843,6 +637,11 @@ namespace necsim
                 }
             }
         }
+        if(!this_step.coal)
+        {
+            // Add the lineage to the lineages at this location.
+            active[this_step.chosen].setListPosition(wrapped_lineages.add(this_step, this_step.chosen));
+        }
 #ifdef historical_mode
         if(grid.get(this_step.y, this_step.x).getMaxsize() < active[this_step.chosen].getListpos())
             {
@@ -869,99 +668,22 @@ namespace necsim
             tmpdatactive.setup(active[chosen]);
             // now need to remove the chosen lineage from memory, by replacing it with the lineage that lies in the last
             // place.
-            if(active[endactive].getXwrap() == 0
-               && active[endactive].getYwrap() == 0)  // if the end lineage is simple, we can just copy it across.
+            if(active[endactive].isOnGrid())
             {
-                // check endactive
-                if(active[endactive].getNwrap() != 0)
-                {
-                    std::stringstream ss;
-                    ss << "Nwrap is not set correctly for endactive (nwrap should be 0, but is ";
-                    ss << active[endactive].getNwrap() << " ). Identified during switch of positions." << std::endl;
-                    writeError(ss.str());
-                }
                 grid.get(active[endactive].getYpos(),
                          active[endactive].getXpos()).setSpecies(active[endactive].getListpos(), chosen);
-                active[chosen].setup(active[endactive]);
-                active[endactive].setup(tmpdatactive);
-                active[endactive].setNwrap(0);
-                active[endactive].setNext(0);
             }
-            else  // else the end lineage is wrapped, and needs to be processed including the wrapping routines.
+            else
             {
-                if(active[endactive].getNwrap() == 0)
-                {
-                    std::stringstream ss;
-                    ss << "Nwrap is not set correctly for endactive (nwrap incorrectly 0).";
-                    ss << "Identified during switch of positions." << std::endl;
-                    writeError(ss.str());
-                }
-                //				os << "wrap"<<endl;
-                long tmpactive = grid.get(active[endactive].getYpos(), active[endactive].getXpos()).getNext();
-                unsigned long tmpnwrap = active[endactive].getNwrap();
-
-                // if the wrapping is just once, we need to set the grid next to the chosen variable.
-                if(tmpnwrap == 1)
-                {
-                    // check
-                    if(grid.get(active[endactive].getYpos(), active[endactive].getXpos()).getNext() != endactive)
-                    {
-                        throw FatalException(string("Nwrap for endactive not set correctly. Nwrap is 1, but "
-                                                    "lineage at 1st position is " + std::to_string((long long) grid.get(
-                                active[endactive].getYpos(),
-                                active[endactive].getXpos()).getNext()) + ". Identified during the move."));
-                    }
-                    grid.get(active[endactive].getYpos(), active[endactive].getXpos()).setNext(chosen);
-                }
-                else  // otherwise, we just set the next to chosen instead of endactive.
-                {
-                    unsigned long tmpcount = 0;
-                    // loop over nexts until we reach the right lineage.
-                    while(active[tmpactive].getNext() != endactive)
-                    {
-                        tmpactive = active[tmpactive].getNext();
-                        tmpcount++;
-#ifdef DEBUG
-                        if(tmpcount > tmpnwrap)
-                        {
-                            writeLog(30, "Looping has not encountered a match, "
-                                         "despite going further than required. Check nwrap counting.");
-                            if(tmpactive == 0)
-                            {
-                                std::stringstream ss;
-                                ss << "gridnext: "
-                                   << grid.get(active[endactive].getYpos(), active[endactive].getXpos()).getNext()
-                                   << std::endl;
-                                ss << "endactive: " << endactive << std::endl;
-                                ss << "tmpactive: " << tmpactive << std::endl;
-                                ss << "tmpnwrap: " << tmpnwrap << " tmpcount: " << tmpcount << std::endl;
-                                writeLog(50, ss);
-                                writeLog(50, "Logging chosen:");
-                                active[chosen].logActive(50);
-                                throw FatalException("No match found, please report this bug.");
-                            }
-                        }
-#endif // DEBUG
-                    }
-                    active[tmpactive].setNext(chosen);
-                }
-                active[chosen].setup(active[endactive]);
-                active[endactive].setup(tmpdatactive);
-
-                // check - debugging
-                unsigned long testwrap = active[chosen].getNwrap();
-                unsigned long testnext = grid.get(active[chosen].getYpos(), active[chosen].getXpos()).getNext();
-                for(unsigned long i = 1; i < testwrap; i++)
-                {
-                    testnext = active[testnext].getNext();
-                }
-
-                if(testnext != chosen)
-                {
-                    throw FatalException("ERROR_MOVE_009: Nwrap position not set correctly after coalescence. "
-                                         "Check move process.");
-                }
+                wrapped_lineages.set(active[endactive], active[endactive].getListpos(), chosen);
             }
+            active[chosen].setup(active[endactive]);
+            active[endactive].setup(tmpdatactive);
+        }
+        if(!death_weights_outdated)
+        {
+            death_weights.set(chosen, death_weights.get(endactive));
+            death_weights.set(endactive, 0.0);
         }
         endactive--;
     }
@@ -969,10 +691,23 @@ namespace necsim
     void SpatialTree::calcNextStep()
     {
         calcMove();
+        // Moves to another cell would also be events in the Gillespie algorithm.
+        const bool left_cell = active[this_step.chosen].getXpos() != static_cast<unsigned long>(this_step.x)
+                               || active[this_step.chosen].getYpos() != static_cast<unsigned long>(this_step.y)
+                               || active[this_step.chosen].getXwrap() != this_step.xwrap
+                               || active[this_step.chosen].getYwrap() != this_step.ywrap;
         // Calculate the new position, perform the move if coalescence doesn't occur or
         // return the variables for the coalescence event if coalescence does occur.
         active[this_step.chosen].setEndpoint<Step>(this_step);
         calcNewPos();
+        if(left_cell || this_step.coal)
+        {
+            gillespie_step_events++;
+        }
+        if(!this_step.coal)
+        {
+            updateDeathWeight(this_step.chosen);
+        }
     }
 
     unsigned long SpatialTree::estSpecnum()
@@ -1092,15 +827,65 @@ namespace necsim
 
     }
 
-    void SpatialTree::updateStepCoalescenceVariables()
+    void SpatialTree::chooseRandomLineage()
     {
-        while(!death_map->actionOccurs(active[this_step.chosen].getXpos(),
-                                       active[this_step.chosen].getYpos(),
-                                       active[this_step.chosen].getXwrap(),
-                                       active[this_step.chosen].getYwrap()))
+        if(death_map->isNull())
         {
-            this_step.chosen = NR->i0(endactive - 1) + 1;  // cannot be 0
+            Tree::chooseRandomLineage();
+            return;
         }
+        incrementGeneration();
+        // Choose a lineage to die with probability proportional to the death rate at its location
+        if(death_weights_outdated || death_weights.size() != active.size())
+        {
+            generateDeathWeights();
+        }
+        const double total_weight = death_weights.total();
+        if(total_weight <= 0.0)
+        {
+            throw FatalException("No active lineages have a non-zero death probability.");
+        }
+        this_step.chosen = death_weights.find(NR->d01() * total_weight);
+#ifdef DEBUG
+        if(this_step.chosen == 0 || this_step.chosen > endactive)
+        {
+            std::stringstream ss;
+            ss << "Chosen lineage (" << this_step.chosen << ") is outside active (" << endactive << ")." << std::endl;
+            throw FatalException(ss.str());
+        }
+#endif // DEBUG
+        updateStepCoalescenceVariables();
+    }
+
+    double SpatialTree::getLineageDeathWeight(const unsigned long &lineage)
+    {
+        return death_map->getVal(active[lineage].getXpos(),
+                                 active[lineage].getYpos(),
+                                 active[lineage].getXwrap(),
+                                 active[lineage].getYwrap());
+    }
+
+    void SpatialTree::generateDeathWeights()
+    {
+        vector<double> weights(active.size(), 0.0);
+        for(unsigned long i = 1; i <= endactive && i < active.size(); i++)
+        {
+            weights[i] = getLineageDeathWeight(i);
+        }
+        death_weights.assign(weights);
+        death_weights_outdated = false;
+    }
+
+    void SpatialTree::updateDeathWeight(const unsigned long &lineage)
+    {
+        if(!death_weights_outdated && lineage < death_weights.size())
+        {
+            death_weights.set(lineage, getLineageDeathWeight(lineage));
+        }
+    }
+
+    void SpatialTree::updateStepCoalescenceVariables()
+    {
         recordLineagePosition();
 #ifdef historical_mode
         historicalStepChecks();
@@ -1160,7 +945,7 @@ namespace necsim
             active[endactive] = item;
             if(item.getXwrap() != 0 || item.getYwrap() != 0)
             {
-                addWrappedLineage(endactive, item.getXpos(), item.getYpos());
+                addWrappedLineage(endactive);
             }
         }
         // double check sizes
@@ -1173,6 +958,7 @@ namespace necsim
         {
             startendactive = endactive;
         }
+        death_weights_outdated = true;
 #ifdef DEBUG
         validateLineages();
 #endif
@@ -1230,6 +1016,13 @@ namespace necsim
     void SpatialTree::simPause()
     {
         // This function dumps all simulation data to a file.
+        if(usesBinaryPause())
+        {
+            auto out1 = initiateBinaryPause();
+            dumpCheckpoint(*out1);
+            completePause(out1);
+            return;
+        }
         auto out1 = initiatePause();
         dumpMain(out1);
         dumpMap(out1);
@@ -1269,17 +1062,72 @@ namespace necsim
         }
     }
 
+    void SpatialTree::dumpMap(CheckpointSink &out)
+    {
+        // The landscape only stores the map variables (the maps themselves are re-imported on resume).
+        std::stringstream ss;
+        ss << std::setprecision(64);
+        ss << *landscape;
+        out.beginSection(CheckpointSection::map);
+        out.writeString(ss.str());
+        out.endSection();
+    }
+
+    void SpatialTree::dumpGrid(CheckpointSink &out)
+    {
+        // Only the list lengths are required, as the grid contents are re-created from active.
+        out.beginSection(CheckpointSection::grid);
+        out.writeValue<uint64_t>(grid.getRows());
+        out.writeValue<uint64_t>(grid.getCols());
+        vector<uint64_t> list_lengths;
+        list_lengths.reserve(grid.getCols());
+        for(unsigned long i = 0; i < grid.getRows(); i++)
+        {
+            list_lengths.clear();
+            for(unsigned long j = 0; j < grid.getCols(); j++)
+            {
+                list_lengths.push_back(grid.get(i, j).getListLength());
+            }
+            out.write(list_lengths.data(), list_lengths.size() * sizeof(uint64_t));
+        }
+        out.endSection();
+    }
+
+    void SpatialTree::dumpCheckpoint(CheckpointSink &out)
+    {
+        dumpMain(out);
+        dumpMap(out);
+        dumpActive(out);
+        dumpGrid(out);
+        dumpData(out);
+    }
+
     void SpatialTree::simResume()
     {
         initiateResume();
-        auto is = openSaveFile();
-        // now load the objects
-        loadMainSave(is);
-        loadMapSave(is);
-        setObjectSizes();
-        loadActiveSave(is);
-        loadGridSave(is);
-        loadDataSave(is);
+        const string checkpoint_file = findResumeCheckpoint(pause_sim_directory);
+        if(!checkpoint_file.empty())
+        {
+            CheckpointReader reader;
+            reader.open(checkpoint_file);
+            loadMainSave(reader);
+            loadMapSave(reader);
+            setObjectSizes();
+            loadActiveSave(reader);
+            loadGridSave(reader);
+            loadDataSave(reader);
+        }
+        else
+        {
+            auto is = openSaveFile();
+            // now load the objects
+            loadMainSave(is);
+            loadMapSave(is);
+            setObjectSizes();
+            loadActiveSave(is);
+            loadGridSave(is);
+            loadDataSave(is);
+        }
         time(&sim_start);
         writeInfo("\rLoading data from temp file...done.\n");
         sim_parameters->printVars();
@@ -1289,6 +1137,34 @@ namespace necsim
     {
         grid.setSize(sim_parameters->grid_y_size, sim_parameters->grid_x_size);
         *in1 >> grid;
+        fillGridFromActive();
+    }
+
+    void SpatialTree::loadGridSave(const CheckpointReader &in1)
+    {
+        grid.setSize(sim_parameters->grid_y_size, sim_parameters->grid_x_size);
+        auto section = in1.getSection(CheckpointSection::grid);
+        auto rows = section.readValue<uint64_t>();
+        auto cols = section.readValue<uint64_t>();
+        if(rows != grid.getRows() || cols != grid.getCols())
+        {
+            std::stringstream ss;
+            ss << "Dimensions of grid in checkpoint (" << cols << ", " << rows << ") do not match the simulation ";
+            ss << "grid (" << grid.getCols() << ", " << grid.getRows() << ")." << std::endl;
+            throw FatalException(ss.str());
+        }
+        for(unsigned long i = 0; i < grid.getRows(); i++)
+        {
+            for(unsigned long j = 0; j < grid.getCols(); j++)
+            {
+                grid.get(i, j).setListLength(section.readValue<uint64_t>());
+            }
+        }
+        fillGridFromActive();
+    }
+
+    void SpatialTree::fillGridFromActive()
+    {
         try
         {
             std::stringstream os;
@@ -1304,23 +1180,42 @@ namespace necsim
                 }
             }
             // Now fill the grid object with lineages from active. Only need to loop once.
+            vector<unsigned long> wrapped;
             for(unsigned long i = 1; i <= endactive; i++)
             {
-                if(active[i].getXwrap() == 0 && active[i].getYwrap() == 0)
+                if(active[i].isOnGrid())
                 {
                     grid.get(active[i].getYpos(), active[i].getXpos()).setSpeciesEmpty(active[i].getListpos(), i);
                 }
                 else
                 {
-                    if(active[i].getNwrap() == 0)
-                    {
-                        throw std::runtime_error("Nwrap should not be 0 if x and y wrap are not 0. Programming error likely.");
-                    }
-                    if(active[i].getNwrap() == 1)
+                    wrapped.push_back(i);
+                }
+            }
+            // Wrapped lineages are added in order of their position at each location, so that the lists are restored
+            // exactly. Older versions did not store the position, in which case the lineages are added in order.
+            std::stable_sort(wrapped.begin(), wrapped.end(), [this](const unsigned long &a, const unsigned long &b)
+            {
+                return active[a].getListpos() < active[b].getListpos();
+            });
+            wrapped_lineages.clear();
+            for(const auto &i : wrapped)
+            {
+                active[i].setListPosition(wrapped_lineages.add(active[i], i));
+            }
+            // Simulations paused by older versions can have gaps in the lists, which must be removed.
+            for(unsigned long i = 0; i < sim_parameters->grid_y_size; i++)
+            {
+                for(unsigned long j = 0; j < sim_parameters->grid_x_size; j++)
+                {
+                    SpeciesList &species_list = grid.get(i, j);
+                    if(species_list.compact())
                     {
-                        grid.get(active[i].getYpos(), active[i].getXpos()).setNext(i);
+                        for(unsigned long k = 0; k < species_list.getListSize(); k++)
+                        {
+                            active[species_list.getLineageIndex(k)].setListPosition(k);
+                        }
                     }
-                    grid.get(active[i].getYpos(), active[i].getXpos()).increaseNwrap();
                 }
             }
         }
@@ -1333,6 +1228,11 @@ namespace necsim
     }
 
     void SpatialTree::loadMapSave(shared_ptr<std::ifstream> in1)
+    {
+        loadMapSave(*in1);
+    }
+
+    void SpatialTree::loadMapSave(std::istream &in1)
     {
         // Input the map object
         try
@@ -1341,7 +1241,8 @@ namespace necsim
             os << "\rLoading data from temp file...map..." << std::flush;
             writeInfo(os.str());
             landscape->setDims(sim_parameters);
-            *in1 >> *landscape;
+            landscape->setCoarseMapCacheSize(sim_parameters->coarse_map_cache_size);
+            in1 >> *landscape;
             samplegrid.importSampleMask(sim_parameters);
             importActivityMaps();
         }
@@ -1353,6 +1254,13 @@ namespace necsim
         }
     }
 
+    void SpatialTree::loadMapSave(const CheckpointReader &in1)
+    {
+        auto section = in1.getSection(CheckpointSection::map);
+        std::istringstream is(section.readString());
+        loadMapSave(is);
+    }
+
     void SpatialTree::verifyActivityMaps()
     {
         bool has_printed = false;
@@ -1447,32 +1355,11 @@ namespace necsim
 
     }
 
-    void SpatialTree::addWrappedLineage(unsigned long numstart, long x, long y)
+    void SpatialTree::addWrappedLineage(const unsigned long &numstart)
     {
-
-        if(grid.get(y, x).getNwrap() == 0)
-        {
-            grid.get(y, x).setNext(numstart);
-            grid.get(y, x).setNwrap(1);
-            active[numstart].setNwrap(1);
-        }
-        else
-        {
-            unsigned long tmp_next = grid.get(y, x).getNext();
-            unsigned long tmp_last = tmp_next;
-            unsigned long tmp_nwrap = 0;
-            while(tmp_next != 0)
-            {
-                tmp_nwrap++;
-                tmp_last = tmp_next;
-                tmp_next = active[tmp_next].getNext();
-            }
-            grid.get(y, x).increaseNwrap();
-            active[tmp_last].setNext(numstart);
-            active[numstart].setNwrap(tmp_nwrap + 1);
-        }
+        active[numstart].setListPosition(wrapped_lineages.add(active[numstart], numstart));
 #ifdef DEBUG
-        debugAddingLineage(numstart, x, y);
+        debugAddingLineage(numstart);
 #endif
     }
 
@@ -1522,18 +1409,15 @@ namespace necsim
         }
         else
         {
-            unsigned long next = grid.get(y, x).getNext();
-            while(next != 0 && num_to_add > 0)
+            const MapLocation location(x, y, xwrap, ywrap);
+            const unsigned long lineage_count = wrapped_lineages.count(location);
+            for(unsigned long i = 0; i < lineage_count && num_to_add > 0; i++)
             {
-                if(active[next].getXwrap() == xwrap && active[next].getYwrap() == ywrap)
+                if(checkProportionAdded(proportion_added))
                 {
-                    if(checkProportionAdded(proportion_added))
-                    {
-                        num_to_add--;
-                        makeTip(next, generation_in, data_added);
-                    }
+                    num_to_add--;
+                    makeTip(wrapped_lineages.get(location, i), generation_in, data_added);
                 }
-                next = active[next].getNext();
             }
         }
         return num_to_add;
@@ -1586,22 +1470,141 @@ namespace necsim
     void SpatialTree::addGillespie(const double &g_threshold)
     {
         std::stringstream ss;
-        ss << "Using gillespie algorithm in simulation from generation " << g_threshold << "." << std::endl;
+        ss << "Using gillespie algorithm in simulation from " << g_threshold << " lineages." << std::endl;
         writeInfo(ss.str());
         gillespie_threshold = g_threshold;
+        automatic_gillespie = false;
+        using_gillespie = true;
+    }
+
+    void SpatialTree::addAutomaticGillespie()
+    {
+        writeInfo("Using gillespie algorithm in simulation once expected to be faster.\n");
+        automatic_gillespie = true;
         using_gillespie = true;
     }
 
+    bool SpatialTree::continueBeforeGillespie() const
+    {
+        return (endactive > 1) && ((steps < 100) || difftime(sim_end, start) < maxtime) && this_step.bContinueSim;
+    }
+
+    void SpatialTree::runSimulationBeforeGillespie()
+    {
+        if(!automatic_gillespie)
+        {
+            while(static_cast<double>(endactive) >= gillespie_threshold && continueBeforeGillespie())
+            {
+                runSingleLoop();
+                checkPeriodicCheckpoint();
+            }
+            return;
+        }
+        while(continueBeforeGillespie())
+        {
+            // Measure the speed over at least half a generation, so that the proportion of steps which would be
+            // Gillespie events reflects the current distribution of lineages.
+            const long window_start = steps;
+            const auto window_steps = static_cast<long>(std::max(endactive, static_cast<unsigned long>(100000)));
+            gillespie_step_events = 0;
+            const auto window_start_time = std::chrono::steady_clock::now();
+            do
+            {
+                runSingleLoop();
+                checkPeriodicCheckpoint();
+            }
+            while(steps - window_start < window_steps && continueBeforeGillespie());
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - window_start_time;
+            const auto window_total = static_cast<double>(steps - window_start);
+            // Keep the last complete measurement if the simulation has finished.
+            if(!continueBeforeGillespie())
+            {
+                return;
+            }
+            if(elapsed.count() <= 0.0)
+            {
+                continue;
+            }
+            gillespie_rates.step_rate = window_total / elapsed.count();
+            gillespie_rates.event_proportion = static_cast<double>(spec + (1.0 - spec) * gillespie_step_events
+                                                                                / window_total);
+            gillespie_rates.estimated_event_rate = estimateGillespieEventRate();
+            // Each step of the per-step algorithm would be replaced by event_proportion Gillespie events.
+            if(gillespie_rates.estimated_event_rate > gillespie_rates.event_proportion * gillespie_rates.step_rate)
+            {
+                return;
+            }
+        }
+    }
+
+    double SpatialTree::estimateGillespieEventRate() const
+    {
+        if(endactive < 2 || gillespie_rates.step_rate <= 0.0)
+        {
+            return 0.0;
+        }
+        // A Gillespie event moves a lineage as a step of the per-step algorithm does, but also takes the next event
+        // from the heap and recalculates the event times of the origin and destination cells. Only this extra work is
+        // timed, on a scratch heap of the largest size the real heap could have. A separate random number generator is
+        // used so that the simulation is unaffected.
+        const unsigned long probe_events = 1000;
+        RNGController probe_random;
+        probe_random.setSeed(static_cast<uint64_t>(seed));
+        IndexedHeap probe_heap;
+        probe_heap.setIndexCount(endactive);
+        for(unsigned long i = 0; i < endactive; i++)
+        {
+            probe_heap.pushUnordered(i, generation + probe_random.d01());
+        }
+        probe_heap.heapify();
+        const auto probe_start_time = std::chrono::steady_clock::now();
+        for(unsigned long event = 0; event < probe_events; event++)
+        {
+            const IndexedHeap::Entry next = probe_heap.top();
+            for(unsigned long end = 0; end < 2; end++)
+            {
+                const DataPoint &lineage = active[1 + probe_random.i0(endactive - 1)];
+                GillespieProbability gp(lineage);
+                gp.setDispersalOutsideCellProbability(
+                        1.0 - dispersal_coordinator.getSelfDispersalValue(convertMapLocationToCell(lineage)));
+                gp.setSpeciationProbability(spec);
+                gp.setCoalescenceProbability(calculateCoalescenceProbability(lineage));
+                gp.setRandomNumber(probe_random.d01());
+                const double time = gp.calcTimeToNextEvent(getLocalDeathRate(lineage), summed_death_rate,
+                                                           getNumberIndividualsAtLocation(lineage));
+                probe_heap.update(end == 0 ? next.index : probe_random.i0(endactive - 1), next.time + time);
+            }
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - probe_start_time;
+        const double event_overhead = elapsed.count() / static_cast<double>(probe_events);
+        return 1.0 / (1.0 / gillespie_rates.step_rate + event_overhead);
+    }
+
     bool SpatialTree::runSimulationGillespie()
     {
-        do
+        if(!dispersal_coordinator.isFullDispersalMap())
+        {
+            // Without a dispersal map, the Gillespie algorithm would keep every lineage within its starting cell.
+            writeWarning("The Gillespie algorithm requires a dispersal map - using the per-step algorithm instead.\n");
+            return runSimulationNoGillespie();
+        }
+        runSimulationBeforeGillespie();
+        if(!continueBeforeGillespie())
+        {
+            return stopSimulation();
+        }
+        gillespie_rates.switch_generation = generation;
+        gillespie_rates.switch_lineages = endactive;
+        std::stringstream ss;
+        ss << "Switching to Gillespie algorithm at generation " << generation << " with " << endactive
+           << " lineages." << std::endl;
+        if(automatic_gillespie)
         {
-            runSingleLoop();
+            ss << "Per-step algorithm ran at " << gillespie_rates.step_rate << " steps per second, with "
+               << gillespie_rates.event_proportion << " events per step. Gillespie algorithm estimated at "
+               << gillespie_rates.estimated_event_rate << " events per second." << std::endl;
         }
-        while((endactive < gillespie_threshold) && (endactive > 1)
-              && ((steps < 100) || difftime(sim_end, start) < maxtime) && this_step.bContinueSim);
-        // Switch to gillespie
-        writeInfo("Switching to Gillespie algorithm.\n");
+        writeInfo(ss.str());
         setupGillespie();
 #ifdef DEBUG
         validateLineages();
@@ -1609,10 +1612,12 @@ namespace necsim
         unsigned long counter = 0;
 #endif // DEBUG
         writeInfo("Starting Gillespie event loop...");
-
+        unsigned long events = 0;
+        const auto gillespie_start_time = std::chrono::steady_clock::now();
         do
         {
             runGillespieLoop();
+            events++;
 #ifdef DEBUG
             counter++;
             // Only runs the full checks every 1000 time steps. Change for more frequent debugging.
@@ -1670,6 +1675,11 @@ namespace necsim
 #endif // DEBUG
         }
         while(endactive > 1);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - gillespie_start_time;
+        if(elapsed.count() > 0.0)
+        {
+            gillespie_rates.event_rate = static_cast<double>(events) / elapsed.count();
+        }
         return stopSimulation();
 
     }
@@ -1679,20 +1689,22 @@ namespace necsim
 
         writeStepToConsole();
         // Decide what event and execute
-        EventType next_event = heap.front().event_type;
+        const IndexedHeap::Entry next = heap.top();
+        EventType next_event = getEventType(next.index);
 #ifdef DEBUG
         last_event.first = next_event;
         last_event.second = CellEventType::undefined;
 #endif // DEBUG
         // Update the event timer
-        steps += (heap.front().time_of_event - generation) * double(endactive);
-        generation = heap.front().time_of_event;
+        steps += (next.time - generation) * double(endactive);
+        generation = next.time;
         // Estimate the number of steps that have occurred.
         switch(next_event)
         {
         case EventType::cell_event:
         {
-            GillespieProbability &origin = probabilities.get(heap.front().cell.y, heap.front().cell.x);
+            const Cell cell = getEventCell(next.index);
+            GillespieProbability &origin = probabilities.get(cell.y, cell.x);
             gillespieCellEvent(origin);
             break;
         }
@@ -1713,6 +1725,8 @@ namespace necsim
 
     void SpatialTree::setupGillespie()
     {
+        // Lineages are chosen by cell during the Gillespie algorithm, so the death weights are not kept up to date.
+        death_weights_outdated = true;
         setupGillespieLineages();
         setupGillespieMaps();
         findLocations();
@@ -1725,13 +1739,14 @@ namespace necsim
 
     void SpatialTree::setupGillespieLineages()
     {
+        waitForPeriodicCheckpoint();
         data->resize(endactive + data->size());
         for(unsigned long chosen = 1; chosen < endactive; chosen++)
         {
             // Ensures that lineages can't speciate
             enddata++;
-            TreeNode &end_tree_node = (*data)[enddata];
-            TreeNode &active_tree_node = (*data)[active[chosen].getReference()];
+            auto end_tree_node = (*data)[enddata];
+            auto active_tree_node = (*data)[active[chosen].getReference()];
             end_tree_node.setup(false,
                                 active[chosen].getXpos(),
                                 active[chosen].getYpos(),
@@ -1808,19 +1823,20 @@ namespace necsim
             next_map_update = sim_parameters->all_historical_map_parameters.front().generation;
             if(next_map_update > 0.0 && next_map_update < generation)
             {
-                heap.emplace_back(GillespieHeapNode(generation, EventType::map_event));
+                heap.pushUnordered(probabilities.getCols() * probabilities.getRows(), generation);
             }
         }
     }
 
     void SpatialTree::checkSampleEvents()
     {
-        for(const auto &item: reference_times)
+        const unsigned long first_sample_index = probabilities.getCols() * probabilities.getRows() + 1;
+        for(unsigned long i = 0; i < reference_times.size(); i++)
         {
             // Find the first time that's after this point in time.
-            if(item > generation)
+            if(reference_times[i] > generation)
             {
-                heap.emplace_back(GillespieHeapNode(generation, EventType::sample_event));
+                heap.pushUnordered(first_sample_index + i, generation);
             }
         }
     }
@@ -1865,7 +1881,11 @@ namespace necsim
             dispersal_coordinator.updateDispersalMap();
             // Update all the heap variables
             findLocations();
-            updateAllProbabilities();
+            // Only the cells which were changing before the update, or are changing after it, can have changed.
+            vector<Cell> changed_cells = changing_fine_cells;
+            changing_fine_cells = landscape->getChangingFineCells();
+            changed_cells.insert(changed_cells.end(), changing_fine_cells.begin(), changing_fine_cells.end());
+            updateCellDeathRates(changed_cells);
             createEventList();
 
             // Now need to get the next update map event.
@@ -1888,7 +1908,7 @@ namespace necsim
         clearGillespieObjects();
         addLineages(generation);
         findLocations();
-        updateAllProbabilities();
+        updateCellDeathRates(changing_fine_cells);
         createEventList();
         checkMapEvents();
         checkSampleEvents();
@@ -1913,7 +1933,6 @@ namespace necsim
         }
         if(origin.getMapLocation().isOnGrid())
         {
-            active[this_step.chosen].setNwrap(0);
             active[this_step.chosen].setListPosition(0);
         }
         debugCoalescence();
@@ -1950,7 +1969,7 @@ namespace necsim
         auto y = destination_cell.y;
         gillespieLocationRemainingCheck(origin);
         GillespieProbability &destination = probabilities.get(y, x);
-        if(cellToHeapPositions.get(y, x) == SpatialTree::UNUSED)
+        if(!heap.contains(getCellEventIndex(destination_cell)))
         {
             fullSetupGillespieProbability(destination, destination.getMapLocation());
             addNewEvent(x, y);
@@ -1968,8 +1987,7 @@ namespace necsim
                                                               summed_death_rate,
                                                               getNumberIndividualsAtLocation(destination.getMapLocation())))
                              + generation;
-            heap[cellToHeapPositions.get(y, x)].time_of_event = t;
-            updateInhabitedCellOnHeap(destination_cell);
+            heap.update(getCellEventIndex(destination_cell), t);
         }
 #ifdef DEBUG
         checkNoSpeciation(this_step.chosen);
@@ -1993,7 +2011,7 @@ namespace necsim
         speciateLineage(reference);
         removeOldPosition(chosen);
         switchPositions(chosen);
-        TreeNode &tmp_treenode = (*data)[reference];
+        auto tmp_treenode = (*data)[reference];
         tmp_treenode.setSpec(inverseSpeciation(spec, std::max(tmp_treenode.getGenerationRate(), (unsigned long) 1)));
 #ifdef DEBUG
         if(!checkSpeciation(tmp_treenode.getSpecRate(), spec, tmp_treenode.getGenerationRate()))
@@ -2017,11 +2035,10 @@ namespace necsim
         if(number_at_location > 0)
         {
             updateCellCoalescenceProbability(origin, number_at_location);
-            updateInhabitedCellOnHeap(convertMapLocationToCell(location));
         }
         else
         {
-            removeHeapTop();
+            heap.remove(getCellEventIndex(convertMapLocationToCell(location)));
         }
     }
 
@@ -2050,7 +2067,6 @@ namespace necsim
 
     void SpatialTree::clearGillespieObjects()
     {
-        cellToHeapPositions.fill(0);
         heap.clear();
         for(auto &item : probabilities)
         {
@@ -2082,7 +2098,7 @@ namespace necsim
             throw FatalException(ss.str());
         }
 #endif // DEBUG
-        TreeNode &tree_node = (*data)[active[lineage].getReference()];
+        auto tree_node = (*data)[active[lineage].getReference()];
         const double generations_passed = generation - tree_node.getGeneration();
         const auto generation_rate = static_cast<unsigned long>(round(std::max(
                 convertGlobalGenerationsToLocalGenerations(active[lineage], generations_passed)
@@ -2095,54 +2111,102 @@ namespace necsim
     {
         const MapLocation &location = origin.getMapLocation();
         setupGillespieProbability(origin, location);
-        heap.front().time_of_event =
-                (origin.calcTimeToNextEvent(getLocalDeathRate(location), summed_death_rate, n)) + generation;
-    }
-
-    void SpatialTree::updateInhabitedCellOnHeap(const Cell &pos)
-    {
-        eastl::change_heap(heap.begin(), (unsigned long) heap.size(), cellToHeapPositions.get(pos.y, pos.x));
+        heap.update(getCellEventIndex(convertMapLocationToCell(location)),
+                    (origin.calcTimeToNextEvent(getLocalDeathRate(location), summed_death_rate, n)) + generation);
     }
 
     void SpatialTree::updateAllProbabilities()
     {
         writeInfo("\tCalculating global mean death rate and total number of individuals...\n");
-
+        const unsigned long rows = landscape->getFineMap().getRows();
+        const unsigned long cols = landscape->getFineMap().getCols();
+        vector<double> individuals(rows * cols);
+        for(unsigned long y = 0; y < rows; y++)
+        {
+            for(unsigned long x = 0; x < cols; x++)
+            {
+                individuals[y * cols + x] = landscape->getValFine(x, y, generation);
+            }
+        }
+        fine_individuals.assign(rows, cols, individuals);
+        // Without a death map the death rates equal the number of individuals, so only one set of sums is kept.
         if(!death_map->isNull())
         {
-            summed_death_rate = 0.0;
-            for(unsigned long y = 0; y < sim_parameters->fine_map_y_size; y++)
+            vector<double> death_rates(rows * cols);
+            for(unsigned long y = 0; y < rows; y++)
             {
-                for(unsigned long x = 0; x < sim_parameters->fine_map_y_size; x++)
+                for(unsigned long x = 0; x < cols; x++)
                 {
-                    const auto local_individuals = landscape->getValFine(x, y, generation);
-                    summed_death_rate += death_map->get(y, x) * local_individuals;
-                    global_individuals += local_individuals;
+                    death_rates[y * cols + x] = death_map->get(y, x);
                 }
             }
+            for(unsigned long i = 0; i < death_rates.size(); i++)
+            {
+                death_rates[i] *= individuals[i];
+            }
+            fine_death_rates.assign(rows, cols, death_rates);
         }
         else
         {
-            // calculate global death rate mean if death rates are equal
-            summed_death_rate = std::accumulate(landscape->getFineMap().begin(),
-                                                landscape->getFineMap().end(),
-                                                (unsigned long) 0);
-            global_individuals = static_cast<unsigned long>(summed_death_rate);
+            fine_death_rates = TiledSums();
+        }
+        changing_fine_cells = landscape->getChangingFineCells();
+        setDeathRateTotals();
+    }
+
+    void SpatialTree::updateCellDeathRates(const vector<Cell> &cells)
+    {
+        for(const auto &cell : cells)
+        {
+            const auto local_individuals = static_cast<double>(landscape->getValFine(cell.x, cell.y, generation));
+            fine_individuals.set(cell.y, cell.x, local_individuals);
+            if(!death_map->isNull())
+            {
+                fine_death_rates.set(cell.y, cell.x, death_map->get(cell.y, cell.x) * local_individuals);
+            }
         }
+        setDeathRateTotals();
+    }
+
+    void SpatialTree::setDeathRateTotals()
+    {
+        global_individuals = static_cast<unsigned long>(std::llround(fine_individuals.total()));
+        summed_death_rate = death_map->isNull() ? fine_individuals.total() : fine_death_rates.total();
+    }
+
+    unsigned long SpatialTree::getCellEventIndex(const Cell &cell) const
+    {
+        return cell.y * probabilities.getCols() + cell.x;
     }
 
-    void SpatialTree::removeHeapTop()
+    Cell SpatialTree::getEventCell(const unsigned long &index) const
     {
-        eastl::pop_heap(heap.begin(), heap.end());
-        *(heap.back().locator) = SpatialTree::UNUSED;
-        heap.pop_back();
+        return Cell(index % probabilities.getCols(), index / probabilities.getCols());
+    }
+
+    EventType SpatialTree::getEventType(const unsigned long &index) const
+    {
+        const unsigned long cell_count = probabilities.getCols() * probabilities.getRows();
+        if(index < cell_count)
+        {
+            return EventType::cell_event;
+        }
+        if(index == cell_count)
+        {
+            return EventType::map_event;
+        }
+        if(index <= cell_count + reference_times.size())
+        {
+            return EventType::sample_event;
+        }
+        return EventType::undefined;
     }
 
     void SpatialTree::createEventList()
     {
         writeInfo("\tAdding events to event list...\n");
-        cellToHeapPositions.setSize(sim_parameters->fine_map_y_size, sim_parameters->fine_map_x_size);
-        cellToHeapPositions.fill(SpatialTree::UNUSED);
+        // Cell events are followed by the map event and an event for each reference time.
+        heap.setIndexCount(probabilities.getCols() * probabilities.getRows() + 1 + reference_times.size());
 
         for(unsigned long y = 0; y < sim_parameters->fine_map_y_size; y++)
         {
@@ -2155,7 +2219,7 @@ namespace necsim
 
     void SpatialTree::sortEvents()
     {
-        eastl::make_heap(heap.begin(), heap.end());
+        heap.heapify();
     }
 
     template<bool restoreHeap> void SpatialTree::addNewEvent(const unsigned long &x, const unsigned long &y)
@@ -2163,22 +2227,17 @@ namespace necsim
         const MapLocation &location = probabilities.get(y, x).getMapLocation();
         if(getNumberLineagesAtLocation(location) > 0)
         {
-            cellToHeapPositions.get(y, x) = heap.size();
-
-            heap.emplace_back(GillespieHeapNode(Cell(x, y),
-                                                ((probabilities.get(y,
-                                                                    x).calcTimeToNextEvent(getLocalDeathRate(location),
-                                                                                           summed_death_rate,
-                                                                                           getNumberIndividualsAtLocation(
-                                                                                                   location)))
-                                                 + generation),
-                                                EventType::cell_event,
-                                                &heap,
-                                                &cellToHeapPositions.get(y, x)));
-
+            const double time = probabilities.get(y, x).calcTimeToNextEvent(getLocalDeathRate(location),
+                                                                             summed_death_rate,
+                                                                             getNumberIndividualsAtLocation(location))
+                                + generation;
             if(restoreHeap)
             {
-                eastl::push_heap(heap.begin(), heap.end());
+                heap.push(getCellEventIndex(Cell(x, y)), time);
+            }
+            else
+            {
+                heap.pushUnordered(getCellEventIndex(Cell(x, y)), time);
             }
         }
     }
@@ -2286,27 +2345,7 @@ namespace necsim
         }
         else
         {
-            lineage_ids.reserve(species_list.getNwrap());
-            unsigned long next = species_list.getNext();
-            do
-            {
-                const DataPoint &datapoint = active[next];
-                if(datapoint == location)
-                {
-                    lineage_ids.push_back(next);
-                }
-                next = active[next].getNext();
-            }
-            while(next != 0);
-#ifdef DEBUG
-            if(lineage_ids.size() != species_list.getNwrap())
-            {
-                std::stringstream ss;
-                ss << "Nwrap does not match length of detected lineages in " << location.x << ", " << location.y
-                   << std::endl;
-                throw FatalException(ss.str());
-            }
-#endif // DEBUG
+            lineage_ids = wrapped_lineages.getLineages(location);
         }
 #ifdef DEBUG
         for(const auto &item: lineage_ids)
@@ -2326,7 +2365,7 @@ namespace necsim
 
     void SpatialTree::assignNonSpeciationProbability(const unsigned long chosen)
     {
-        TreeNode &tree_node = (*data)[active[chosen].getReference()];
+        auto tree_node = (*data)[active[chosen].getReference()];
         if(tree_node.getGenerationRate() == 0)
         {
             tree_node.setGenerationRate(1);
@@ -2356,17 +2395,9 @@ namespace necsim
     {
         writeInfo("Validating heap...\n");
 
-        if(!eastl::is_heap(heap.begin(), heap.end()))
+        if(!heap.isValid())
         {
-            throw FatalException("Heap is not sorted!\n");
-        }
-
-        for(size_t i = 0; i < heap.size(); i++)
-        {
-            if(*(heap[i].locator) != i)
-            {
-                throw FatalException("Heap locator is broken!\n");
-            }
+            throw FatalException("Heap is not sorted or heap positions are broken!\n");
         }
     }
 
@@ -2427,35 +2458,31 @@ namespace necsim
                             }
                         }
                     }
-                    unsigned long nwrap = species_list.getNwrap();
-                    unsigned long next = species_list.getNext();
-                    unsigned long nw = 0;
-                    while(next != 0)
-                    {
-                        nw++;
-                        if(next > endactive)
-                        {
-                            std::stringstream ss;
-                            ss << "Index at " << next << " is out of range of endactive " << endactive << std::endl;
-                            throw std::out_of_range (ss.str());
-                        }
-                        if(active[next].getNwrap() != nw)
-                        {
-                            std::stringstream ss;
-                            ss << "Index at " << next << " has incorrect nwrap: " << active[next].getNwrap() << " != "
-                               << nw << std::endl;
-                            throw std::out_of_range (ss.str());
-                        }
-                        next = active[next].getNext();
-                    }
-                    if(nw != nwrap)
+                }
+            }
+            unsigned long wrapped_count = 0;
+            for(unsigned long i = 1; i <= endactive; i++)
+            {
+                if(!active[i].isOnGrid())
+                {
+                    wrapped_count++;
+                    if(active[i].getListpos() >= wrapped_lineages.count(active[i])
+                       || wrapped_lineages.get(active[i], active[i].getListpos()) != i)
                     {
                         std::stringstream ss;
-                        ss << "Nwrap set incorrectly: " << nw << " != " << nwrap << std::endl;
+                        ss << "Wrapped lineage " << i << " is not at position " << active[i].getListpos()
+                           << " of its location." << std::endl;
                         throw std::out_of_range (ss.str());
                     }
                 }
             }
+            if(wrapped_count != wrapped_lineages.size())
+            {
+                std::stringstream ss;
+                ss << "Number of wrapped lineages set incorrectly: " << wrapped_count << " != "
+                   << wrapped_lineages.size() << std::endl;
+                throw std::out_of_range (ss.str());
+            }
         }
         catch(std::out_of_range &oor)
         {
@@ -2501,57 +2528,27 @@ namespace necsim
                 fail = true;
             }
 #endif // historical mode
-            if(tmp_datapoint.getXwrap() == 0 && tmp_datapoint.getYwrap() == 0)
+            if(tmp_datapoint.isOnGrid())
             {
-                if(tmp_datapoint.getNwrap() != 0)
+                if(i != grid.get(tmp_datapoint.getYpos(),
+                                 tmp_datapoint.getXpos()).getLineageIndex(tmp_datapoint.getListpos()))
                 {
                     fail = true;
                 }
-                else
-                {
-                    if(i != grid.get(tmp_datapoint.getYpos(),
-                                     tmp_datapoint.getXpos()).getLineageIndex(tmp_datapoint.getListpos()))
-                    {
-                        fail = true;
-                    }
-                }
             }
             else
             {
-                if(tmp_datapoint.getNwrap() == 0)
+                if(tmp_datapoint.getListpos() >= wrapped_lineages.count(tmp_datapoint)
+                   || i != wrapped_lineages.get(tmp_datapoint, tmp_datapoint.getListpos()))
                 {
                     fail = true;
                 }
-                else
-                {
-                    unsigned long tmp_next = grid.get(tmp_datapoint.getYpos(), tmp_datapoint.getXpos()).getNext();
-                    unsigned long count = 0;
-                    while(tmp_next != 0)
-                    {
-                        count++;
-                        if(count != active[tmp_next].getNwrap())
-                        {
-                            ss << "problem in wrap: " << count << " != " << active[tmp_next].getNwrap() << std::endl;
-                            fail = true;
-                        }
-                        tmp_next = active[tmp_next].getNext();
-                    }
-                    if(count == 0 && count != grid.get(tmp_datapoint.getYpos(), tmp_datapoint.getXpos()).getNwrap())
-                    {
-                        fail = true;
-                    }
-                    if(count != grid.get(tmp_datapoint.getYpos(), tmp_datapoint.getXpos()).getNwrap())
-                    {
-                        fail = true;
-                    }
-                }
             }
             if(fail)
             {
                 std::stringstream ss;
                 ss << "Active reference: " << i << std::endl;
-                ss << "Grid wrapping: " << grid.get(tmp_datapoint.getYpos(), tmp_datapoint.getXpos()).getNwrap()
-                   << std::endl;
+                ss << "Wrapped lineages at location: " << wrapped_lineages.count(tmp_datapoint) << std::endl;
                 ss << "Expected lineage at index: " << i << std::endl;
                 ss << "Lineage at index: "
                    << grid.get(tmp_datapoint.getYpos(), tmp_datapoint.getXpos()).getLineageIndex(i) << std::endl;
@@ -2570,42 +2567,18 @@ namespace necsim
         validateCoalescenceTree();
     }
 
-    void SpatialTree::debugAddingLineage(unsigned long numstart, long x, long y)
+    void SpatialTree::debugAddingLineage(const unsigned long &numstart)
     {
-        unsigned long tmp_next = grid.get(y, x).getNext();
-        unsigned long tmp_nwrap = 0;
-        while(tmp_next != 0)
-        {
-            tmp_nwrap++;
-            if(active[tmp_next].getNwrap() != tmp_nwrap)
-            {
-                std::stringstream ss;
-                ss << "tmp_nwrap: " << tmp_nwrap << std::endl;
-                ss << "next = " << tmp_next << std::endl;
-                ss << "numstart: " << numstart << std::endl;
-                writeLog(50, ss);
-                active[tmp_nwrap].logActive(50);
-                throw FatalException("Incorrect setting of nwrap in wrapped lineage, please report this bug.");
-            }
-            tmp_next = active[tmp_next].getNext();
-        }
-        if(tmp_nwrap != grid.get(y, x).getNwrap())
+        const DataPoint &datapoint = active[numstart];
+        if(datapoint.getListpos() >= wrapped_lineages.count(datapoint)
+           || wrapped_lineages.get(datapoint, datapoint.getListpos()) != numstart)
         {
             std::stringstream ss;
-            ss << "Grid nwrap: " << grid.get(y, x).getNwrap() << std::endl;
-            ss << "Counted wrapping: " << tmp_nwrap << std::endl;
+            ss << "Wrapped lineages at location: " << wrapped_lineages.count(datapoint) << std::endl;
+            ss << "List position: " << datapoint.getListpos() << std::endl;
             ss << "active: " << numstart << std::endl;
-            tmp_next = grid.get(y, x).getNext();
-            tmp_nwrap = 0;
-            while(tmp_next != 0 && tmp_nwrap < grid.get(y, x).getNwrap())
-            {
-                tmp_nwrap++;
-                ss << "tmp_next: " << tmp_next << std::endl;
-                ss << "tmp_nwrap: " << tmp_nwrap << std::endl;
-                tmp_next = active[tmp_next].getNext();
-            }
             writeLog(50, ss);
-            throw FatalException("Grid wrapping value not set correctly");
+            throw FatalException("Wrapped lineage not added correctly, please report this bug.");
         }
     }
 
@@ -2614,86 +2587,28 @@ namespace necsim
         // final checks
 #ifdef historical_mode
         if(active[chosen].getListpos() > grid.get(active, chosen).getYpos()][active[chosen].getXpos()].getMaxsize() &&
-           active[chosen].getNwrap() == 0)
+           active[chosen].isOnGrid())
         {
             throw FatalException("ERROR_MOVE_001: Listpos outside maxsize.");
         }
 
         if(active[coalchosen].getListpos() >
                grid.get(active, coalchosen).getYpos()][active[coalchosen].getXpos()].getMaxsize() &&
-           active[coalchosen].getNwrap() == 0 && coalchosen != 0)
+           active[coalchosen].isOnGrid() && coalchosen != 0)
         {
             throw FatalException("Coalchosen list_position outside maxsize. Please report this bug.");
         }
 #endif
         Tree::runChecks(chosen, coalchosen);
-        if(active[chosen].getNwrap() != 0)
+        for(const auto &lineage : {chosen, endactive})
         {
-            unsigned long tmpactive = grid.get(active[chosen].getYpos(), active[chosen].getXpos()).getNext();
-            for(unsigned long i = 1; i < active[chosen].getNwrap(); i++)
+            if(lineage != 0 && lineage <= endactive && !active[lineage].isOnGrid())
             {
-                tmpactive = active[tmpactive].getNext();
-            }
-
-            if(tmpactive != chosen)
-            {
-                active[chosen].logActive(50);
-                throw FatalException("ERROR_MOVE_003: Nwrap not set correctly.");
-            }
-        }
-
-        if(active[chosen].getNwrap() != 0)
-        {
-            if(active[chosen].getXwrap() == 0 && active[chosen].getYwrap() == 0)
-            {
-                throw FatalException("ERROR_MOVE_10: Nwrap set to non-zero, but x and y wrap 0.");
-            }
-        }
-        if(active[endactive].getNwrap() != 0)
-        {
-            unsigned long nwrap = active[endactive].getNwrap();
-            if(nwrap == 1)
-            {
-                if(grid.get(active[endactive].getYpos(), active[endactive].getXpos()).getNext() != endactive)
-                {
-                    std::stringstream ss;
-                    ss << "Lineage at 1st position: "
-                       << grid.get(active[endactive].getYpos(), active[endactive].getXpos()).getNext() << std::endl;
-                    ss << "endactive: " << endactive << std::endl << "nwrap: " << nwrap << std::endl;
-                    ss << "chosen: " << chosen << std::endl;
-                    writeLog(10, ss);
-                    throw FatalException("ERROR_MOVE_016: Nwrap for endactive not set correctly. Nwrap is 1, "
-                                         "but the lineage at 1st position is not endactive.");
-                }
-            }
-            else
-            {
-                unsigned long tmpcheck = grid.get(active[endactive].getYpos(), active[endactive].getXpos()).getNext();
-                unsigned long tmpnwrap = 1;
-                while(tmpcheck != endactive)
-                {
-                    tmpnwrap++;
-                    tmpcheck = active[tmpcheck].getNext();
-                    if(tmpnwrap > nwrap + 1)
-                    {
-                        std::stringstream ss;
-                        ss << "ERROR_MOVE_017: NON FATAL. Nrap for endactive not set correctly; looped "
-                              "beyond nwrap and not yet found enactive." << std::endl;
-                        ss << "endactive: " << endactive << std::endl << "nwrap: " << nwrap << std::endl << "x,y: "
-                           << active[endactive].getXpos() << "," << active[endactive].getYpos() << std::endl;
-                        ss << "chosen: " << chosen << std::endl;
-                        writeLog(10, ss);
-                    }
-                }
-                if(tmpnwrap != nwrap)
+                if(active[lineage].getListpos() >= wrapped_lineages.count(active[lineage])
+                   || wrapped_lineages.get(active[lineage], active[lineage].getListpos()) != lineage)
                 {
-                    std::stringstream ss;
-                    ss << "ERROR_MOVE_018: NON FATAL. Nwrap for endactive not set correctly. Nwrap is " << nwrap
-                       << " but endactive is at position " << tmpnwrap << std::endl;
-                    ss << "endactive: " << endactive << std::endl << "nwrap: " << nwrap << std::endl << "x,y: "
-                       << active[endactive].getXpos() << "," << active[endactive].getYpos() << std::endl;
-                    ss << "chosen: " << chosen << std::endl;
-                    writeLog(10, ss);
+                    active[lineage].logActive(50);
+                    throw FatalException("ERROR_MOVE_003: Wrapped lineage position not set correctly.");
                 }
             }
         }
@@ -2731,16 +2646,23 @@ namespace necsim
 //                }
             }
         }
-        for(const auto &item : heap)
+        for(unsigned long i = 0; i < heap.size(); i++)
         {
-            const auto &gp = probabilities.get(item.cell.y, item.cell.x);
-            if(item.event_type != EventType::undefined)
+            const auto &item = heap[i];
+            const EventType event_type = getEventType(item.index);
+            if(event_type == EventType::map_event || event_type == EventType::sample_event)
+            {
+                continue;
+            }
+            const Cell cell = getEventCell(item.index);
+            const auto &gp = probabilities.get(cell.y, cell.x);
+            if(event_type != EventType::undefined)
             {
                 const auto location = gp.getMapLocation();
                 if(gp.getInCellProbability() == 0.0)
                 {
                     std::stringstream ss;
-                    ss << "Heap at " << item.cell.x << ", " << item.cell.y << " has cell with 0 in-cell probability: "
+                    ss << "Heap at " << cell.x << ", " << cell.y << " has cell with 0 in-cell probability: "
                        << gp.getInCellProbability() << std::endl;
                     ss << "Probabilities: " << gp << std::endl;
                     ss << "Individuals (lineages) at location (" << location.x << ", " << location.y << "): "
@@ -2752,10 +2674,10 @@ namespace necsim
                     ss << "\tDispersal: " << 1.0 - getLocalSelfDispersalRate(location) << std::endl;
                     throw FatalException(ss.str());
                 }
-                if(item.time_of_event < generation)
+                if(item.time < generation)
                 {
                     std::stringstream ss;
-                    ss << "Heap has event with time lower than current generation counter: " << item.time_of_event
+                    ss << "Heap has event with time lower than current generation counter: " << item.time
                        << " < " << generation << std::endl;
                     ss << "Individuals (lineages) at location (" << location.x << ", " << location.y << "): "
                        << getNumberIndividualsAtLocation(gp.getMapLocation()) << " ("
@@ -2801,7 +2723,7 @@ namespace necsim
         unsigned long counted_speciation_events = 0;
         for(unsigned long i = 0; i <= enddata; i++)
         {
-            const TreeNode &this_node = (*data)[i];
+            const auto this_node = (*data)[i];
             if(checkSpeciation(this_node.getSpecRate(), spec, this_node.getGenerationRate()))
             {
                 counted_speciation_events++;
@@ -2812,7 +2734,7 @@ namespace necsim
 
     void SpatialTree::checkNoSpeciation(const unsigned long &chosen) const
     {
-        TreeNode &active_tree_node = (*data)[active[chosen].getReference()];
+        auto active_tree_node = (*data)[active[chosen].getReference()];
         if(checkSpeciation(active_tree_node.getSpecRate(), spec, active_tree_node.getGenerationRate()))
         {
             std::stringstream ss;
@@ -81,6 +81,10 @@
 #include "ActivityMap.h"
 #include "Logging.h"
 #include "GillespieCalculator.h"
+#include "FenwickTree.h"
+#include "WrappedLineages.h"
+#include "IndexedHeap.h"
+#include "TiledSums.h"
 
 
 
@@ -101,6 +105,10 @@ namespace necsim
         shared_ptr<ActivityMap> death_map;
         // Reproduction probability values across the landscape
         shared_ptr<ActivityMap> reproduction_map;
+        // The death probability of each active lineage, for choosing lineages weighted by the death map
+        FenwickTree death_weights;
+        // True if the death weights need regenerating before choosing a lineage
+        bool death_weights_outdated;
         // A lineage_indices of new variables which will contain the relevant information for maps and grids.
         //  strings containing the file names to be imported.
         string fine_map_input, coarse_map_input;
@@ -110,18 +118,19 @@ namespace necsim
         shared_ptr<Landscape> landscape;
         // An indexing spatial positioning of the lineages
         Matrix<SpeciesList> grid;
+        // The lineages at each location outside the grid
+        WrappedLineages wrapped_lineages;
         unsigned long desired_specnum{};
         // contains the DataMask for where we should start lineages from.
         DataMask samplegrid;
 
         // The gillespie variables
-        double gillespie_threshold{};
+        // The number of steps since the last measurement which would have been Gillespie events.
+        unsigned long gillespie_step_events{};
         // Matrix of all the probabilities at every location in the map.
         Matrix<GillespieProbability> probabilities;
-        // Vector used for holding the priority queue as a binary heap
-        vector<GillespieHeapNode> heap;
-        // Index to heap position, or UNUSED if cell is not used.
-        Matrix<unsigned long> cellToHeapPositions;
+        // The time of the next event in each inhabited cell, followed by the map and sample events.
+        IndexedHeap heap;
         // matrix of self-dispersal probabilities;
         Matrix<double> self_dispersal_probabilities;
 
@@ -129,9 +138,13 @@ namespace necsim
         unsigned long global_individuals{};
         // Mean death rate across the simulated world
         double summed_death_rate{};
-
-        // Defines a cell that is unused
-        static const unsigned long UNUSED = static_cast<unsigned long>(-1);
+        // The number of individuals in each cell of the fine map (8 bytes per cell)
+        TiledSums fine_individuals;
+        // The number of individuals in each cell of the fine map, weighted by the death rate. Only used with a death
+        // map, in which case it adds another 8 bytes per cell.
+        TiledSums fine_death_rates;
+        // The cells of the fine map whose number of individuals was changing when the totals were last updated
+        vector<Cell> changing_fine_cells;
 #ifdef DEBUG
         unsigned long gillespie_speciation_events{0};
         std::pair<EventType, CellEventType> last_event{};
@@ -141,14 +154,16 @@ namespace necsim
          * @brief The constructor for SpatialTree.
          */
         SpatialTree() : Tree(), dispersal_coordinator(), death_map(make_shared<ActivityMap>()),
-                        reproduction_map(make_shared<ActivityMap>()), fine_map_input("none"), coarse_map_input("none"),
+                        reproduction_map(make_shared<ActivityMap>()), death_weights(), death_weights_outdated(true),
+                        fine_map_input("none"), coarse_map_input("none"),
                         historical_fine_map_input("none"), historical_coarse_map_input("none"),
-                        landscape(make_shared<Landscape>()), grid(), desired_specnum(1), samplegrid(),
-                        gillespie_threshold(0.0), probabilities(), heap(), cellToHeapPositions(),
+                        landscape(make_shared<Landscape>()), grid(), wrapped_lineages(), desired_specnum(1),
+                        samplegrid(), gillespie_step_events(0), probabilities(), heap(),
 #ifdef DEBUG
                         gillespie_speciation_events(0), last_event(),
 #endif // DEBUG
-                        self_dispersal_probabilities(), global_individuals(0), summed_death_rate(1.0)
+                        self_dispersal_probabilities(), global_individuals(0), summed_death_rate(1.0),
+                        fine_individuals(), fine_death_rates(), changing_fine_cells()
         {
         }
 
@@ -181,6 +196,8 @@ namespace necsim
                 other.dispersal_coordinator.swap(dispersal_coordinator);
                 std::swap(death_map, other.death_map);
                 std::swap(reproduction_map, other.reproduction_map);
+                std::swap(death_weights, other.death_weights);
+                std::swap(death_weights_outdated, other.death_weights_outdated);
                 std::swap(fine_map_input, other.fine_map_input);
                 std::swap(coarse_map_input, other.coarse_map_input);
                 std::swap(historical_fine_map_input, other.historical_fine_map_input);
@@ -188,14 +205,17 @@ namespace necsim
                 std::swap(landscape, other.landscape);
                 std::swap(samplegrid, other.samplegrid);
                 std::swap(grid, other.grid);
+                std::swap(wrapped_lineages, other.wrapped_lineages);
                 std::swap(desired_specnum, other.desired_specnum);
-                std::swap(gillespie_threshold, other.gillespie_threshold);
+                std::swap(gillespie_step_events, other.gillespie_step_events);
                 std::swap(probabilities, other.probabilities);
                 std::swap(heap, other.heap);
-                std::swap(cellToHeapPositions, other.cellToHeapPositions);
                 std::swap(self_dispersal_probabilities, other.self_dispersal_probabilities);
                 std::swap(global_individuals, other.global_individuals);
                 std::swap(summed_death_rate, other.summed_death_rate);
+                std::swap(fine_individuals, other.fine_individuals);
+                std::swap(fine_death_rates, other.fine_death_rates);
+                std::swap(changing_fine_cells, other.changing_fine_cells);
 
             }
         }
@@ -290,9 +310,9 @@ namespace necsim
         unsigned long getNumberIndividualsAtLocation(const MapLocation &location) const;
 
         /**
-         * @brief Removes the old position within active by checking any wrapping and removing connections.
+         * @brief Removes the old position within active from the grid, or from the wrapped lineages if outside the grid.
          *
-         * The function also corrects the linked list to identify the correct nwrap for every wrapped lineage in that space.
+         * The function also corrects the list position of the lineage moved into the removed lineage's place.
          *
          * @param chosen the desired active reference to remove from the grid.
          */
@@ -326,9 +346,11 @@ namespace necsim
 
         /**
          * @brief Calculates the coalescence event when the target cell is wrapped.
-         * @param nwrap the number of wrapped lineages
+         *
+         * The lineages at the exact wrapped location are looked up directly, and the lineage is added to them if no
+         * coalescence occurs.
          */
-        void calcWrappedCoalescence(const unsigned long &nwrap);
+        void calcWrappedCoalescence();
 
         /**
          * @brief Switches the chosen position with the endactive position.
@@ -365,6 +387,31 @@ namespace necsim
          */
         void incrementGeneration() final;
 
+        /**
+         * @brief Chooses a random lineage from active, weighted by the death probability at the lineage's location.
+         *
+         * If there is no death map, all lineages are equally likely to be chosen.
+         */
+        void chooseRandomLineage() final;
+
+        /**
+         * @brief Gets the death probability at the location of the active lineage.
+         * @param lineage the index of the lineage in active
+         * @return the death probability
+         */
+        double getLineageDeathWeight(const unsigned long &lineage);
+
+        /**
+         * @brief Generates the death weights for all active lineages.
+         */
+        void generateDeathWeights();
+
+        /**
+         * @brief Updates the death weight for an active lineage after it has moved.
+         * @param lineage the index of the lineage in active
+         */
+        void updateDeathWeight(const unsigned long &lineage);
+
         /**
          * @brief Updates the coalescence variables in the step object.
          */
@@ -409,6 +456,24 @@ namespace necsim
          */
         void dumpGrid(shared_ptr<std::ofstream> out);
 
+        /**
+         * @brief Saves the map object to the checkpoint.
+         * @param out the checkpoint sink to save the object to
+         */
+        void dumpMap(CheckpointSink &out);
+
+        /**
+         * @brief Saves the grid object to the checkpoint.
+         * @param out the checkpoint sink to save the object to
+         */
+        void dumpGrid(CheckpointSink &out);
+
+        /**
+         * @brief Saves all simulation objects, including the map and grid, to the checkpoint.
+         * @param out the checkpoint sink to save the objects to
+         */
+        void dumpCheckpoint(CheckpointSink &out) override;
+
         /**
          * @brief Resumes the simulation from a previous state.
          *
@@ -423,6 +488,18 @@ namespace necsim
          */
         void loadGridSave(shared_ptr<std::ifstream> in1);
 
+        /**
+         * @brief Loads the grid from the checkpoint into memory.
+         *
+         * @note Requires that both the simulation parameters and the maps have already been loaded.
+         */
+        void loadGridSave(const CheckpointReader &in1);
+
+        /**
+         * @brief Fills the grid with the lineages from the active object.
+         */
+        void fillGridFromActive();
+
         /**
          * @brief Loads the map from the save file into memory.
          *
@@ -430,18 +507,30 @@ namespace necsim
          */
         void loadMapSave(shared_ptr<std::ifstream> in1);
 
+        /**
+         * @brief Loads the map from the input stream into memory.
+         *
+         * @note Requires that the simulation parameters have already been loaded.
+         */
+        void loadMapSave(std::istream &in1);
+
+        /**
+         * @brief Loads the map from the checkpoint into memory.
+         *
+         * @note Requires that the simulation parameters have already been loaded.
+         */
+        void loadMapSave(const CheckpointReader &in1);
+
         /**
          * @brief Checks that the reproduction map makes sense with the fine density map.
          */
         void verifyActivityMaps();
 
         /**
-         * @brief Adds the lineage to the correct point in the linked list of active lineages
+         * @brief Adds the lineage to the wrapped lineages at its location, setting its list position.
          * @param numstart the active position to add
-         * @param x the x position of the lineage
-         * @param y the y position of the lineage
          */
-        void addWrappedLineage(unsigned long numstart, long x, long y);
+        void addWrappedLineage(const unsigned long &numstart);
 
         /**
          * @brief Counts the number of lineages at a particular location that need to be added, after making the correct
@@ -485,8 +574,33 @@ namespace necsim
 
         void addGillespie(const double &g_threshold) final;
 
+        void addAutomaticGillespie() final;
+
         bool runSimulationGillespie() final;
 
+        /**
+         * @brief Runs the per-step algorithm until the number of lineages falls below the Gillespie threshold, or
+         * until the Gillespie algorithm is expected to be faster if the switch is automatic.
+         */
+        void runSimulationBeforeGillespie();
+
+        /**
+         * @brief Estimates the number of events per second the Gillespie algorithm would run at from the current
+         * state.
+         *
+         * The time for a step of the per-step algorithm is measured as the simulation runs. A Gillespie event does the
+         * same work, plus an update of the event heap and the event times of two cells, which is timed here on a
+         * scratch heap without modifying the simulation.
+         * @return the estimated events per second, or zero if the per-step algorithm has not yet been measured
+         */
+        double estimateGillespieEventRate() const;
+
+        /**
+         * @brief Checks if the per-step algorithm should continue to run before switching to the Gillespie algorithm.
+         * @return true if the simulation is incomplete and has time remaining
+         */
+        bool continueBeforeGillespie() const;
+
         void runGillespieLoop();
 
         /**
@@ -588,11 +702,46 @@ namespace necsim
 
         void updateCellCoalescenceProbability(GillespieProbability &origin, const unsigned long &n);
 
-        void updateInhabitedCellOnHeap(const Cell &pos);
-
+        /**
+         * @brief Calculates the number of individuals and the death rate in every cell of the fine map, and the totals
+         * across the map.
+         */
         void updateAllProbabilities();
 
-        void removeHeapTop();
+        /**
+         * @brief Updates the number of individuals and the death rate in the cells of the fine map, and the totals
+         * across the map, at the current generation.
+         * @param cells the cells to update
+         */
+        void updateCellDeathRates(const vector<Cell> &cells);
+
+        /**
+         * @brief Sets global_individuals and summed_death_rate from the totals across the fine map.
+         */
+        void setDeathRateTotals();
+
+        /**
+         * @brief Gets the index of the event for the cell in the heap.
+         * @param cell the cell on the fine map
+         * @return the index of the event
+         */
+        unsigned long getCellEventIndex(const Cell &cell) const;
+
+        /**
+         * @brief Gets the cell for the event index in the heap.
+         * @param index the index of a cell event
+         * @return the cell on the fine map
+         */
+        Cell getEventCell(const unsigned long &index) const;
+
+        /**
+         * @brief Gets the type of the event for the index in the heap.
+         *
+         * Cell events are indexed first, followed by a single map event and one sample event for each reference time.
+         * @param index the index of the event
+         * @return the type of event
+         */
+        EventType getEventType(const unsigned long &index) const;
 
         template<typename T> Cell convertMapLocationToCell(const T &location) const
         {
@@ -671,10 +820,8 @@ namespace necsim
          * This function is only relevant in debug mode.
          *
          * @param numstart the active lineage to check for
-         * @param x the x coordinate
-         * @param y the y coordinate
          */
-        void debugAddingLineage(unsigned long numstart, long x, long y);
+        void debugAddingLineage(const unsigned long &numstart);
 
         /**
          * @brief Run checks at the end of each cycle which make certain the move has been successful.
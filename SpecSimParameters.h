@@ -15,13 +15,16 @@
 #ifndef SPECIATIONCOUNTER_SPECSIMPARAMETERS_H
 #define SPECIATIONCOUNTER_SPECSIMPARAMETERS_H
 
+#include <algorithm>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #include "ConfigParser.h"
 #include "custom_exceptions.h"
 #include "double_comparison.h"
 #include "parameters.h"
+#include "SQLiteHandler.h"
 
 namespace necsim
 {
@@ -44,16 +47,27 @@ namespace necsim
         string fragment_config_file;
         vector<ProtractedSpeciationParameters> protracted_parameters;
         MetacommunitiesArray metacommunity_parameters;
+        // The number of threads to use for calculating communities, with 1 calculating each community in turn.
+        unsigned long num_threads;
+        // The pragmas used when writing directly to the output database, rather than via an in-memory copy.
+        SQLitePragmas sqlite_pragmas;
+        // If true, species locations are written to a columnar table file alongside the output database, instead of to
+        // the SPECIES_LOCATIONS table.
+        bool use_columnar_spatial;
 
         SpecSimParameters() : use_spatial(false), record_ages(false), bMultiRun(false), use_fragments(false),
                               filename("none"), all_speciation_rates(), samplemask("none"), times_file("null"),
                               all_times(), fragment_config_file("none"), protracted_parameters(),
-                              metacommunity_parameters()
+                              metacommunity_parameters(), num_threads(1), sqlite_pragmas(),
+                              use_columnar_spatial(false)
         {
 
         }
 
-        SpecSimParameters(const string &fragment_config_file) : fragment_config_file(fragment_config_file)
+        SpecSimParameters(const string &fragment_config_file) : fragment_config_file(fragment_config_file),
+                                                                num_threads(1),
+                                                                sqlite_pragmas(),
+                                                                use_columnar_spatial(false)
         { }
 
         /**
@@ -212,6 +226,9 @@ namespace necsim
             fragment_config_file = "";
             protracted_parameters.clear();
             metacommunity_parameters.clear();
+            num_threads = 1;
+            sqlite_pragmas = SQLitePragmas();
+            use_columnar_spatial = false;
         }
 
         /**
@@ -235,6 +252,35 @@ namespace necsim
             }
         }
 
+        /**
+         * @brief Sets the number of threads to use for calculating communities.
+         * @param num_threads_in the number of threads, or 0 to use all available cores
+         */
+        void setNumberOfThreads(const unsigned long &num_threads_in)
+        {
+            num_threads = num_threads_in == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : num_threads_in;
+        }
+
+        /**
+         * @brief Sets the pragmas to use when writing directly to the output database.
+         * @param journal_mode the SQLite journal mode, or an empty string to use the SQLite default
+         * @param synchronous the SQLite synchronous level, or an empty string to use the SQLite default
+         * @param page_size the page size for new databases, or 0 to use the SQLite default
+         */
+        void setSQLitePragmas(const string &journal_mode, const string &synchronous, const unsigned long &page_size)
+        {
+            sqlite_pragmas = SQLitePragmas(journal_mode, synchronous, page_size);
+        }
+
+        /**
+         * @brief Sets whether species locations are written to a columnar table file instead of the output database.
+         * @param use_columnar whether to use the columnar table file
+         */
+        void setColumnarSpatialOutput(const bool &use_columnar)
+        {
+            use_columnar_spatial = use_columnar;
+        }
+
         /**
          * @brief Adds a set of protracted speciation parameters to the protracted parameters vector
          * @param proc_spec_min the minimum protracted speciation generation
@@ -12,7 +12,7 @@
 
 namespace necsim
 {
-    SpeciesList::SpeciesList() : list_size(0), max_size(0), next_active(0), lineage_indices(), nwrap(0)
+    SpeciesList::SpeciesList() : list_size(0), max_size(0), lineage_indices()
     {
     }
 
@@ -20,9 +20,7 @@ namespace necsim
     {
         list_size = other.list_size;
         max_size = other.max_size;
-        next_active = other.next_active;
         lineage_indices = other.lineage_indices;
-        nwrap = other.nwrap;
         return *this;
     }
 
@@ -30,7 +28,6 @@ namespace necsim
     {
         list_size = other.list_size;
         max_size = other.max_size;
-        next_active = other.next_active;
         if(other.lineage_indices.empty())
         {
             lineage_indices.clear();
@@ -39,14 +36,12 @@ namespace necsim
         {
             lineage_indices = std::move(other.lineage_indices);
         }
-        nwrap = other.nwrap;
         return *this;
     }
 
     void SpeciesList::initialise(unsigned long maxsizein)
     {
         max_size = maxsizein;
-        nwrap = 0;
         list_size = 0;
     }
 
@@ -85,16 +80,6 @@ namespace necsim
         list_size++;
     }
 
-    void SpeciesList::setNext(unsigned long n)
-    {
-        next_active = n;
-    }
-
-    void SpeciesList::setNwrap(unsigned long nr)
-    {
-        nwrap = nr;
-    }
-
     unsigned long SpeciesList::addSpecies(const unsigned long &new_spec)
     {
 #ifdef DEBUG
@@ -107,61 +92,59 @@ namespace necsim
             throw std::out_of_range ("Could not add species - lineage_indices size greater than max size.");
         }
 #endif
-        // Check if there are empty spaces
+        // All positions after list_size are empty
         if(lineage_indices.size() > list_size)
         {
-            // First loop from the lineage_indices size value
-            for(unsigned long i = list_size; i < lineage_indices.size(); i++)
-            {
-                if(lineage_indices[i] == 0)
-                {
-                    list_size++;
-                    lineage_indices[i] = new_spec;
-                    return i;
-                }
-            }
-            // Now loop over the rest of the lineages
-            for(unsigned long i = 0; i < list_size; i++)
-            {
-                if(lineage_indices[i] == 0)
-                {
-                    list_size++;
-                    lineage_indices[i] = new_spec;
-                    return i;
-                }
-            }
+            lineage_indices[list_size] = new_spec;
         }
         else
         {
-            // Just need to append to the vector
             lineage_indices.push_back(new_spec);
-            list_size++;
-            return lineage_indices.size() - 1;
         }
-
-        throw std::out_of_range("Could not add species - no empty space");
+        return list_size++;
     }
 
-    void SpeciesList::deleteSpecies(unsigned long index)
+    unsigned long SpeciesList::deleteSpecies(unsigned long index)
     {
-        lineage_indices[index] = 0;
+#ifdef DEBUG
+        if(index >= list_size || lineage_indices[index] == 0)
+        {
+            std::stringstream ss;
+            ss << "Cannot delete species at " << index << " from list of size " << list_size << "." << std::endl;
+            throw std::out_of_range(ss.str());
+        }
+#endif // DEBUG
+        const unsigned long last = list_size - 1;
+        unsigned long moved = 0;
+        if(index != last)
+        {
+            moved = lineage_indices[last];
+            lineage_indices[index] = moved;
+        }
+        lineage_indices[last] = 0;
         list_size--;
+        return moved;
     }
 
-    void SpeciesList::decreaseNwrap()
+    bool SpeciesList::compact()
     {
-        if(nwrap == 0)
-        {
-            throw std::runtime_error("Nwrap should never be decreased less than 0");
-        }
-        else if(nwrap == 1)
+        unsigned long position = 0;
+        bool moved = false;
+        for(unsigned long i = 0; i < lineage_indices.size(); i++)
         {
-            if(next_active != 0)
+            if(lineage_indices[i] != 0)
             {
-                throw std::runtime_error("Nwrap is being set at 0 when an wrapped lineage is still present");
+                if(i != position)
+                {
+                    lineage_indices[position] = lineage_indices[i];
+                    lineage_indices[i] = 0;
+                    moved = true;
+                }
+                position++;
             }
         }
-        nwrap--;
+        list_size = position;
+        return moved;
     }
 
     void SpeciesList::increaseListSize()
@@ -169,11 +152,6 @@ namespace necsim
         list_size++;
     }
 
-    void SpeciesList::increaseNwrap()
-    {
-        nwrap++;
-    }
-
     void SpeciesList::changePercentCover(unsigned long newmaxsize)
     {
         max_size = newmaxsize;
@@ -181,49 +159,22 @@ namespace necsim
 
     unsigned long SpeciesList::getRandLineage(const shared_ptr<RNGController> &rand_no)
     {
-        double rand_index;
         if(max_size <= list_size)
         {
             // Then the lineage_indices size is larger than the actual size. This means we must return a lineage.
-            try
-            {
-                do
-                {
-                    rand_index = rand_no->d01();
-                    rand_index *= lineage_indices.size();
-                    //os << "ref: " << rand_index << ", " << lineage_indices[round(rand_index)] << std::endl;
-                }
-                while(lineage_indices[floor(rand_index)] == 0);
-                //os << "RETURNING!" << std::endl;
-                return (lineage_indices[floor(rand_index)]);
-            }
-            catch(std::out_of_range &oor)
+            if(list_size == 0)
             {
-                throw std::runtime_error("Listpos outside max_size.");
+                throw std::runtime_error("Cannot choose a random lineage from an empty list.");
             }
+            auto i = static_cast<unsigned long>(rand_no->d01() * list_size);
+            return lineage_indices[std::min(i, list_size - 1)];
         }
-        else
+        auto i = static_cast<unsigned long>(rand_no->d01() * max_size);
+        if(i >= list_size)
         {
-            rand_index = rand_no->d01();
-            //		os << "rand_index: " << rand_index << std::endl;
-            rand_index *= max_size;
-            if(rand_index >= lineage_indices.size())
-            {
-                return 0;
-            }
-
-            auto i = static_cast<unsigned long>(floor(rand_index));
-
-#ifdef DEBUG
-            if(rand_index > max_size)
-            {
-                std::stringstream ss;
-                ss << "Random index is greater than the max size. Fatal error, please report this bug." << std::endl;
-                throw std::runtime_error(ss.str());
-            }
-#endif // DEBUG
-            return lineage_indices[i];
+            return 0;
         }
+        return lineage_indices[i];
     }
 
     unsigned long SpeciesList::getLineageIndex(unsigned long index) const
@@ -231,16 +182,6 @@ namespace necsim
         return lineage_indices[index];
     }
 
-    unsigned long SpeciesList::getNext() const
-    {
-        return next_active;
-    }
-
-    unsigned long SpeciesList::getNwrap() const
-    {
-        return nwrap;
-    }
-
     unsigned long SpeciesList::getListSize() const
     {
         return list_size;
@@ -256,10 +197,13 @@ namespace necsim
         return lineage_indices.size();
     }
 
+    void SpeciesList::setListLength(unsigned long length)
+    {
+        lineage_indices.resize(length, 0);
+    }
+
     void SpeciesList::wipeList()
     {
-        next_active = 0;
-        nwrap = 0;
         list_size = 0;
     }
 
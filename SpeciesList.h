@@ -36,14 +36,16 @@ namespace necsim
      *
      * Note that the maximum size of the list is constrained by the maximum size of unsigned long. Any simulation
      * requiring more individuals per cell than this will unlikely finish in any reasonable time anyway.
+     *
+     * The lineages are kept at the start of the list, with no empty positions between them, so that adding, removing
+     * and randomly choosing a lineage all take constant time. Removing a lineage moves the last lineage in the list into
+     * its position.
      */
     class SpeciesList
     {
     private:
         unsigned long list_size{}, max_size{}; // List size and maximum size of the cell (based on percentage cover).
-        unsigned long next_active{}; // For calculating the wrapping, using the next and last system.
-        vector<unsigned long> lineage_indices; // list of the active reference number, with zeros for empty cells.
-        unsigned long nwrap{}; // The number of wrapping (next and last possibilities) that there are.
+        vector<unsigned long> lineage_indices; // list of the active reference number, followed by zeros.
     public:
         /**
          * @brief Default constructor
@@ -101,19 +103,7 @@ namespace necsim
         void setSpeciesEmpty(unsigned long index, unsigned long new_val);
 
         /**
-         * @brief Set the next active lineage (for wrapping purposes).
-         * @param n the lineage to set as the first wrapped lineage.
-         */
-        void setNext(unsigned long n);
-
-        /**
-         * @brief Set the number of wrapping lineages.
-         * @param nr the number of wrapped lineages.
-         */
-        void setNwrap(unsigned long nr);
-
-        /**
-         * @brief Add a new species to the first empty place and return the position of the lineage.
+         * @brief Add a new species to the end of the list and return the position of the lineage.
          * @param new_spec the new species reference to place in the first empty space.
          * @return the location the species has been added to.
          */
@@ -121,32 +111,28 @@ namespace necsim
 
         /**
          * @brief Removes the species at the specified index.
-         * The species number will be replaced with 0, indicating no species present.
          *
-         * Older versions of this function re-shuffled the list so that all species came at the top.
+         * The last species in the list is moved into the empty position, so the caller must update the list position
+         * of that lineage.
          * @param index the index of the species to remove from the list.
+         * @return the reference of the lineage moved to index, or 0 if no lineage was moved
          */
-        void deleteSpecies(unsigned long index);
+        unsigned long deleteSpecies(unsigned long index);
 
         /**
-         * @brief Decreases the nwrap by one.
+         * @brief Moves all lineages to the start of the list, keeping their order.
          *
-         * Indicates the number of species wrapped at the location of this SpeciesList object has decreased by one.
+         * Only required after the list has been filled using setSpeciesEmpty(), for example when restoring from a
+         * paused simulation.
+         * @return true if any lineages were moved
          */
-        void decreaseNwrap();
+        bool compact();
 
         /**
          * @brief Increases the list size by one.
          */
         void increaseListSize();
 
-        /**
-         * @brief Increases the nwrap by one.
-         *
-         * Indicates the number of species wrapped at the location of this SpeciesList object has increased by one.
-         */
-        void increaseNwrap();
-
         /**
          * @brief Changes the maximum size of the SpeciesList.
          * Currently identical to setMaxsize.
@@ -156,7 +142,7 @@ namespace necsim
 
         /**
          * @brief Get a random species reference number from all the potential entries.
-         * Updated alternative version returns any entry, including empty cells, giving the probability of coalescence as well.
+         * Returns any entry up to the maximum size, including empty cells, giving the probability of coalescence as well.
          * @param rand_no the random number object to pass (for maintaining the same seed throughout simulations).
          * @return the reference of the random lineage. 0 indicates an empty space.
          */
@@ -169,18 +155,6 @@ namespace necsim
          */
         unsigned long getLineageIndex(unsigned long index) const;
 
-        /**
-         * @brief Get the next_active variable.
-         * @return the next linked species reference.
-         */
-        unsigned long getNext() const;
-
-        /**
-         * @brief Getter for the nwrap.
-         * @return the number of wrapped lineages currently at this grid cell.
-         */
-        unsigned long getNwrap() const;
-
         /**
          * @brief Getter for the list size.
          * @return the number of lineages currently directly within the SpeciesList.
@@ -199,6 +173,13 @@ namespace necsim
          */
         unsigned long getListLength() const;
 
+        /**
+         * @brief Sets the length of the list, filling any new positions with zeros.
+         * Used when restoring the list from a saved state.
+         * @param length the new length of the list
+         */
+        void setListLength(unsigned long length);
+
         /**
          * @brief Empties the list of any data and fills the list with zeros.
          */
@@ -0,0 +1,140 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file TiledSums.cpp
+ * @brief Contains the TiledSums class for maintaining the total of a value across every cell of a map.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "TiledSums.h"
+#include "custom_exceptions.h"
+
+namespace necsim
+{
+    const unsigned long TiledSums::TILE_SIZE;
+
+    TiledSums::TiledSums() : rows(0), cols(0), tile_cols(0), values(), tile_sums(), tile_updates(), sum(0.0)
+    {
+
+    }
+
+    unsigned long TiledSums::getTile(const unsigned long &y, const unsigned long &x) const
+    {
+        return (y / TILE_SIZE) * tile_cols + x / TILE_SIZE;
+    }
+
+    void TiledSums::generateTile(const unsigned long &tile)
+    {
+        const unsigned long y_min = (tile / tile_cols) * TILE_SIZE;
+        const unsigned long x_min = (tile % tile_cols) * TILE_SIZE;
+        const unsigned long y_max = std::min(y_min + TILE_SIZE, rows);
+        const unsigned long width = std::min(x_min + TILE_SIZE, cols) - x_min;
+        double tile_sum = 0.0;
+        for(unsigned long y = y_min; y < y_max; y++)
+        {
+            tile_sum += sumRange(&values[y * cols + x_min], width);
+        }
+        tile_sums[tile] = tile_sum;
+        tile_updates[tile] = 0;
+        sum = sumRange(tile_sums.data(), tile_sums.size());
+    }
+
+    double TiledSums::sumRange(const double *first, const unsigned long &count)
+    {
+        double partial_sums[4] = {0.0, 0.0, 0.0, 0.0};
+        unsigned long i = 0;
+        for(; i + 4 <= count; i += 4)
+        {
+            partial_sums[0] += first[i];
+            partial_sums[1] += first[i + 1];
+            partial_sums[2] += first[i + 2];
+            partial_sums[3] += first[i + 3];
+        }
+        for(; i < count; i++)
+        {
+            partial_sums[0] += first[i];
+        }
+        return (partial_sums[0] + partial_sums[1]) + (partial_sums[2] + partial_sums[3]);
+    }
+
+    void TiledSums::assign(const unsigned long &rows_in, const unsigned long &cols_in, const vector<double> &values_in)
+    {
+        if(values_in.size() != rows_in * cols_in)
+        {
+            std::stringstream ss;
+            ss << "Cannot assign " << values_in.size() << " values to a map of " << rows_in << " by " << cols_in
+               << " cells. Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+        rows = rows_in;
+        cols = cols_in;
+        values = values_in;
+        tile_cols = (cols + TILE_SIZE - 1) / TILE_SIZE;
+        const unsigned long tile_rows = (rows + TILE_SIZE - 1) / TILE_SIZE;
+        tile_sums.assign(tile_rows * tile_cols, 0.0);
+        tile_updates.assign(tile_rows * tile_cols, 0);
+        // Each row of the map is summed one tile-width run at a time, so that the cells are read in order.
+        for(unsigned long y = 0; y < rows; y++)
+        {
+            const unsigned long tile_row_start = (y / TILE_SIZE) * tile_cols;
+            for(unsigned long x_min = 0; x_min < cols; x_min += TILE_SIZE)
+            {
+                const unsigned long width = std::min(x_min + TILE_SIZE, cols) - x_min;
+                tile_sums[tile_row_start + x_min / TILE_SIZE] += sumRange(&values[y * cols + x_min], width);
+            }
+        }
+        sum = sumRange(tile_sums.data(), tile_sums.size());
+    }
+
+    void TiledSums::clear()
+    {
+        rows = 0;
+        cols = 0;
+        tile_cols = 0;
+        values.clear();
+        tile_sums.clear();
+        tile_updates.clear();
+        sum = 0.0;
+    }
+
+    double TiledSums::get(const unsigned long &y, const unsigned long &x) const
+    {
+        return values[y * cols + x];
+    }
+
+    void TiledSums::set(const unsigned long &y, const unsigned long &x, const double &value)
+    {
+#ifdef DEBUG
+        if(y >= rows || x >= cols)
+        {
+            std::stringstream ss;
+            ss << "Cell " << x << ", " << y << " is outside the map of " << cols << " by " << rows
+               << " cells. Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+#endif // DEBUG
+        double &current = values[y * cols + x];
+        const double difference = value - current;
+        current = value;
+        const unsigned long tile = getTile(y, x);
+        tile_updates[tile]++;
+        if(tile_updates[tile] >= TILE_SIZE * TILE_SIZE)
+        {
+            generateTile(tile);
+        }
+        else
+        {
+            tile_sums[tile] += difference;
+            sum += difference;
+        }
+    }
+
+    double TiledSums::total() const
+    {
+        return sum;
+    }
+}
@@ -0,0 +1,108 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file TiledSums.h
+ * @brief Contains the TiledSums class for maintaining the total of a value across every cell of a map.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_TILEDSUMS_H
+#define NECSIM_TILEDSUMS_H
+
+#include <vector>
+
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief Stores a value for each cell of a map, along with the sum of each square tile of cells and the total
+     * across the map.
+     *
+     * Changing the value of a cell takes constant time, so that updating k cells costs O(k) rather than requiring the
+     * whole map to be summed again. Once a tile has had as many updates as it has cells, its sum is regenerated from
+     * the cell values, so that rounding errors from repeated updates do not accumulate.
+     */
+    class TiledSums
+    {
+    protected:
+        // The width and height of each tile, in cells.
+        static const unsigned long TILE_SIZE = 64;
+        // The dimensions of the map, in cells.
+        unsigned long rows, cols;
+        // The number of tiles across the map.
+        unsigned long tile_cols;
+        // The value of each cell, in row-major order.
+        vector<double> values;
+        // The sum of the values in each tile, in row-major order.
+        vector<double> tile_sums;
+        // The number of updates to each tile since its sum was last generated from the values.
+        vector<unsigned long> tile_updates;
+        // The sum of all values.
+        double sum;
+
+        /**
+         * @brief Gets the tile containing the cell.
+         * @param y the row of the cell
+         * @param x the column of the cell
+         * @return the index of the tile
+         */
+        unsigned long getTile(const unsigned long &y, const unsigned long &x) const;
+
+        /**
+         * @brief Regenerates the sum of the tile from the values of its cells, and the total from the tile sums.
+         * @param tile the index of the tile
+         */
+        void generateTile(const unsigned long &tile);
+
+        /**
+         * @brief Sums a contiguous run of values.
+         *
+         * Four independent partial sums are kept, so that the additions can be vectorised.
+         * @param first the first value to sum
+         * @param count the number of values to sum
+         * @return the sum of the values
+         */
+        static double sumRange(const double *first, const unsigned long &count);
+
+    public:
+        TiledSums();
+
+        /**
+         * @brief Sets the values of every cell, regenerating all sums.
+         * @param rows_in the number of rows in the map
+         * @param cols_in the number of columns in the map
+         * @param values_in the value of each cell, in row-major order
+         */
+        void assign(const unsigned long &rows_in, const unsigned long &cols_in, const vector<double> &values_in);
+
+        /**
+         * @brief Removes all cells.
+         */
+        void clear();
+
+        /**
+         * @brief Gets the value of the cell.
+         * @param y the row of the cell
+         * @param x the column of the cell
+         * @return the value
+         */
+        double get(const unsigned long &y, const unsigned long &x) const;
+
+        /**
+         * @brief Sets the value of the cell, updating the sum of its tile and the total.
+         * @param y the row of the cell
+         * @param x the column of the cell
+         * @param value the new value
+         */
+        void set(const unsigned long &y, const unsigned long &x, const double &value);
+
+        /**
+         * @brief Gets the sum of the values of all cells.
+         * @return the total
+         */
+        double total() const;
+    };
+}
+#endif //NECSIM_TILEDSUMS_H
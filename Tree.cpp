@@ -106,8 +106,19 @@ namespace necsim
         //	char file_to_open[100];
         //	sprintf (file_to_open, "%s/Pause/Data_%i.csv",outdirect,int(task));
         file_to_open = output_dir + string("/Pause/Dump_main_") + std::to_string((unsigned long long) task) + "_"
-                       + std::to_string((unsigned long long) seed_in) + string(".csv");
-        out.open(file_to_open);
+                       + std::to_string((unsigned long long) seed_in);
+        out.open(file_to_open + string(".csv"));
+        if(!out.good())
+        {
+            out.open(file_to_open + string(".ckpt"), std::ios::binary);
+        }
+        // Also check for periodic checkpoints from simulations that were interrupted before pausing.
+        for(unsigned int slot = 0; slot < 2 && !out.good(); slot++)
+        {
+            out.open(output_dir + string("/Pause/Checkpoint_") + std::to_string((unsigned long long) task) + "_"
+                     + std::to_string((unsigned long long) seed_in) + "_" + std::to_string(slot) + ".ckpt",
+                     std::ios::binary);
+        }
         if(out.good())
         {
             os << "done." << std::endl << "File found containing unfinished simulations." << std::endl;
@@ -256,6 +267,8 @@ namespace necsim
     {
         this_step.bContinueSim = true;
         this_step.time_reference = 0;
+        time(&last_checkpoint_time);
+        last_checkpoint_step = steps;
         if(uses_temporal_sampling && generation > 0.0)
         {
             for(unsigned int i = 0; i < reference_times.size(); i++)
@@ -504,6 +517,7 @@ namespace necsim
         do
         {
             runSingleLoop();
+            checkPeriodicCheckpoint();
         }
         while((endactive > 1) && (steps < 100 || difftime(sim_end, start) < maxtime) && this_step.bContinueSim);
         // If the simulations finish correctly, output the completed data->
@@ -513,6 +527,7 @@ namespace necsim
 
     bool Tree::stopSimulation()
     {
+        waitForPeriodicCheckpoint();
         if(endactive > 1)
         {
             std::stringstream os;
@@ -536,6 +551,7 @@ namespace necsim
             sim_complete = true;
             time(&sim_finish);
             time_taken += sim_finish - start;
+            removePeriodicCheckpoints();
             if(!this_step.bContinueSim)
             {
                 writeInfo("done - desired number of species achieved!\n");
@@ -780,6 +796,8 @@ namespace necsim
         min_data += min_active * 2;
         if(data->size() < min_data)
         {
+            // A periodic checkpoint may still be reading the nodes.
+            waitForPeriodicCheckpoint();
             // change the size of data
             data->resize(min_data);
         }
@@ -794,19 +812,19 @@ namespace necsim
     void Tree::makeTip(const unsigned long &tmp_active, const double &generationin, vector<TreeNode> &data_added)
     {
         auto cur_active = &active[tmp_active];
-        auto cur_data = &(*data)[cur_active->getReference()];
-        if(cur_data->isTip())
+        auto cur_data = (*data)[cur_active->getReference()];
+        if(cur_data.isTip())
         {
             createNewTip(tmp_active, generationin, data_added);
         }
         else
         {
-            cur_data->setGeneration(generationin);
-            cur_data->setTip(true);
-            cur_data->setPosition(cur_active->getXpos(),
-                                  cur_active->getYpos(),
-                                  cur_active->getXwrap(),
-                                  cur_active->getYwrap());
+            cur_data.setGeneration(generationin);
+            cur_data.setTip(true);
+            cur_data.setPosition(cur_active->getXpos(),
+                                 cur_active->getYpos(),
+                                 cur_active->getXwrap(),
+                                 cur_active->getYwrap());
         }
     }
 
@@ -1130,6 +1148,8 @@ namespace necsim
 #endif
 #ifndef sql_ram
             database->open(sql_output_database);
+            database->setPragmas(SQLitePragmas(sim_parameters->sqlite_journal_mode, sim_parameters->sqlite_synchronous,
+                                               sim_parameters->sqlite_page_size));
 #endif
         }
     }
@@ -1167,6 +1187,7 @@ namespace necsim
             writeCritical(ss.str());
         }
         sqlCreateSimulationParameters();
+        sqlCreateAlgorithmRates();
     }
 
     void Tree::setupOutputDirectory()
@@ -1217,6 +1238,26 @@ namespace necsim
         database->execute(to_execute);
     }
 
+    void Tree::sqlCreateAlgorithmRates()
+    {
+        if(!using_gillespie)
+        {
+            return;
+        }
+        database->execute("CREATE TABLE IF NOT EXISTS GILLESPIE_RATES (automatic INT NOT NULL, "
+                          "threshold DOUBLE NOT NULL, step_rate DOUBLE NOT NULL, estimated_event_rate DOUBLE NOT NULL, "
+                          "event_rate DOUBLE NOT NULL, event_proportion DOUBLE NOT NULL, "
+                          "switch_generation DOUBLE NOT NULL, switch_lineages INT NOT NULL);");
+        std::stringstream ss;
+        ss << std::setprecision(17);
+        ss << "INSERT INTO GILLESPIE_RATES VALUES(" << automatic_gillespie << "," << gillespie_threshold << ","
+           << gillespie_rates.step_rate << "," << gillespie_rates.estimated_event_rate << ","
+           << gillespie_rates.event_rate << ","
+           << gillespie_rates.event_proportion << "," << gillespie_rates.switch_generation << ","
+           << gillespie_rates.switch_lineages << ");";
+        database->execute(ss.str());
+    }
+
     string Tree::simulationParametersSqlInsertion()
     {
         string to_execute;
@@ -1249,6 +1290,13 @@ namespace necsim
 
     void Tree::simPause()
     {
+        if(usesBinaryPause())
+        {
+            auto out1 = initiateBinaryPause();
+            dumpCheckpoint(*out1);
+            completePause(out1);
+            return;
+        }
         auto out1 = initiatePause();
         dumpMain(out1);
         dumpActive(out1);
@@ -1256,13 +1304,122 @@ namespace necsim
         completePause(out1);
     }
 
-    shared_ptr<std::ofstream> Tree::initiatePause()
+    bool Tree::usesBinaryPause() const
+    {
+        return sim_parameters->pause_format == "binary";
+    }
+
+    string Tree::getPauseFileName(const string &directory, bool binary) const
+    {
+        return directory + string("/Pause/Dump_main_") + std::to_string(task) + "_" + std::to_string(seed)
+               + (binary ? string(".ckpt") : string(".csv"));
+    }
+
+    string Tree::getCheckpointFileName(const string &directory, unsigned int slot) const
+    {
+        return directory + string("/Pause/Checkpoint_") + std::to_string(task) + "_" + std::to_string(seed) + "_"
+               + std::to_string(slot) + ".ckpt";
+    }
+
+    string Tree::findResumeCheckpoint(const string &directory) const
+    {
+        const string text_file = getPauseFileName(directory, false);
+        const bool has_text = fs::exists(text_file);
+        string newest_file;
+        fs::file_time_type newest_time{};
+        for(const auto &binary_file : {getPauseFileName(directory, true), getCheckpointFileName(directory, 0),
+                                       getCheckpointFileName(directory, 1)})
+        {
+            if(!fs::exists(binary_file))
+            {
+                continue;
+            }
+            const auto write_time = fs::last_write_time(binary_file);
+            if(has_text && write_time < fs::last_write_time(text_file))
+            {
+                continue;
+            }
+            if((newest_file.empty() || write_time > newest_time) && CheckpointReader::isValid(binary_file))
+            {
+                newest_file = binary_file;
+                newest_time = write_time;
+            }
+        }
+        if(!has_text && newest_file.empty())
+        {
+            std::stringstream ss;
+            ss << "No valid checkpoint or pause file found in " << directory << "/Pause/." << std::endl;
+            throw FatalException(ss.str());
+        }
+        return newest_file;
+    }
+
+    void Tree::writePeriodicCheckpoint()
+    {
+        if(pending_checkpoint.valid())
+        {
+            if(pending_checkpoint.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                return;
+            }
+            waitForPeriodicCheckpoint();
+        }
+        createPauseFolder();
+        // Capture the state in memory on the simulation thread, so that the simulation can continue whilst the
+        // (much slower) write to disk happens in the background. Only the live state is copied, as the coalescence
+        // tree is read in the background - the simulation must not resize it or change the nodes of lineages which
+        // are no longer active until the write has completed.
+        auto snapshot = make_shared<CheckpointBuffer>();
+        dumpCheckpoint(*snapshot);
+        const string file_name = getCheckpointFileName(out_directory, checkpoint_slot);
+        pending_checkpoint = std::async(std::launch::async, [snapshot, file_name]()
+        {
+            CheckpointWriter out;
+            out.open(file_name);
+            snapshot->writeTo(out);
+            out.close();
+        });
+        checkpoint_slot = 1 - checkpoint_slot;
+        last_checkpoint_step = steps;
+        time(&last_checkpoint_time);
+#ifdef DEBUG
+        writeLog(10, "Writing periodic checkpoint to " + file_name + " at step " + std::to_string(steps) + ".");
+#endif // DEBUG
+    }
+
+    void Tree::waitForPeriodicCheckpoint()
+    {
+        if(!pending_checkpoint.valid())
+        {
+            return;
+        }
+        try
+        {
+            pending_checkpoint.get();
+        }
+        catch(std::exception &e)
+        {
+            std::stringstream ss;
+            ss << "Failed to write periodic checkpoint: " << e.what() << std::endl;
+            writeWarning(ss.str());
+        }
+    }
+
+    void Tree::removePeriodicCheckpoints()
+    {
+        waitForPeriodicCheckpoint();
+        for(unsigned int slot = 0; slot < 2; slot++)
+        {
+            const string file_name = getCheckpointFileName(out_directory, slot);
+            if(fs::exists(file_name))
+            {
+                fs::remove(file_name);
+            }
+        }
+    }
+
+    string Tree::createPauseFolder()
     {
-        std::stringstream os;
-        os << "Pausing simulation..." << std::endl << "Saving data to temp file in " << out_directory << "/Pause/ ..."
-           << std::flush;
-        writeInfo(os.str());
-        os.str("");
         // Create the pause directory
         string pause_folder = out_directory + "/Pause/";
         fs::path pause_dir(pause_folder);
@@ -1282,6 +1439,13 @@ namespace necsim
                 pause_folder = out_directory;
             }
         }
+        return pause_folder;
+    }
+
+    shared_ptr<std::ofstream> Tree::initiatePause()
+    {
+        writeInfo("Pausing simulation...\nSaving data to temp file in " + out_directory + "/Pause/ ...");
+        string pause_folder = createPauseFolder();
         string file_to_open = pause_folder + "Dump_main_" + std::to_string(task) + "_" + std::to_string(seed) + ".csv";
         shared_ptr<std::ofstream> out = make_shared<std::ofstream>();
         out->open(file_to_open.c_str());
@@ -1289,9 +1453,30 @@ namespace necsim
         return out;
     }
 
+    shared_ptr<CheckpointWriter> Tree::initiateBinaryPause()
+    {
+        writeInfo("Pausing simulation...\nSaving data to temp file in " + out_directory + "/Pause/ ...");
+        string pause_folder = createPauseFolder();
+        string file_to_open = pause_folder + "Dump_main_" + std::to_string(task) + "_" + std::to_string(seed) + ".ckpt";
+        shared_ptr<CheckpointWriter> out = make_shared<CheckpointWriter>();
+        out->open(file_to_open);
+        return out;
+    }
+
     void Tree::completePause(shared_ptr<std::ofstream> out)
     {
         out->close();
+        completePause();
+    }
+
+    void Tree::completePause(shared_ptr<CheckpointWriter> out)
+    {
+        out->close();
+        completePause();
+    }
+
+    void Tree::completePause()
+    {
         std::stringstream os;
         os << "done." << std::endl;
         os << "SQL dump started" << std::endl;
@@ -1307,23 +1492,37 @@ namespace necsim
     }
 
     void Tree::dumpMain(shared_ptr<std::ofstream> out)
+    {
+        dumpMain(*out);
+    }
+
+    void Tree::dumpMain(std::ostream &out)
     {
         try
         {
+            // Save the version of the text pause format, so that older pauses can still be read
+            out << text_pause_marker << "\n" << text_pause_version << "\n";
             // Save that this simulation was not a protracted speciation sim
-            *out << bIsProtracted << "\n";
+            out << bIsProtracted << "\n";
             // Saving the initial data to one file.
-            *out << enddata << "\n" << seeded << "\n" << seed << "\n" << task << "\n" << times_file << "\n"
-                 << uses_temporal_sampling << "\n";
-            *out << out_directory << "\n";
-            *out << has_imported_vars << "\n" << start << "\n" << sim_start << "\n";
-            *out << sim_end << "\n" << now << "\n" << time_taken << "\n" << sim_finish << "\n" << out_finish << "\n";
-            *out << endactive << "\n" << startendactive << "\n" << maxsimsize << "\n" << steps << "\n";
-            *out << generation << "\n" << "\n" << maxtime << "\n";
-            *out << deme_sample << "\n" << spec << "\n" << deme << "\n";
-            *out << sql_output_database << "\n" << *NR << "\n" << *sim_parameters << "\n";
+            out << enddata << "\n" << seeded << "\n" << seed << "\n" << task << "\n" << times_file << "\n"
+                << uses_temporal_sampling << "\n";
+            out << out_directory << "\n";
+            out << has_imported_vars << "\n" << start << "\n" << sim_start << "\n";
+            out << sim_end << "\n" << now << "\n" << time_taken << "\n" << sim_finish << "\n" << out_finish << "\n";
+            out << endactive << "\n" << startendactive << "\n" << maxsimsize << "\n" << steps << "\n";
+            out << generation << "\n" << "\n" << maxtime << "\n";
+            out << deme_sample << "\n" << spec << "\n" << deme << "\n";
+            out << sql_output_database << "\n" << *NR << "\n" << *sim_parameters << "\n";
             // now output the protracted speciation variables (there should be two of these).
-            *out << getProtractedVariables();
+            out << getProtractedVariables();
+            // Parameters added in version 1 of the text pause are appended after the existing entries.
+            out << sim_parameters->pause_format << "\n" << sim_parameters->checkpoint_interval << "\n"
+                << sim_parameters->checkpoint_steps << "\n";
+            out << sim_parameters->materialise_fine_density << "\n" << sim_parameters->coarse_map_cache_size << "\n";
+            out << sim_parameters->sqlite_journal_mode << "\n" << sim_parameters->sqlite_synchronous << "\n"
+                << sim_parameters->sqlite_page_size << "\n";
+            out << gillespie_rates;
         }
         catch(std::exception &e)
         {
@@ -1333,6 +1532,17 @@ namespace necsim
         }
     }
 
+    void Tree::dumpMain(CheckpointSink &out)
+    {
+        // The main variables are small, so are stored using the same text representation as the text dump.
+        std::stringstream ss;
+        ss << std::setprecision(64);
+        dumpMain(ss);
+        out.beginSection(CheckpointSection::main);
+        out.writeString(ss.str());
+        out.endSection();
+    }
+
     void Tree::dumpActive(shared_ptr<std::ofstream> out)
     {
         try
@@ -1363,6 +1573,91 @@ namespace necsim
         }
     }
 
+    void Tree::dumpActive(CheckpointSink &out)
+    {
+        out.beginSection(CheckpointSection::active);
+        // Only the lineages up to endactive are in use, so the remainder are not stored.
+        const uint64_t stored = std::min(static_cast<uint64_t>(active.size()), static_cast<uint64_t>(endactive) + 1);
+        out.writeValue<uint64_t>(active.size());
+        out.writeValue<uint64_t>(stored);
+        // Pack in blocks so that the writes to file are large and sequential.
+        vector<PackedDataPoint> block;
+        block.reserve(std::min(stored, static_cast<uint64_t>(65536)));
+        for(uint64_t i = 0; i < stored; i++)
+        {
+            block.push_back(packDataPoint(active[i]));
+            if(block.size() == block.capacity())
+            {
+                out.write(block.data(), block.size() * sizeof(PackedDataPoint));
+                block.clear();
+            }
+        }
+        out.write(block.data(), block.size() * sizeof(PackedDataPoint));
+        out.endSection();
+    }
+
+    void Tree::dumpData(CheckpointSink &out)
+    {
+        // Nodes after enddata have not been written to yet, so are not stored.
+        const uint64_t size = data->size();
+        const uint64_t stored = std::min(size, static_cast<uint64_t>(enddata) + 1);
+        // Only the nodes of active lineages are changed by the simulation, so only those are copied now. The other
+        // nodes are packed when the section is written, which may be later on a background thread.
+        auto active_nodes = make_shared<vector<std::pair<uint64_t, PackedTreeNode>>>();
+        active_nodes->reserve(endactive);
+        for(unsigned long i = 1; i <= endactive; i++)
+        {
+            const unsigned long reference = active[i].getReference();
+            if(reference < stored)
+            {
+                active_nodes->emplace_back(reference, packTreeNode((*data)[reference]));
+            }
+        }
+        std::sort(active_nodes->begin(), active_nodes->end(),
+                  [](const std::pair<uint64_t, PackedTreeNode> &a, const std::pair<uint64_t, PackedTreeNode> &b)
+                  {
+                      return a.first < b.first;
+                  });
+        shared_ptr<const TreeNodeStore> nodes = data;
+        out.writeSection(CheckpointSection::data, [nodes, active_nodes, size, stored](CheckpointSink &sink)
+        {
+            sink.writeValue<uint64_t>(size);
+            sink.writeValue<uint64_t>(stored);
+            auto next_active = active_nodes->begin();
+            vector<PackedTreeNode> block;
+            block.reserve(std::min(stored, static_cast<uint64_t>(65536)));
+            for(uint64_t i = 0; i < stored; i++)
+            {
+                if(next_active != active_nodes->end() && next_active->first == i)
+                {
+                    block.push_back(next_active->second);
+                    // Skip any repeated references.
+                    while(next_active != active_nodes->end() && next_active->first == i)
+                    {
+                        ++next_active;
+                    }
+                }
+                else
+                {
+                    block.push_back(packTreeNode((*nodes)[i]));
+                }
+                if(block.size() == block.capacity())
+                {
+                    sink.write(block.data(), block.size() * sizeof(PackedTreeNode));
+                    block.clear();
+                }
+            }
+            sink.write(block.data(), block.size() * sizeof(PackedTreeNode));
+        });
+    }
+
+    void Tree::dumpCheckpoint(CheckpointSink &out)
+    {
+        dumpMain(out);
+        dumpActive(out);
+        dumpData(out);
+    }
+
     void Tree::setResumeParameters()
     {
         if(!has_imported_pause)
@@ -1375,9 +1670,7 @@ namespace necsim
     shared_ptr<std::ifstream> Tree::openSaveFile()
     {
         shared_ptr<std::ifstream> in1 = make_shared<std::ifstream>();
-        string file_to_open =
-                pause_sim_directory + string("/Pause/Dump_main_") + std::to_string(task) + "_" + std::to_string(seed)
-                + string(".csv");
+        string file_to_open = getPauseFileName(pause_sim_directory, false);
         in1->open(file_to_open);
         if(!*in1)
         {
@@ -1406,6 +1699,11 @@ namespace necsim
     }
 
     void Tree::loadMainSave(shared_ptr<std::ifstream> in1)
+    {
+        loadMainSave(*in1);
+    }
+
+    void Tree::loadMainSave(std::istream &in1)
     {
         try
         {
@@ -1417,8 +1715,27 @@ namespace necsim
             string string1;
             // First read our boolean which just determines whether the simulation is a protracted simulation or not.
             // For these simulations, it should not be.
+            string first_entry;
+            in1 >> first_entry;
             bool tmp;
-            *in1 >> tmp;
+            if(first_entry == text_pause_marker)
+            {
+                in1 >> pause_version;
+                if(pause_version > text_pause_version)
+                {
+                    std::stringstream ss;
+                    ss << "Text pause version " << pause_version << " is newer than the supported version ";
+                    ss << text_pause_version << "." << std::endl;
+                    throw FatalException(ss.str());
+                }
+                in1 >> tmp;
+            }
+            else
+            {
+                // Pauses written before the format was versioned start with the protracted boolean.
+                pause_version = 0;
+                tmp = first_entry == "1";
+            }
             if(tmp != getProtracted())
             {
                 if(getProtracted())
@@ -1432,25 +1749,25 @@ namespace necsim
                                          "Cannot be resumed by this program. Please report this bug");
                 }
             }
-            *in1 >> enddata >> seeded >> seed >> task;
-            in1->ignore(); // Ignore the endline character
-            getline(*in1, times_file);
-            *in1 >> uses_temporal_sampling;
-            in1->ignore();
-            getline(*in1, string1);
+            in1 >> enddata >> seeded >> seed >> task;
+            in1.ignore(); // Ignore the endline character
+            getline(in1, times_file);
+            in1 >> uses_temporal_sampling;
+            in1.ignore();
+            getline(in1, string1);
             time_t tmp_time;
-            *in1 >> has_imported_vars >> tmp_time;
-            *in1 >> sim_start >> sim_end >> now;
-            *in1 >> time_taken >> sim_finish >> out_finish >> endactive >> startendactive >> maxsimsize >> steps;
+            in1 >> has_imported_vars >> tmp_time;
+            in1 >> sim_start >> sim_end >> now;
+            in1 >> time_taken >> sim_finish >> out_finish >> endactive >> startendactive >> maxsimsize >> steps;
             unsigned long tempmaxtime = maxtime;
-            *in1 >> generation >> maxtime;
+            in1 >> generation >> maxtime;
             has_imported_vars = false;
-            *in1 >> deme_sample >> spec >> deme;
-            in1->ignore();
-            getline(*in1, sql_output_database);
-            *in1 >> *NR;
-            in1->ignore();
-            *in1 >> *sim_parameters;
+            in1 >> deme_sample >> spec >> deme;
+            in1.ignore();
+            getline(in1, sql_output_database);
+            in1 >> *NR;
+            in1.ignore();
+            in1 >> *sim_parameters;
             if(maxtime == 0)
             {
                 sim_parameters->max_time = tempmaxtime;
@@ -1468,8 +1785,20 @@ namespace necsim
             }
             setParameters();
             double tmp1, tmp2;
-            *in1 >> tmp1 >> tmp2;
+            in1 >> tmp1 >> tmp2;
             setProtractedVariables(tmp1, tmp2);
+            // Older pauses do not contain these parameters, so the current values are kept.
+            if(pause_version >= 1)
+            {
+                in1 >> sim_parameters->pause_format >> sim_parameters->checkpoint_interval
+                    >> sim_parameters->checkpoint_steps;
+                in1 >> sim_parameters->materialise_fine_density >> sim_parameters->coarse_map_cache_size;
+                in1.ignore();
+                getline(in1, sim_parameters->sqlite_journal_mode);
+                getline(in1, sim_parameters->sqlite_synchronous);
+                in1 >> sim_parameters->sqlite_page_size;
+                in1 >> gillespie_rates;
+            }
             if(times_file == "null")
             {
                 if(uses_temporal_sampling)
@@ -1502,6 +1831,13 @@ namespace necsim
         }
     }
 
+    void Tree::loadMainSave(const CheckpointReader &in1)
+    {
+        auto section = in1.getSection(CheckpointSection::main);
+        std::istringstream is(section.readString());
+        loadMainSave(is);
+    }
+
     void Tree::loadDataSave(shared_ptr<std::ifstream> in1)
     {
         try
@@ -1538,6 +1874,50 @@ namespace necsim
         }
     }
 
+    void Tree::loadDataSave(const CheckpointReader &in1)
+    {
+        std::stringstream os;
+        os << "\rLoading data from temp file...data..." << std::flush;
+        writeInfo(os.str());
+        auto section = in1.getSection(CheckpointSection::data);
+        auto size = section.readValue<uint64_t>();
+        auto stored = section.readValue<uint64_t>();
+        if(stored > size || stored * sizeof(PackedTreeNode) != section.remaining())
+        {
+            throw FatalException("Size of data section in checkpoint does not match the number of nodes.");
+        }
+        data->clear();
+        data->resize(size);
+        for(uint64_t i = 0; i < stored; i++)
+        {
+            PackedTreeNode packed{};
+            section.read(&packed, sizeof(PackedTreeNode));
+            unpackTreeNode(packed, (*data)[i]);
+        }
+    }
+
+    void Tree::loadActiveSave(const CheckpointReader &in1)
+    {
+        std::stringstream os;
+        os << "\rLoading data from temp file...active..." << std::flush;
+        writeInfo(os.str());
+        auto section = in1.getSection(CheckpointSection::active);
+        auto size = section.readValue<uint64_t>();
+        auto stored = section.readValue<uint64_t>();
+        if(stored > size || stored * sizeof(PackedDataPoint) != section.remaining())
+        {
+            throw FatalException("Size of active section in checkpoint does not match the number of lineages.");
+        }
+        active.clear();
+        active.resize(size);
+        for(uint64_t i = 0; i < stored; i++)
+        {
+            PackedDataPoint packed{};
+            section.read(&packed, sizeof(PackedDataPoint));
+            unpackDataPoint(packed, active[i]);
+        }
+    }
+
     void Tree::initiateResume()
     {
         // Start the timer
@@ -1565,30 +1945,174 @@ namespace necsim
     void Tree::simResume()
     {
         initiateResume();
-        // open the save file
-        auto is = openSaveFile();
-        // now load the objects
-        loadMainSave(is);
-        setObjectSizes();
-        loadActiveSave(is);
-        loadDataSave(is);
+        const string checkpoint_file = findResumeCheckpoint(pause_sim_directory);
+        if(!checkpoint_file.empty())
+        {
+            CheckpointReader reader;
+            reader.open(checkpoint_file);
+            loadMainSave(reader);
+            setObjectSizes();
+            loadActiveSave(reader);
+            loadDataSave(reader);
+        }
+        else
+        {
+            // open the save file
+            auto is = openSaveFile();
+            // now load the objects
+            loadMainSave(is);
+            setObjectSizes();
+            loadActiveSave(is);
+            loadDataSave(is);
+        }
         time(&sim_start);
         writeInfo("\rLoading data from temp file...done.\n");
     }
 
     void Tree::addGillespie(const double &g_threshold)
     {
-        std::stringstream ss;
-        ss << "The gillespie algorithm is not supported for non-spatial coalescence trees yet. "
-           << " Cannot run with Gillespie threshold of " << g_threshold << ". "
-           << "Please contact the project maintainer if this is a feature you would like to see.";
-        throw FatalException(ss.str());
+        if(getProtracted())
+        {
+            std::stringstream ss;
+            ss << "The gillespie algorithm is not supported for non-spatial coalescence trees with protracted "
+                  "speciation. Cannot run with Gillespie threshold of " << g_threshold << "." << std::endl;
+            throw FatalException(ss.str());
+        }
+        writeInfo("Using gillespie algorithm for the whole of the non-spatial simulation.\n");
+        gillespie_threshold = g_threshold;
+        automatic_gillespie = false;
+        using_gillespie = true;
+    }
+
+    void Tree::addAutomaticGillespie()
+    {
+        // The non-spatial gillespie algorithm is faster from the start.
+        addGillespie(0.0);
+        automatic_gillespie = true;
     }
 
     bool Tree::runSimulationGillespie()
     {
-        throw FatalException("The gillespie algorithm is not supported for non-spatial coalescence trees yet. "
-                             "Please contact the project maintainer if this is a feature you would like to see.");
+        setupNonSpatialGillespie();
+        // There are no per-step measurements, as every event is simulated with the gillespie algorithm.
+        gillespie_rates.switch_generation = generation;
+        gillespie_rates.switch_lineages = endactive;
+        const long start_steps = steps;
+        const auto gillespie_start_time = std::chrono::steady_clock::now();
+        do
+        {
+            runNonSpatialGillespieEvent();
+            writeStepToConsole();
+            if(isPeriodicCheckpointDue())
+            {
+                // The checkpoint must contain the steps on each branch so far.
+                updateAllLineageBranches();
+                writePeriodicCheckpoint();
+            }
+        }
+        while((endactive > 1) && (steps < 100 || difftime(sim_end, start) < maxtime) && this_step.bContinueSim);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - gillespie_start_time;
+        if(elapsed.count() > 0.0)
+        {
+            gillespie_rates.event_rate = static_cast<double>(steps - start_steps) / elapsed.count();
+        }
+        updateAllLineageBranches();
+        return stopSimulation();
+    }
+
+    void Tree::setupNonSpatialGillespie()
+    {
+        null_step_intensity = 0.0;
+        lineage_intensity_start.assign(active.size(), 0.0);
+    }
+
+    void Tree::runNonSpatialGillespieEvent()
+    {
+        steps++;
+        const long double speciation_rate = 0.99999 * spec;
+        const auto n = static_cast<double>(endactive);
+        // The probability that a step by any lineage is a coalescence, given that it did not speciate.
+        const double coalescence_probability = (n - 1.0) / static_cast<double>(static_cast<unsigned long>(deme));
+        // Each lineage is chosen at rate 0.5 per generation, and each step is a speciation or coalescence event
+        // with probability event_probability.
+        const double event_probability = static_cast<double>(speciation_rate
+                                                             + (1.0 - speciation_rate) * coalescence_probability);
+        const double time_step = NR->randomExponential(0.5 * n * event_probability);
+        generation += time_step;
+        null_step_intensity += 0.5 * time_step * (1.0 - event_probability);
+        this_step.chosen = NR->i0(endactive - 1) + 1;
+        this_step.coalchosen = 0;
+        this_step.coal = false;
+        if(NR->d01() * event_probability < speciation_rate)
+        {
+            updateLineageBranch(this_step.chosen, true, true);
+            std::swap(lineage_intensity_start[this_step.chosen], lineage_intensity_start[endactive]);
+            speciation(this_step.chosen);
+        }
+        else
+        {
+            // Choose any other lineage uniformly to coalesce with.
+            this_step.coalchosen = NR->i0(endactive - 2) + 1;
+            if(this_step.coalchosen >= this_step.chosen)
+            {
+                this_step.coalchosen++;
+            }
+            this_step.coal = true;
+            updateLineageBranch(this_step.chosen, true, false);
+            updateLineageBranch(this_step.coalchosen, false, false);
+            removeOldPosition(this_step.chosen);
+            std::swap(lineage_intensity_start[this_step.chosen], lineage_intensity_start[endactive]);
+            coalescenceEvent(this_step.chosen, this_step.coalchosen);
+        }
+#ifdef DEBUG
+        debugEndStep();
+#endif // DEBUG
+        if(uses_temporal_sampling && endactive == 1
+           && this_step.time_reference < reference_times.size()
+           && reference_times[this_step.time_reference] > generation)
+        {
+            // As in runSingleLoop(), speciate the remaining lineage and add lineages at the next reference time.
+            updateLineageBranch(endactive, false, false);
+            (*data)[active[endactive].getReference()].setSpec(0.0);
+            speciation(endactive);
+            generation = reference_times[this_step.time_reference] + 0.000000000001;
+            checkTimeUpdate();
+            lineage_intensity_start.assign(active.size(), null_step_intensity);
+            if(endactive < 2)
+            {
+                this_step.bContinueSim = false;
+            }
+        }
+    }
+
+    void Tree::updateLineageBranch(const unsigned long &chosen, const bool &stepped, const bool &speciated)
+    {
+        auto tree_node = (*data)[active[chosen].getReference()];
+        const unsigned long null_steps = NR->randomPoisson(null_step_intensity - lineage_intensity_start[chosen]);
+        const unsigned long generations = tree_node.getGenerationRate() + null_steps + (stepped ? 1 : 0);
+        tree_node.setGenerationRate(generations);
+        lineage_intensity_start[chosen] = null_step_intensity;
+        // The speciation random number is only compared against the number of generations once the branch ends,
+        // so can be drawn from its distribution given whether the branch speciated on its last step.
+        const long double speciation_rate = 0.99999 * spec;
+        if(speciated)
+        {
+            const long double survival = pow(1.0 - speciation_rate, static_cast<long double>(generations - 1));
+            tree_node.setSpec(1.0 - survival * (1.0 - speciation_rate * (1.0 - NR->d01())));
+        }
+        else
+        {
+            const long double survival = pow(1.0 - speciation_rate, static_cast<long double>(generations));
+            tree_node.setSpec(1.0 - survival * NR->d01());
+        }
+    }
+
+    void Tree::updateAllLineageBranches()
+    {
+        for(unsigned long i = 1; i <= endactive; i++)
+        {
+            updateLineageBranch(i, false, false);
+        }
     }
 
 #ifdef DEBUG
@@ -1601,14 +2125,7 @@ namespace necsim
         {
             std::stringstream ss;
             DataPoint tmp_datapoint = active[i];
-            if(tmp_datapoint.getXwrap() == 0 && tmp_datapoint.getYwrap() == 0)
-            {
-                if(tmp_datapoint.getNwrap() != 0)
-                {
-                    fail = true;
-                }
-            }
-            else
+            if(!tmp_datapoint.isOnGrid())
             {
                 fail = true;
             }
@@ -18,6 +18,7 @@
 
 #include <sqlite3.h>
 #include <string>
+#include <future>
 
 #ifdef CXX14_SUPPORT
 #include "memory.h"
@@ -27,7 +28,7 @@
 
 #endif
 
-#include "TreeNode.h"
+#include "TreeNodeStore.h"
 #include "Matrix.h"
 #include "SimParameters.h"
 #include "RNGController.h"
@@ -37,6 +38,8 @@
 #include "custom_exceptions.h"
 #include "Step.h"
 #include "SQLiteHandler.h"
+#include "CheckpointFile.h"
+#include "GillespieCalculator.h"
 
 using namespace random_numbers;
 namespace necsim
@@ -49,7 +52,7 @@ namespace necsim
     {
     protected:
         // storing the coalescence tree itself
-        shared_ptr<vector<TreeNode>> data;
+        shared_ptr<TreeNodeStore> data;
         // a reference for the last written point in data.
         unsigned long enddata{};
         // Stores the command line current_metacommunity_parameters and parses the required information.
@@ -124,13 +127,35 @@ namespace necsim
         bool bIsProtracted{};
         // variable for storing the paused sim location if files have been moved during paused/resumed simulations!
         string pause_sim_directory{};
-        // Set to true to use the gillespie method - this is currently only supported for spatial simulations using a
-        // dispersal map and point speciation (i.e. the method is unsupported for non-spatial simulations,
-        // spatial simulations not using a dispersal map and those that use protracted speciation).
+        // The version of the text pause format being resumed from (0 for pauses written before it was versioned).
+        unsigned int pause_version{};
+        // Set to true to use the gillespie method - this is currently only supported for non-spatial simulations and
+        // spatial simulations using a dispersal map, with point speciation (i.e. the method is unsupported for spatial
+        // simulations not using a dispersal map and those that use protracted speciation).
         bool using_gillespie{};
+        // The number of lineages at which to switch to the gillespie algorithm.
+        double gillespie_threshold{};
+        // If true, the switch to the gillespie algorithm is made once it is expected to be faster than the per-step
+        // algorithm, rather than at gillespie_threshold.
+        bool automatic_gillespie{};
+        // The measured speeds of the per-step and gillespie algorithms.
+        GillespieRates gillespie_rates{};
+        // The expected number of steps per lineage which have neither speciated nor coalesced during the non-spatial
+        // gillespie algorithm, summed over the course of the simulation.
+        double null_step_intensity{};
+        // The value of null_step_intensity when the current branch of each active lineage was last updated.
+        vector<double> lineage_intensity_start{};
+        // The wall time and number of steps at the last periodic checkpoint.
+        time_t last_checkpoint_time{};
+        long last_checkpoint_step{};
+        // The slot to write the next periodic checkpoint to. Slots alternate so that the previous checkpoint remains
+        // intact whilst the next is being written.
+        unsigned int checkpoint_slot{};
+        // The background write of the latest periodic checkpoint.
+        std::future<void> pending_checkpoint{};
 
     public:
-        Tree() : data(make_shared<vector<TreeNode >>()), enddata(0), sim_parameters(make_shared<SimParameters>()),
+        Tree() : data(make_shared<TreeNodeStore>()), enddata(0), sim_parameters(make_shared<SimParameters>()),
                  NR(make_shared<RNGController>()), speciation_rates(), seeded(false), seed(-1), task(-1),
                  times_file("null"), reference_times(), uses_temporal_sampling(false), start(0), sim_start(0),
                  sim_end(0), now(0), sim_finish(0), out_finish(0), time_taken(0), active(), endactive(0),
@@ -142,7 +167,10 @@ namespace necsim
 #endif //sql_ram
                  this_step(), sql_output_database("null"), bFullMode(false), bResume(false), bConfig(true),
                  has_paused(false), has_imported_pause(false), bIsProtracted(false), pause_sim_directory("null"),
-                 using_gillespie(false)
+                 pause_version(text_pause_version), using_gillespie(false), gillespie_threshold(0.0),
+                 automatic_gillespie(false), gillespie_rates(), null_step_intensity(0.0),
+                 lineage_intensity_start(), last_checkpoint_time(0), last_checkpoint_step(0), checkpoint_slot(0),
+                 pending_checkpoint()
         {
         }
 
@@ -213,7 +241,17 @@ namespace necsim
                 std::swap(has_imported_pause, other.has_imported_pause);
                 std::swap(bIsProtracted, other.bIsProtracted);
                 std::swap(pause_sim_directory, other.pause_sim_directory);
+                std::swap(pause_version, other.pause_version);
                 std::swap(using_gillespie, other.using_gillespie);
+                std::swap(gillespie_threshold, other.gillespie_threshold);
+                std::swap(automatic_gillespie, other.automatic_gillespie);
+                std::swap(gillespie_rates, other.gillespie_rates);
+                std::swap(null_step_intensity, other.null_step_intensity);
+                std::swap(lineage_intensity_start, other.lineage_intensity_start);
+                std::swap(last_checkpoint_time, other.last_checkpoint_time);
+                std::swap(last_checkpoint_step, other.last_checkpoint_step);
+                std::swap(checkpoint_slot, other.checkpoint_slot);
+                std::swap(pending_checkpoint, other.pending_checkpoint);
             }
         }
 
@@ -460,7 +498,7 @@ namespace necsim
          * The index of the random lineage is stored in this_step, as chosen.
          * Also records the required variables for the step process, like x, y position.
          */
-        void chooseRandomLineage();
+        virtual void chooseRandomLineage();
 
         /**
          * @brief Updates the coalescence variables in the step object.
@@ -710,6 +748,12 @@ namespace necsim
          */
         void sqlCreateSimulationParameters();
 
+        /**
+         * @brief Stores the measured speeds of the per-step and gillespie algorithms in the output database, if the
+         * gillespie algorithm was used.
+         */
+        void sqlCreateAlgorithmRates();
+
         /**
          * @brief Creates a string containing the SQL insertion statement for the simulation parameters.
          * @return string containing the SQL insertion statement
@@ -731,36 +775,171 @@ namespace necsim
          */
         virtual void simPause();
 
+        /**
+         * @brief Checks if the simulation should be paused using the binary checkpoint format.
+         * @return true if the pause format is binary
+         */
+        bool usesBinaryPause() const;
+
+        /**
+         * @brief Gets the path to the pause file within the provided directory.
+         * @param directory the directory containing the Pause folder
+         * @param binary if true, gets the path to the binary checkpoint, otherwise to the text dump
+         * @return the path to the pause file
+         */
+        string getPauseFileName(const string &directory, bool binary) const;
+
+        /**
+         * @brief Gets the path to the periodic checkpoint file within the provided directory.
+         * @param directory the directory containing the Pause folder
+         * @param slot the checkpoint slot (0 or 1)
+         * @return the path to the periodic checkpoint file
+         */
+        string getCheckpointFileName(const string &directory, unsigned int slot) const;
+
+        /**
+         * @brief Finds the binary checkpoint in the provided directory to resume the simulation from.
+         *
+         * The newest valid file out of the binary pause file and the periodic checkpoints is used, provided it is at
+         * least as recent as any text dump.
+         * @param directory the directory containing the Pause folder
+         * @return the path to the checkpoint, or an empty string if the text dump should be used instead
+         */
+        string findResumeCheckpoint(const string &directory) const;
+
+        /**
+         * @brief Writes a periodic checkpoint if the configured number of steps or wall time has passed since the last.
+         */
+        void checkPeriodicCheckpoint()
+        {
+            if(isPeriodicCheckpointDue())
+            {
+                writePeriodicCheckpoint();
+            }
+        }
+
+        /**
+         * @brief Checks if the configured number of steps or wall time has passed since the last periodic checkpoint.
+         * @return true if a periodic checkpoint should be written
+         */
+        bool isPeriodicCheckpointDue() const
+        {
+            return (sim_parameters->checkpoint_steps > 0 &&
+                    static_cast<unsigned long>(steps - last_checkpoint_step) >= sim_parameters->checkpoint_steps) ||
+                   (sim_parameters->checkpoint_interval > 0 &&
+                    difftime(sim_end, last_checkpoint_time) >= sim_parameters->checkpoint_interval);
+        }
+
+        /**
+         * @brief Captures the simulation state in memory and writes it to the next checkpoint slot on a background
+         * thread.
+         *
+         * Only the active lineages and their nodes are copied, so the time taken does not grow with the size of the
+         * coalescence tree. The remaining nodes are read by the background thread, so the tree must not be resized
+         * until the checkpoint has been written. If the previous checkpoint is still being written, the checkpoint is
+         * deferred until the next check.
+         */
+        void writePeriodicCheckpoint();
+
+        /**
+         * @brief Waits for any periodic checkpoint that is being written to complete.
+         *
+         * Failure to write a periodic checkpoint is not fatal to the simulation, so is only reported as a warning.
+         */
+        void waitForPeriodicCheckpoint();
+
+        /**
+         * @brief Removes the periodic checkpoint files, once the simulation has completed.
+         */
+        void removePeriodicCheckpoints();
+
+        /**
+         * @brief Creates the pause folder if it does not exist.
+         * @return the path to the folder to write pause files to
+         */
+        string createPauseFolder();
+
         /**
          * @brief Checks the output folder exists and initiates the pause.
          * @return the output file stream to save objects to
          */
         shared_ptr<std::ofstream> initiatePause();
 
+        /**
+         * @brief Checks the output folder exists and initiates the pause using the binary checkpoint format.
+         * @return the checkpoint writer to save objects to
+         */
+        shared_ptr<CheckpointWriter> initiateBinaryPause();
+
         /**
          * @brief Saves the main simulation variables to file.
          * @param out the output file stream to save the object to
          */
         void dumpMain(shared_ptr<std::ofstream> out);
 
+        /**
+         * @brief Saves the main simulation variables to the output stream.
+         * @param out the output stream to save the object to
+         */
+        void dumpMain(std::ostream &out);
+
+        /**
+         * @brief Saves the main simulation variables to the checkpoint.
+         * @param out the checkpoint sink to save the object to
+         */
+        void dumpMain(CheckpointSink &out);
+
         /**
          * @brief Saves the active object to file.
          * @param out the output file stream to save the object to
          */
         void dumpActive(shared_ptr<std::ofstream> out);
 
+        /**
+         * @brief Saves the active object to the checkpoint.
+         * @param out the checkpoint sink to save the object to
+         */
+        void dumpActive(CheckpointSink &out);
+
         /**
          * @brief Saves the data object to file.
          * @param out the output file stream to save the object to
          */
         void dumpData(shared_ptr<std::ofstream> out);
 
+        /**
+         * @brief Saves the data object to the checkpoint.
+         *
+         * The nodes of active lineages are copied immediately, but the other nodes are read when the section is
+         * written, as they are not changed by the simulation.
+         *
+         * @param out the checkpoint sink to save the object to
+         */
+        void dumpData(CheckpointSink &out);
+
+        /**
+         * @brief Saves all simulation objects to the checkpoint.
+         * @param out the checkpoint sink to save the objects to
+         */
+        virtual void dumpCheckpoint(CheckpointSink &out);
+
         /**
          * @brief Completes the pause routine and outputs the sql dump.
          * @param out the output stream to close up
          */
         void completePause(shared_ptr<std::ofstream> out);
 
+        /**
+         * @brief Completes the pause routine and outputs the sql dump.
+         * @param out the checkpoint writer to close up
+         */
+        void completePause(shared_ptr<CheckpointWriter> out);
+
+        /**
+         * @brief Outputs the sql dump and timing information after the pause files have been written.
+         */
+        void completePause();
+
         /**
          * @brief Sets the resume variables so that the simulation can be resumed.
          *
@@ -788,18 +967,38 @@ namespace necsim
         /**
          * @brief Loads the main simulation parameters from the save file into memory.
          */
-        virtual void loadMainSave(shared_ptr<std::ifstream> in1);
+        void loadMainSave(shared_ptr<std::ifstream> in1);
+
+        /**
+         * @brief Loads the main simulation parameters from the input stream into memory.
+         */
+        virtual void loadMainSave(std::istream &in1);
+
+        /**
+         * @brief Loads the main simulation parameters from the checkpoint into memory.
+         */
+        void loadMainSave(const CheckpointReader &in1);
 
         /**
          * @brief Loads the data object from the save file into memory.
          */
         void loadDataSave(shared_ptr<std::ifstream> in1);
 
+        /**
+         * @brief Loads the data object from the checkpoint into memory.
+         */
+        void loadDataSave(const CheckpointReader &in1);
+
         /**
          * @brief Loads the active object from the save file into memory.
          */
         void loadActiveSave(shared_ptr<std::ifstream> in1);
 
+        /**
+         * @brief Loads the active object from the checkpoint into memory.
+         */
+        void loadActiveSave(const CheckpointReader &in1);
+
         /**
          * @brief Checks for resuming and prints to the terminal
          */
@@ -812,10 +1011,64 @@ namespace necsim
          */
         virtual void simResume();
 
+        /**
+         * @brief Sets the simulation to use the gillespie algorithm.
+         *
+         * For non-spatial simulations the exact event-driven algorithm is used from the start of the simulation, so
+         * the threshold is ignored. Protracted speciation is not supported.
+         * @param g_threshold the number of lineages at which to switch to the gillespie algorithm
+         */
         virtual void addGillespie(const double &g_threshold);
 
+        /**
+         * @brief Sets the simulation to switch to the gillespie algorithm once it is expected to be faster than the
+         * per-step algorithm.
+         *
+         * The speed of the per-step algorithm and the proportion of its steps which would be gillespie events are
+         * measured as the simulation runs, and the extra cost of a gillespie event is timed on a scratch event heap.
+         * The switch is made once the estimated gillespie event rate exceeds the rate of per-step events. The measured
+         * and estimated speeds are stored in the output database. Non-spatial simulations use the gillespie algorithm
+         * from the start, and store only the measured event rate.
+         */
+        virtual void addAutomaticGillespie();
+
+        /**
+         * @brief Runs the non-spatial simulation by jumping directly between speciation and coalescence events.
+         *
+         * Each lineage is chosen to die at rate 0.5 per generation (matching the generation increment of 2/n per step
+         * in runSingleLoop()), so the time to the next speciation or coalescence event is exponentially distributed.
+         * The steps on which a lineage neither speciates nor coalesces are not simulated individually; instead the
+         * number of such steps on each branch is drawn from a Poisson distribution once the branch ends, and the
+         * random number for speciation of the branch is drawn conditional on the outcome of the branch.
+         * @return true if the simulation has completed
+         */
         virtual bool runSimulationGillespie();
 
+        /**
+         * @brief Sets up the objects for the non-spatial gillespie algorithm.
+         */
+        void setupNonSpatialGillespie();
+
+        /**
+         * @brief Performs a single speciation or coalescence event in the non-spatial gillespie algorithm.
+         */
+        void runNonSpatialGillespieEvent();
+
+        /**
+         * @brief Adds the steps since the last update to the current branch of the lineage, and draws its speciation
+         * random number given whether it speciated.
+         * @param chosen the index of the lineage in active
+         * @param stepped if true, the lineage was chosen for the current event
+         * @param speciated if true, the lineage speciated on the current event
+         */
+        void updateLineageBranch(const unsigned long &chosen, const bool &stepped, const bool &speciated);
+
+        /**
+         * @brief Updates the branches of all active lineages, so that active and data can be used outside the
+         * non-spatial gillespie algorithm.
+         */
+        void updateAllLineageBranches();
+
 #ifdef DEBUG
 
         /**
@@ -70,6 +70,12 @@ namespace necsim
 
         }
 
+        /**
+         * @brief The default copy constructor.
+         * @param t the TreeNode to copy
+         */
+        TreeNode(const TreeNode &t) = default;
+
         /**
          * @brief The default destructor.
          */
@@ -0,0 +1,131 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file TreeNodeStore.cpp
+ * @brief Contains the TreeNodeStore class for storing the coalescence tree in a columnar layout.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <algorithm>
+#include "TreeNodeStore.h"
+#include "custom_exceptions.h"
+
+namespace necsim
+{
+    void TreeNodeStore::resize(unsigned long size_in)
+    {
+        parent.resize(size_in, 0);
+        flags.resize(size_in, 0);
+        species_id.resize(size_in, 0);
+        xpos.resize(size_in, 0);
+        ypos.resize(size_in, 0);
+        xwrap.resize(size_in, 0);
+        ywrap.resize(size_in, 0);
+        speciation_probability.resize(size_in, 0.0);
+        generations_existed.resize(size_in, 0);
+        generation_added.resize(size_in, 0.0);
+    }
+
+    void TreeNodeStore::reserve(unsigned long size_in)
+    {
+        parent.reserve(size_in);
+        flags.reserve(size_in);
+        species_id.reserve(size_in);
+        xpos.reserve(size_in);
+        ypos.reserve(size_in);
+        xwrap.reserve(size_in);
+        ywrap.reserve(size_in);
+        speciation_probability.reserve(size_in);
+        generations_existed.reserve(size_in);
+        generation_added.reserve(size_in);
+    }
+
+    void TreeNodeStore::clear()
+    {
+        parent.clear();
+        flags.clear();
+        species_id.clear();
+        xpos.clear();
+        ypos.clear();
+        xwrap.clear();
+        ywrap.clear();
+        speciation_probability.clear();
+        generations_existed.clear();
+        generation_added.clear();
+    }
+
+    void TreeNodeStore::push_back(const TreeNode &node)
+    {
+        resize(size() + 1);
+        (*this)[size() - 1] = node;
+    }
+
+    void TreeNodeStore::qReset()
+    {
+        std::fill(species_id.begin(), species_id.end(), 0);
+        for(auto &flag : flags)
+        {
+            flag &= tip_flag;
+        }
+    }
+
+    TreeNodeStore::Labels TreeNodeStore::getResetLabels() const
+    {
+        Labels labels;
+        labels.flags.resize(flags.size());
+        std::transform(flags.begin(), flags.end(), labels.flags.begin(), [](const uint8_t &flag)
+        {
+            return static_cast<uint8_t>(flag & tip_flag);
+        });
+        labels.species_id.resize(species_id.size(), 0);
+        return labels;
+    }
+
+    TreeNodeStore::Labels TreeNodeStore::getLabels() const
+    {
+        Labels labels;
+        labels.flags = flags;
+        labels.species_id = species_id;
+        return labels;
+    }
+
+    void TreeNodeStore::swapLabels(Labels &labels)
+    {
+        if(labels.size() != size() || labels.species_id.size() != size())
+        {
+            throw FatalException("Labels do not match the size of the coalescence tree. Please report this bug.");
+        }
+        flags.swap(labels.flags);
+        species_id.swap(labels.species_id);
+    }
+
+    std::ostream &operator<<(std::ostream &os, const TreeNodeStore &t)
+    {
+        os << t.size() << ",";
+        for(unsigned long i = 0; i < t.size(); i++)
+        {
+            os << static_cast<TreeNode>(t[i]) << ",";
+        }
+        return os;
+    }
+
+    std::istream &operator>>(std::istream &is, TreeNodeStore &t)
+    {
+        char delim;
+        unsigned long n;
+        is >> n;
+        t.clear();
+        t.resize(n);
+        is >> delim;
+        TreeNode node;
+        for(unsigned long i = 0; i < n; i++)
+        {
+            is >> node;
+            t[i] = node;
+            is >> delim;
+        }
+        return is;
+    }
+}
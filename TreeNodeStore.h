@@ -0,0 +1,507 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file TreeNodeStore.h
+ * @brief Contains the TreeNodeStore class for storing the coalescence tree in a columnar layout.
+ *
+ * Each of the TreeNode variables is held in a separate contiguous array, so that passes over the coalescence tree which
+ * only read a few variables (such as the parent, flags and species id) touch far less memory than they would for an
+ * array of TreeNode objects. Indexing the store returns a lightweight reference with the same interface as TreeNode,
+ * so that existing code can continue to use (*data)[i].getParent() and similar.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef TREENODESTORE_H
+#define TREENODESTORE_H
+
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include "TreeNode.h"
+#include "Logging.h"
+
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief Stores the nodes of the coalescence tree as a structure of arrays.
+     */
+    class TreeNodeStore
+    {
+    protected:
+        // Bit flags stored for each node
+        static constexpr uint8_t tip_flag = 1;
+        static constexpr uint8_t speciated_flag = 2;
+        static constexpr uint8_t exists_flag = 4;
+
+        // The parent of each node (0 means no parent).
+        vector<unsigned long> parent;
+        // The tip, speciated and existence flags for each node.
+        vector<uint8_t> flags;
+        // The species identity of each node.
+        vector<unsigned long> species_id;
+        // The position of each lineage in the present day.
+        vector<unsigned long> xpos, ypos;
+        vector<long> xwrap, ywrap;
+        // The random number for speciation for each node.
+        vector<long double> speciation_probability;
+        // The number of generations each lineage has existed for.
+        vector<unsigned long> generations_existed;
+        // The generation each lineage was added at.
+        vector<long double> generation_added;
+
+    public:
+        /**
+         * @brief A reference to a single node in the store, providing the same interface as TreeNode.
+         *
+         * References are cheap to copy and should be passed by value. Assigning to a reference copies the values of the
+         * node, as for a C++ reference.
+         * @tparam Store either TreeNodeStore or const TreeNodeStore
+         */
+        template<class Store> class BasicReference
+        {
+        private:
+            Store* store;
+            unsigned long index;
+
+            void setFlag(uint8_t flag, bool b)
+            {
+                if(b)
+                {
+                    store->flags[index] |= flag;
+                }
+                else
+                {
+                    store->flags[index] &= static_cast<uint8_t>(~flag);
+                }
+            }
+
+            bool getFlag(uint8_t flag) const
+            {
+                return (store->flags[index] & flag) != 0;
+            }
+
+        public:
+            BasicReference(Store* store_in, unsigned long index_in) : store(store_in), index(index_in)
+            {
+            }
+
+            BasicReference(const BasicReference &other) = default;
+
+            /**
+             * @brief Allows conversion from a reference to a reference to const.
+             * @param other the reference to copy
+             */
+            template<class OtherStore, class = typename std::enable_if<std::is_const<Store>::value
+                                                                        && !std::is_const<OtherStore>::value>::type>
+            BasicReference(const BasicReference<OtherStore> &other) : store(other.getStore()), index(other.getIndex())
+            {
+            }
+
+            /**
+             * @brief Copies the values of the other node into this node.
+             * @param other the node to copy from
+             * @return this reference
+             */
+            BasicReference &operator=(const BasicReference &other)
+            {
+                return *this = static_cast<TreeNode>(other);
+            }
+
+            /**
+             * @brief Copies the values of the TreeNode into this node.
+             * @param node the node to copy from
+             * @return this reference
+             */
+            BasicReference &operator=(const TreeNode &node)
+            {
+                store->parent[index] = node.getParent();
+                store->flags[index] = 0;
+                setFlag(tip_flag, node.isTip());
+                setFlag(speciated_flag, node.hasSpeciated());
+                setFlag(exists_flag, node.exists());
+                store->species_id[index] = node.getSpeciesID();
+                store->xpos[index] = node.getXpos();
+                store->ypos[index] = node.getYpos();
+                store->xwrap[index] = node.getXwrap();
+                store->ywrap[index] = node.getYwrap();
+                store->speciation_probability[index] = node.getSpecRate();
+                store->generations_existed[index] = node.getGenerationRate();
+                store->generation_added[index] = node.getGeneration();
+                return *this;
+            }
+
+            /**
+             * @brief Creates a TreeNode with a copy of the values of this node.
+             * @return the TreeNode
+             */
+            operator TreeNode() const
+            {
+                TreeNode node;
+                node.setup(isTip(), getXpos(), getYpos(), getXwrap(), getYwrap(), getGeneration());
+                node.setParent(getParent());
+                node.setSpeciation(hasSpeciated());
+                node.setExistence(exists());
+                node.burnSpecies(getSpeciesID());
+                node.setSpec(getSpecRate());
+                node.setGenerationRate(getGenerationRate());
+                return node;
+            }
+
+            Store* getStore() const
+            {
+                return store;
+            }
+
+            unsigned long getIndex() const
+            {
+                return index;
+            }
+
+            void setup(bool z, unsigned long xp, unsigned long yp, long xi, long yi)
+            {
+                setup(z, static_cast<long>(xp), static_cast<long>(yp), xi, yi, 0.0);
+            }
+
+            void setup(bool z)
+            {
+                setup(z, 0, 0, 0, 0);
+            }
+
+            void setup(const bool &is_tip, const long &xp, const long &yp, const long &xi, const long &yi,
+                       const long double &generation)
+            {
+                // Existence is deliberately left unchanged, as for TreeNode
+                setFlag(tip_flag, is_tip);
+                setFlag(speciated_flag, false);
+                store->parent[index] = 0;
+                store->species_id[index] = 0;
+                store->xpos[index] = static_cast<unsigned long>(xp);
+                store->ypos[index] = static_cast<unsigned long>(yp);
+                store->xwrap[index] = xi;
+                store->ywrap[index] = yi;
+                store->speciation_probability[index] = 0;
+                store->generations_existed[index] = 0;
+                store->generation_added[index] = generation;
+            }
+
+            void setExistence(bool b)
+            {
+                setFlag(exists_flag, b);
+            }
+
+            void setParent(unsigned long x)
+            {
+                store->parent[index] = x;
+            }
+
+            void qReset()
+            {
+                store->species_id[index] = 0;
+                store->flags[index] &= tip_flag;
+            }
+
+            void setPosition(long x, long y, long xw, long yw)
+            {
+                store->xpos[index] = static_cast<unsigned long>(x);
+                store->ypos[index] = static_cast<unsigned long>(y);
+                store->xwrap[index] = xw;
+                store->ywrap[index] = yw;
+            }
+
+            void setSpec(long double d)
+            {
+                store->speciation_probability[index] = d;
+            }
+
+            void setGenerationRate(unsigned long g)
+            {
+                store->generations_existed[index] = g;
+            }
+
+            void setGeneration(long double d)
+            {
+                store->generation_added[index] = d;
+            }
+
+            void setSpeciation(bool s)
+            {
+                setFlag(speciated_flag, s);
+            }
+
+            void burnSpecies(unsigned long idin)
+            {
+                if(store->species_id[index] == 0)
+                {
+                    store->species_id[index] = idin;
+                }
+            }
+
+            void setTip(bool b)
+            {
+                setFlag(tip_flag, b);
+            }
+
+            void resetSpecies()
+            {
+                store->species_id[index] = 0;
+            }
+
+            void increaseGen()
+            {
+                store->generations_existed[index]++;
+            }
+
+            void speciate()
+            {
+                setFlag(speciated_flag, true);
+            }
+
+            bool exists() const
+            {
+                return getFlag(exists_flag);
+            }
+
+            bool isTip() const
+            {
+                return getFlag(tip_flag);
+            }
+
+            bool hasSpeciated() const
+            {
+                return getFlag(speciated_flag);
+            }
+
+            unsigned long getParent() const
+            {
+                return store->parent[index];
+            }
+
+            unsigned long getXpos() const
+            {
+                return store->xpos[index];
+            }
+
+            unsigned long getYpos() const
+            {
+                return store->ypos[index];
+            }
+
+            long getXwrap() const
+            {
+                return store->xwrap[index];
+            }
+
+            long getYwrap() const
+            {
+                return store->ywrap[index];
+            }
+
+            unsigned long getSpeciesID() const
+            {
+                return store->species_id[index];
+            }
+
+            long double getSpecRate() const
+            {
+                return store->speciation_probability[index];
+            }
+
+            unsigned long getGenerationRate() const
+            {
+                return store->generations_existed[index];
+            }
+
+            long double getGeneration() const
+            {
+                return store->generation_added[index];
+            }
+
+#ifdef DEBUG
+
+            void logLineageInformation(const int &level) const
+            {
+                static_cast<TreeNode>(*this).logLineageInformation(level);
+            }
+
+#endif // DEBUG
+        };
+
+        /**
+         * @brief The existence, speciation and species ID of every node.
+         *
+         * These are the only values which change when applying a new set of speciation parameters to the coalescence
+         * tree, so labels can be calculated separately from the store (for example, on a worker thread) and then
+         * swapped in.
+         */
+        class Labels
+        {
+            friend class TreeNodeStore;
+
+        private:
+            vector<uint8_t> flags;
+            vector<unsigned long> species_id;
+
+        public:
+            unsigned long size() const
+            {
+                return flags.size();
+            }
+
+            bool isTip(unsigned long index) const
+            {
+                return (flags[index] & tip_flag) != 0;
+            }
+
+            bool exists(unsigned long index) const
+            {
+                return (flags[index] & exists_flag) != 0;
+            }
+
+            void setExistence(unsigned long index)
+            {
+                flags[index] |= exists_flag;
+            }
+
+            bool hasSpeciated(unsigned long index) const
+            {
+                return (flags[index] & speciated_flag) != 0;
+            }
+
+            void speciate(unsigned long index)
+            {
+                flags[index] |= speciated_flag;
+            }
+
+            unsigned long getSpeciesID(unsigned long index) const
+            {
+                return species_id[index];
+            }
+
+            void setSpeciesID(unsigned long index, unsigned long id)
+            {
+                species_id[index] = id;
+            }
+
+            bool operator==(const Labels &other) const
+            {
+                return flags == other.flags && species_id == other.species_id;
+            }
+
+            bool operator!=(const Labels &other) const
+            {
+                return !(*this == other);
+            }
+        };
+
+        using reference = BasicReference<TreeNodeStore>;
+        using const_reference = BasicReference<const TreeNodeStore>;
+
+        TreeNodeStore() = default;
+
+        explicit TreeNodeStore(unsigned long size_in)
+        {
+            resize(size_in);
+        }
+
+        reference operator[](unsigned long index)
+        {
+            return reference(this, index);
+        }
+
+        const_reference operator[](unsigned long index) const
+        {
+            return const_reference(this, index);
+        }
+
+        /**
+         * @brief Gets the number of nodes in the store.
+         * @return the number of nodes
+         */
+        unsigned long size() const
+        {
+            return parent.size();
+        }
+
+        /**
+         * @brief Checks if the store contains no nodes.
+         * @return true if there are no nodes
+         */
+        bool empty() const
+        {
+            return parent.empty();
+        }
+
+        /**
+         * @brief Resizes each of the arrays, with any new nodes default-initialised.
+         * @param size_in the new number of nodes
+         */
+        void resize(unsigned long size_in);
+
+        /**
+         * @brief Reserves space in each of the arrays.
+         * @param size_in the number of nodes to reserve space for
+         */
+        void reserve(unsigned long size_in);
+
+        /**
+         * @brief Removes all nodes from the store.
+         */
+        void clear();
+
+        /**
+         * @brief Adds a node to the end of the store.
+         * @param node the node to add
+         */
+        void push_back(const TreeNode &node);
+
+        /**
+         * @brief Resets the species id, existence and speciation of every node, ready for a new set of calculations.
+         *
+         * Equivalent to calling qReset() on each node.
+         */
+        void qReset();
+
+        /**
+         * @brief Gets a copy of the labels of every node, as they would be after a call to qReset().
+         * @return the reset labels
+         */
+        Labels getResetLabels() const;
+
+        /**
+         * @brief Gets a copy of the current labels of every node.
+         * @return the labels
+         */
+        Labels getLabels() const;
+
+        /**
+         * @brief Swaps the labels of every node with the provided labels, which must be the same size as the store.
+         * @param labels the labels to swap in
+         */
+        void swapLabels(Labels &labels);
+
+        /**
+         * @brief Writes the store to the output stream, in the same format as a vector of TreeNode objects.
+         * @param os the output stream
+         * @param t the store to write out
+         * @return the output stream
+         */
+        friend std::ostream &operator<<(std::ostream &os, const TreeNodeStore &t);
+
+        /**
+         * @brief Reads the store from the input stream, in the same format as a vector of TreeNode objects.
+         * @param is the input stream
+         * @param t the store to read into
+         * @return the input stream
+         */
+        friend std::istream &operator>>(std::istream &is, TreeNodeStore &t);
+    };
+
+    using TreeNodeReference = TreeNodeStore::reference;
+    using ConstTreeNodeReference = TreeNodeStore::const_reference;
+}
+#endif // TREENODESTORE_H
@@ -0,0 +1,154 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file WrappedLineages.cpp
+ * @brief Contains the WrappedLineages class for looking up the lineages at locations outside the simulated grid.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#include <sstream>
+#include "WrappedLineages.h"
+#include "custom_exceptions.h"
+
+namespace necsim
+{
+    WrappedLineages::WrappedLineages() : location_lists(), lists(), free_lists(), total(0)
+    {
+
+    }
+
+    vector<unsigned long> &WrappedLineages::getList(const MapLocation &location)
+    {
+        const auto found = location_lists.find(location);
+        if(found == location_lists.end())
+        {
+            std::stringstream ss;
+            ss << "No wrapped lineages at " << location.x << ", " << location.y << " (" << location.xwrap << ", "
+               << location.ywrap << "). Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+        return lists[found->second];
+    }
+
+    void WrappedLineages::clear()
+    {
+        location_lists.clear();
+        free_lists.clear();
+        for(unsigned long i = 0; i < lists.size(); i++)
+        {
+            lists[i].clear();
+            free_lists.push_back(i);
+        }
+        total = 0;
+    }
+
+    unsigned long WrappedLineages::size() const
+    {
+        return total;
+    }
+
+    unsigned long WrappedLineages::count(const MapLocation &location) const
+    {
+        const auto found = location_lists.find(location);
+        if(found == location_lists.end())
+        {
+            return 0;
+        }
+        return lists[found->second].size();
+    }
+
+    unsigned long WrappedLineages::get(const MapLocation &location, const unsigned long &position) const
+    {
+        const auto found = location_lists.find(location);
+#ifdef DEBUG
+        if(found == location_lists.end() || position >= lists[found->second].size())
+        {
+            std::stringstream ss;
+            ss << "No wrapped lineage at position " << position << " of " << location.x << ", " << location.y << " ("
+               << location.xwrap << ", " << location.ywrap << "). Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+#endif // DEBUG
+        return lists[found->second][position];
+    }
+
+    vector<unsigned long> WrappedLineages::getLineages(const MapLocation &location) const
+    {
+        const auto found = location_lists.find(location);
+        if(found == location_lists.end())
+        {
+            return vector<unsigned long>();
+        }
+        return lists[found->second];
+    }
+
+    unsigned long WrappedLineages::add(const MapLocation &location, const unsigned long &lineage)
+    {
+        auto found = location_lists.find(location);
+        if(found == location_lists.end())
+        {
+            unsigned long list_index;
+            if(free_lists.empty())
+            {
+                list_index = lists.size();
+                lists.emplace_back();
+            }
+            else
+            {
+                list_index = free_lists.back();
+                free_lists.pop_back();
+            }
+            found = location_lists.emplace(MapLocation(location.x, location.y, location.xwrap, location.ywrap),
+                                           list_index).first;
+        }
+        vector<unsigned long> &list = lists[found->second];
+        list.push_back(lineage);
+        total++;
+        return list.size() - 1;
+    }
+
+    unsigned long WrappedLineages::remove(const MapLocation &location, const unsigned long &position)
+    {
+        const auto found = location_lists.find(location);
+        if(found == location_lists.end() || position >= lists[found->second].size())
+        {
+            std::stringstream ss;
+            ss << "Cannot remove wrapped lineage at position " << position << " of " << location.x << ", "
+               << location.y << " (" << location.xwrap << ", " << location.ywrap << "). Please report this bug."
+               << std::endl;
+            throw FatalException(ss.str());
+        }
+        vector<unsigned long> &list = lists[found->second];
+        unsigned long moved = 0;
+        if(position != list.size() - 1)
+        {
+            moved = list.back();
+            list[position] = moved;
+        }
+        list.pop_back();
+        total--;
+        if(list.empty())
+        {
+            free_lists.push_back(found->second);
+            location_lists.erase(found);
+        }
+        return moved;
+    }
+
+    void WrappedLineages::set(const MapLocation &location, const unsigned long &position, const unsigned long &lineage)
+    {
+        vector<unsigned long> &list = getList(location);
+#ifdef DEBUG
+        if(position >= list.size())
+        {
+            std::stringstream ss;
+            ss << "Cannot set wrapped lineage at position " << position << " in list of size " << list.size()
+               << ". Please report this bug." << std::endl;
+            throw FatalException(ss.str());
+        }
+#endif // DEBUG
+        list[position] = lineage;
+    }
+}
@@ -0,0 +1,111 @@
+// This file is part of necsim project which is released under MIT license.
+// See file **LICENSE.txt** or visit https://opensource.org/licenses/MIT) for full license details.
+
+/**
+ * @file WrappedLineages.h
+ * @brief Contains the WrappedLineages class for looking up the lineages at locations outside the simulated grid.
+ *
+ * @copyright <a href="https://opensource.org/licenses/MIT"> MIT Licence.</a>
+ */
+
+#ifndef NECSIM_WRAPPEDLINEAGES_H
+#define NECSIM_WRAPPEDLINEAGES_H
+
+#include <unordered_map>
+#include <vector>
+#include "MapLocation.h"
+
+using std::vector;
+namespace necsim
+{
+    /**
+     * @brief Stores the active lineages at each off-grid (wrapped) location, indexed by the full location.
+     *
+     * Each location holds a contiguous list of lineages, so that counting, adding, removing and choosing the lineages
+     * at a location all take constant time. Removing a lineage moves the last lineage in the list into its position.
+     * Lists which are emptied are kept for re-use by other locations, so that lineages moving between locations do not
+     * require new storage.
+     */
+    class WrappedLineages
+    {
+    protected:
+        // The index of the list of lineages for each location with at least one lineage.
+        std::unordered_map<MapLocation, unsigned long, MapLocationHash> location_lists;
+        // The lineages at each location.
+        vector<vector<unsigned long>> lists;
+        // Lists which are not currently assigned to a location.
+        vector<unsigned long> free_lists;
+        // The total number of lineages stored.
+        unsigned long total;
+
+        /**
+         * @brief Gets the lineages at the location, which must contain at least one lineage.
+         * @param location the location to get the lineages at
+         * @return the lineages at the location
+         */
+        vector<unsigned long> &getList(const MapLocation &location);
+
+    public:
+        WrappedLineages();
+
+        /**
+         * @brief Removes all lineages.
+         */
+        void clear();
+
+        /**
+         * @brief Gets the total number of lineages at all locations.
+         * @return the number of lineages
+         */
+        unsigned long size() const;
+
+        /**
+         * @brief Counts the lineages at the location.
+         * @param location the location to count lineages at
+         * @return the number of lineages at the location
+         */
+        unsigned long count(const MapLocation &location) const;
+
+        /**
+         * @brief Gets the lineage at the position in the list of lineages at the location.
+         * @param location the location to get the lineage at
+         * @param position the position in the list, which must be less than the number of lineages at the location
+         * @return the index of the lineage in active
+         */
+        unsigned long get(const MapLocation &location, const unsigned long &position) const;
+
+        /**
+         * @brief Gets the lineages at the location.
+         * @param location the location to get the lineages at
+         * @return the indices of the lineages in active, which is empty if there are no lineages at the location
+         */
+        vector<unsigned long> getLineages(const MapLocation &location) const;
+
+        /**
+         * @brief Adds the lineage to the end of the list at the location.
+         * @param location the location to add the lineage at
+         * @param lineage the index of the lineage in active
+         * @return the position of the lineage in the list
+         */
+        unsigned long add(const MapLocation &location, const unsigned long &lineage);
+
+        /**
+         * @brief Removes the lineage at the position in the list at the location.
+         *
+         * The last lineage in the list is moved into the position.
+         * @param location the location to remove the lineage from
+         * @param position the position of the lineage in the list
+         * @return the index of the lineage which was moved into the position, or 0 if no lineage was moved
+         */
+        unsigned long remove(const MapLocation &location, const unsigned long &position);
+
+        /**
+         * @brief Replaces the lineage at the position in the list at the location.
+         * @param location the location of the lineage
+         * @param position the position of the lineage in the list
+         * @param lineage the new index of the lineage in active
+         */
+        void set(const MapLocation &location, const unsigned long &position, const unsigned long &lineage);
+    };
+}
+#endif //NECSIM_WRAPPEDLINEAGES_H